@@ -20,10 +20,11 @@ namespace mypilot {
 namespace mymath {
 
 // 在二维中实现（无向）轴对齐的边界框。
-class AABox2d {
+template <typename T>
+class AABox2 {
 public:
   // 创建一个轴对齐的盒子，其长度和宽度为零在原点。
-  AABox2d() = default;
+  AABox2() = default;
 
   /*
    * 创建一个轴对齐的盒子，其长度和宽度为零在原点。
@@ -31,14 +32,14 @@ public:
    * center : 中间点坐标
    * length,width : 长(x轴),宽(y轴)
    */
-  AABox2d(const Vec2d& center, const double length, const double width) : 
+  AABox2(const Vec2<T>& center, const T length, const T width) : 
     _center(center),
     _length(length),
     _width(width),
-    _half_length(length / 2.0),
-    _half_width(width / 2.0) {
-    assert(_length > -math_epsilon);
-    assert(_width > -math_epsilon);
+    _half_length(length / 2),
+    _half_width(width / 2) {
+    assert(_length > -math_epsilon_of<T>());
+    assert(_width > -math_epsilon_of<T>());
   }
 
   /*
@@ -47,18 +48,24 @@ public:
    * one_corner : 一个角坐标
    * opposite_corner : 对面的角坐标
    */
-  AABox2d(const Vec2d& one_corner, const Vec2d& opposite_corner) : 
-    AABox2d((one_corner + opposite_corner) / 2.0,
+  AABox2(const Vec2<T>& one_corner, const Vec2<T>& opposite_corner) : 
+    AABox2((one_corner + opposite_corner) / 2,
     std::abs(one_corner.x() - opposite_corner.x()),
     std::abs(one_corner.y() - opposite_corner.y())) {}
 
+  // 不同精度之间的转换
+  template <typename U>
+  explicit AABox2(const AABox2<U>& other) :
+    AABox2(Vec2<T>(other.center()), static_cast<T>(other.length()),
+           static_cast<T>(other.width())) {}
+
   // 创建盒子，使用所有的点坐标,这里的所有点都在这个盒子里。
-  explicit AABox2d(const std::vector<Vec2d>& points)  {
+  explicit AABox2(const std::vector<Vec2<T>>& points)  {
     assert(!points.empty());
-    double min_x = points[0].x();
-    double max_x = points[0].x();
-    double min_y = points[0].y();
-    double max_y = points[0].y();
+    T min_x = points[0].x();
+    T max_x = points[0].x();
+    T min_y = points[0].y();
+    T max_y = points[0].y();
     // 遍历所有点坐标，找出最大最小值
     for (const auto& point : points) {
       min_x = std::min(min_x, point.x());
@@ -67,28 +74,28 @@ public:
       max_y = std::max(max_y, point.y());
     }
 
-    _center = {(min_x + max_x) / 2.0, (min_y + max_y) / 2.0};
+    _center = {(min_x + max_x) / 2, (min_y + max_y) / 2};
     _length = max_x - min_x;
     _width = max_y - min_y;
-    _half_length = _length / 2.0;
-    _half_width = _width / 2.0;
+    _half_length = _length / 2;
+    _half_width = _width / 2;
   }
 
-  const Vec2d& center() const { return _center; }
-  double center_x() const { return _center.x(); }
-  double center_y() const { return _center.y(); }
-  double length() const { return _length; }
-  double width() const { return _width; }
-  double half_length() const { return _half_length; }
-  double half_width() const { return _half_width; }
-  double area() const { return _length * _width; }
-  double min_x() const { return _center.x() - _half_length; }
-  double max_x() const { return _center.x() + _half_length; }
-  double min_y() const { return _center.y() - _half_width; }
-  double max_y() const { return _center.y() + _half_width; }
+  const Vec2<T>& center() const { return _center; }
+  T center_x() const { return _center.x(); }
+  T center_y() const { return _center.y(); }
+  T length() const { return _length; }
+  T width() const { return _width; }
+  T half_length() const { return _half_length; }
+  T half_width() const { return _half_width; }
+  T area() const { return _length * _width; }
+  T min_x() const { return _center.x() - _half_length; }
+  T max_x() const { return _center.x() + _half_length; }
+  T min_y() const { return _center.y() - _half_width; }
+  T max_y() const { return _center.y() + _half_width; }
 
   // 获取所有角坐标
-  void get_all_corners(std::vector<Vec2d>* const corners) const {
+  void get_all_corners(std::vector<Vec2<T>>* const corners) const {
     assert(corners);
     corners->clear();
     corners->reserve(4);
@@ -99,51 +106,51 @@ public:
   }
 
   // 判断给定点坐标是否在盒子里
-  bool is_point_in(const Vec2d& point) const {
-    return std::abs(point.x() - _center.x()) <= _half_length + math_epsilon &&
-      std::abs(point.y() - _center.y()) <= _half_width + math_epsilon;
+  bool is_point_in(const Vec2<T>& point) const {
+    return std::abs(point.x() - _center.x()) <= _half_length + math_epsilon_of<T>() &&
+      std::abs(point.y() - _center.y()) <= _half_width + math_epsilon_of<T>();
   }
 
   // 给定点是否在盒子的边框上
-  bool is_point_on_boundary(const Vec2d& point) const {
-    const double dx = std::abs(point.x() - _center.x());
-    const double dy = std::abs(point.y() - _center.y());
-    return (std::abs(dx - _half_length) <= math_epsilon &&
-        dy <= _half_width + math_epsilon) ||
-      (std::abs(dy - _half_width) <= math_epsilon &&
-        dx <= _half_length + math_epsilon);
+  bool is_point_on_boundary(const Vec2<T>& point) const {
+    const T dx = std::abs(point.x() - _center.x());
+    const T dy = std::abs(point.y() - _center.y());
+    return (std::abs(dx - _half_length) <= math_epsilon_of<T>() &&
+        dy <= _half_width + math_epsilon_of<T>()) ||
+      (std::abs(dy - _half_width) <= math_epsilon_of<T>() &&
+        dx <= _half_length + math_epsilon_of<T>());
   }
 
   // 确定点到盒子的距离
-  double distance_to(const Vec2d& point) const {
-    const double dx = std::abs(point.x() - _center.x()) - _half_length;
-    const double dy = std::abs(point.y() - _center.y()) - _half_width;
-    if (dx <= 0.0) {
-      return std::max(0.0, dy);
+  T distance_to(const Vec2<T>& point) const {
+    const T dx = std::abs(point.x() - _center.x()) - _half_length;
+    const T dy = std::abs(point.y() - _center.y()) - _half_width;
+    if (dx <= 0) {
+      return std::max(T(0), dy);
     }
-    if (dy <= 0.0) {
+    if (dy <= 0) {
       return dx;
     }
-    return hypot(dx, dy);
+    return std::hypot(dx, dy);
   }
 
   // 两个盒子的距离
-  double distance_to(const AABox2d& box) const {
-    const double dx =
+  T distance_to(const AABox2& box) const {
+    const T dx =
       std::abs(box.center_x() - _center.x()) - box.half_length() - _half_length;
-    const double dy =
+    const T dy =
       std::abs(box.center_y() - _center.y()) - box.half_width() - _half_width;
-    if (dx <= 0.0) {
-      return std::max(0.0, dy);
+    if (dx <= 0) {
+      return std::max(T(0), dy);
     }
-    if (dy <= 0.0) {
+    if (dy <= 0) {
       return dx;
     }
-    return hypot(dx, dy);
+    return std::hypot(dx, dy);
   }
 
   // 检查两个盒子是否重叠
-  bool has_overlap(const AABox2d& box) const {
+  bool has_overlap(const AABox2& box) const {
     return std::abs(box.center_x() - _center.x()) <=
         box.half_length() + _half_length &&
       std::abs(box.center_y() - _center.y()) <=
@@ -151,32 +158,32 @@ public:
   }
 
   // 通过给定偏移'shift_vec',移动盒子的中心。
-  void shift(const Vec2d& shift_vec) { _center += shift_vec; }
+  void shift(const Vec2<T>& shift_vec) { _center += shift_vec; }
 
   // 合并两个盒子
-  void merge_from(const AABox2d& other_box) {
-    const double x1 = std::min(min_x(), other_box.min_x());
-    const double x2 = std::max(max_x(), other_box.max_x());
-    const double y1 = std::min(min_y(), other_box.min_y());
-    const double y2 = std::max(max_y(), other_box.max_y());
-    _center = Vec2d((x1 + x2) / 2.0, (y1 + y2) / 2.0);
+  void merge_from(const AABox2& other_box) {
+    const T x1 = std::min(min_x(), other_box.min_x());
+    const T x2 = std::max(max_x(), other_box.max_x());
+    const T y1 = std::min(min_y(), other_box.min_y());
+    const T y2 = std::max(max_y(), other_box.max_y());
+    _center = Vec2<T>((x1 + x2) / 2, (y1 + y2) / 2);
     _length = x2 - x1;
     _width = y2 - y1;
-    _half_length = _length / 2.0;
-    _half_width = _width / 2.0;
+    _half_length = _length / 2;
+    _half_width = _width / 2;
   }
 
   // 强制一个盒子包含一个点,扩大盒子。
-  void merge_from(const Vec2d& other_point) {
-    const double x1 = std::min(min_x(), other_point.x());
-    const double x2 = std::max(max_x(), other_point.x());
-    const double y1 = std::min(min_y(), other_point.y());
-    const double y2 = std::max(max_y(), other_point.y());
-    _center = Vec2d((x1 + x2) / 2.0, (y1 + y2) / 2.0);
+  void merge_from(const Vec2<T>& other_point) {
+    const T x1 = std::min(min_x(), other_point.x());
+    const T x2 = std::max(max_x(), other_point.x());
+    const T y1 = std::min(min_y(), other_point.y());
+    const T y2 = std::max(max_y(), other_point.y());
+    _center = Vec2<T>((x1 + x2) / 2, (y1 + y2) / 2);
     _length = x2 - x1;
     _width = y2 - y1;
-    _half_length = _length / 2.0;
-    _half_width = _width / 2.0;
+    _half_length = _length / 2;
+    _half_width = _width / 2;
   }
 
 #if MYMATH_DBG
@@ -190,13 +197,16 @@ public:
 #endif
 
 private:
-  Vec2d _center;
-  double _length = 0.0;
-  double _width = 0.0;
-  double _half_length = 0.0;
-  double _half_width = 0.0;
+  Vec2<T> _center;
+  T _length = 0;
+  T _width = 0;
+  T _half_length = 0;
+  T _half_width = 0;
 };
 
+using AABox2d = AABox2<double>;
+using AABox2f = AABox2<float>;
+
 }}
 
 #endif
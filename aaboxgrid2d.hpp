@@ -0,0 +1,588 @@
+#ifndef MYMATH_AABOXGRID2D_HPP
+#define MYMATH_AABOXGRID2D_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "math_utils.hpp"
+#include "aabox2d.hpp"
+#include "box2d.hpp"
+#include "line_segment2d.hpp"
+#include "aaboxkdtree2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 默认的哈希桶数量(2的幂)
+static constexpr int kAABoxGridDefaultBuckets = 4096;
+
+/*
+ * 均匀网格(空间哈希)索引
+ *
+ * 平面被切分为边长'cell_size'的正方形网格，对象登记在其轴对齐盒子覆盖的每一个网格中。
+ * 网格坐标通过哈希映射到固定数量的桶。所有登记保存在一个连续的数组中，
+ * 每个桶是其中以索引串联的链表，登记中直接保存对象的盒子，查询时不需要访问对象就能排除大部分候选。
+ * 删除的登记放入空闲链表复用，对象到记录的索引是开放寻址的哈希表，
+ * 对象数量稳定之后插入、删除与更新都不分配内存。
+ *
+ * 插入与删除的代价只与对象覆盖的网格数量有关(期望O(1))，
+ * 适合每一帧都在变化、大小相近的大量障碍物。cell_size应该与对象的尺寸相当。
+ *
+ * 查询接口与AABoxKDTree2d相同。对象需要提供aabox()与distance_square_to(point)，
+ * 并且由调用者持有，插入后直到删除之前都必须有效。
+ */
+template <class ObjectType>
+class AABoxGrid2d {
+public:
+  using ObjectPtr = const ObjectType *;
+
+  explicit AABoxGrid2d(const double cell_size,
+                       const int num_buckets = kAABoxGridDefaultBuckets)
+      : _cell_size(cell_size), _inv_cell_size(1.0 / cell_size) {
+    assert(cell_size > 0.0);
+    int n = 1;
+    while (n < num_buckets) {
+      n <<= 1;
+    }
+    _bucket_heads.assign(n, -1);
+    _bucket_mask = static_cast<uint32_t>(n - 1);
+    _index_slots.resize(16);
+  }
+
+  AABoxGrid2d(const std::vector<ObjectType>& objects, const double cell_size,
+              const int num_buckets = kAABoxGridDefaultBuckets)
+      : AABoxGrid2d(cell_size, num_buckets) {
+    _records.reserve(objects.size());
+    reserve_index(static_cast<int>(objects.size()));
+    for (const auto& object : objects) {
+      insert(&object);
+    }
+  }
+
+  // 插入一个对象，对象已经存在时返回false。
+  bool insert(ObjectPtr object) {
+    assert(object);
+    const int slot = find_index_slot(object);
+    if (_index_slots[slot].object != nullptr) {
+      return false;
+    }
+    const int record_index = static_cast<int>(_records.size());
+    _index_slots[slot] = {object, record_index};
+    ++_index_size;
+    if (2 * _index_size > static_cast<int>(_index_slots.size())) {
+      reserve_index(_index_size);
+    }
+    _records.emplace_back();
+    Record& record = _records.back();
+    record.object = object;
+    const AABox2d& box = object->aabox();
+    record.min_cell_x = cell_coordinate(box.min_x());
+    record.max_cell_x = cell_coordinate(box.max_x());
+    record.min_cell_y = cell_coordinate(box.min_y());
+    record.max_cell_y = cell_coordinate(box.max_y());
+    for (int cx = record.min_cell_x; cx <= record.max_cell_x; ++cx) {
+      for (int cy = record.min_cell_y; cy <= record.max_cell_y; ++cy) {
+        const int index = allocate_entry();
+        CellEntry& entry = _entries[index];
+        entry.min_x = box.min_x();
+        entry.max_x = box.max_x();
+        entry.min_y = box.min_y();
+        entry.max_y = box.max_y();
+        entry.cell_x = cx;
+        entry.cell_y = cy;
+        entry.record = record_index;
+        // 插入到桶链表的头部
+        const int bucket = bucket_index(cx, cy);
+        entry.prev = -1;
+        entry.next = _bucket_heads[bucket];
+        if (entry.next >= 0) {
+          _entries[entry.next].prev = index;
+        }
+        _bucket_heads[bucket] = index;
+        entry.next_in_record = record.first_entry;
+        record.first_entry = index;
+        ++record.num_entries;
+      }
+    }
+    _num_entries += record.num_entries;
+    _min_cell_x = std::min(_min_cell_x, record.min_cell_x);
+    _max_cell_x = std::max(_max_cell_x, record.max_cell_x);
+    _min_cell_y = std::min(_min_cell_y, record.min_cell_y);
+    _max_cell_y = std::max(_max_cell_y, record.max_cell_y);
+    return true;
+  }
+
+  // 删除一个对象，对象不存在时返回false。使用插入时记录的盒子，不要求aabox()不变。
+  bool remove(ObjectPtr object) {
+    const int slot = find_index_slot(object);
+    if (_index_slots[slot].object == nullptr) {
+      return false;
+    }
+    const int record_index = _index_slots[slot].record;
+    erase_index_slot(slot);
+    // 从桶链表中摘除每一个登记，放入空闲链表
+    const Record& record = _records[record_index];
+    for (int index = record.first_entry; index >= 0;) {
+      CellEntry& entry = _entries[index];
+      const int next_in_record = entry.next_in_record;
+      if (entry.prev >= 0) {
+        _entries[entry.prev].next = entry.next;
+      } else {
+        _bucket_heads[bucket_index(entry.cell_x, entry.cell_y)] = entry.next;
+      }
+      if (entry.next >= 0) {
+        _entries[entry.next].prev = entry.prev;
+      }
+      entry.next = _free_entry;
+      _free_entry = index;
+      index = next_in_record;
+    }
+    _num_entries -= record.num_entries;
+    // 交换删除对象记录
+    const int last_index = static_cast<int>(_records.size()) - 1;
+    if (record_index != last_index) {
+      _records[record_index] = _records[last_index];
+      const Record& moved = _records[record_index];
+      for (int index = moved.first_entry; index >= 0;
+           index = _entries[index].next_in_record) {
+        _entries[index].record = record_index;
+      }
+      _index_slots[find_index_slot(moved.object)].record = record_index;
+    }
+    _records.pop_back();
+    return true;
+  }
+
+  // 对象的aabox()变化后更新其所在的网格
+  bool update(ObjectPtr object) {
+    if (!remove(object)) {
+      return false;
+    }
+    return insert(object);
+  }
+
+  // 删除所有对象
+  void clear() {
+    std::fill(_bucket_heads.begin(), _bucket_heads.end(), -1);
+    _entries.clear();
+    _free_entry = -1;
+    _records.clear();
+    std::fill(_index_slots.begin(), _index_slots.end(), IndexSlot());
+    _index_size = 0;
+    _num_entries = 0;
+    _min_cell_x = std::numeric_limits<int>::max();
+    _max_cell_x = std::numeric_limits<int>::min();
+    _min_cell_y = std::numeric_limits<int>::max();
+    _max_cell_y = std::numeric_limits<int>::min();
+  }
+
+  // 获取离点'point'最近的对象
+  ObjectPtr get_nearest_object(const Vec2d& point) const {
+    ObjectPtr nearest_object = nullptr;
+    if (_records.empty()) {
+      return nearest_object;
+    }
+    double min_distance_sqr = std::numeric_limits<double>::infinity();
+    auto check = [&point, &min_distance_sqr, &nearest_object](
+        const CellEntry& entry, ObjectPtr object) {
+      if (lower_distance_square(entry, point) >= min_distance_sqr) {
+        return;
+      }
+      const double distance_sqr = object->distance_square_to(point);
+      if (distance_sqr < min_distance_sqr) {
+        min_distance_sqr = distance_sqr;
+        nearest_object = object;
+      }
+    };
+    // 由内向外逐圈搜索，剩余的网格不可能更近或者已经超出对象的范围时停止
+    const int center_x = cell_coordinate(point.x());
+    const int center_y = cell_coordinate(point.y());
+    const int max_ring = std::max(
+      std::max(std::abs(center_x - _min_cell_x), std::abs(center_x - _max_cell_x)),
+      std::max(std::abs(center_y - _min_cell_y), std::abs(center_y - _max_cell_y)));
+    int num_visited_cells = 0;
+    for (int ring = 0; ring <= max_ring; ++ring) {
+      if (ring > 0 && square((ring - 1) * _cell_size) >= min_distance_sqr) {
+        break;
+      }
+      num_visited_cells += ring == 0 ? 1 : 8 * ring;
+      if (num_visited_cells > 2 * _num_entries + 16) {
+        // 对象稀疏时逐圈搜索的网格太多，直接遍历所有对象
+        for (const Record& record : _records) {
+          check(first_entry(record), record.object);
+        }
+        break;
+      }
+      for_each_ring_cell(center_x, center_y, ring, [&](const int cx, const int cy) {
+        for (int index = _bucket_heads[bucket_index(cx, cy)]; index >= 0;
+             index = _entries[index].next) {
+          const CellEntry& entry = _entries[index];
+          if (entry.cell_x == cx && entry.cell_y == cy) {
+            check(entry, _records[entry.record].object);
+          }
+        }
+      });
+    }
+    return nearest_object;
+  }
+
+  // 获取到点'point'的距离在'distance'之内的对象
+  std::vector<ObjectPtr> get_objects(const Vec2d& point,
+                                     const double distance) const {
+    std::vector<ObjectPtr> result_objects;
+    get_objects(point, distance, &result_objects);
+    return result_objects;
+  }
+
+  // 获取到点'point'的距离在'distance'之内的对象，结果写入调用者提供的'result_objects'。
+  void get_objects(const Vec2d& point, const double distance,
+                   std::vector<ObjectPtr>* const result_objects) const {
+    assert(result_objects);
+    result_objects->clear();
+    visit_objects(point, distance, [result_objects](ObjectPtr object) {
+      result_objects->push_back(object);
+      return true;
+    });
+  }
+
+  // 对范围内的每一个对象调用'visitor'，'visitor'返回false时停止，被停止时返回false。
+  template <typename Visitor>
+  bool visit_objects(const Vec2d& point, const double distance,
+                     Visitor&& visitor) const {
+    if (distance < 0.0) {
+      return true;
+    }
+    const double distance_sqr = distance * distance;
+    const AABox2d bounds(point, 2.0 * distance, 2.0 * distance);
+    return visit_candidates(bounds, [&](const CellEntry& entry, ObjectPtr object) {
+      if (lower_distance_square(entry, point) > distance_sqr ||
+          object->distance_square_to(point) > distance_sqr) {
+        return true;
+      }
+      return visitor(object);
+    });
+  }
+
+  // 获取离点'point'最近的'k'个对象，按照距离由近到远排列。
+  std::vector<ObjectPtr> get_k_nearest_objects(const Vec2d& point,
+                                               const int k) const {
+    std::vector<ObjectPtr> result_objects;
+    if (k <= 0 || _records.empty()) {
+      return result_objects;
+    }
+    // 用最近对象的搜索半径逐步扩大范围查询，直到找到k个对象或者覆盖所有对象
+    double radius = _cell_size;
+    const AABox2d bounds = get_bounding_box();
+    const double max_radius = bounds.distance_to(point) +
+                              std::hypot(bounds.length(), bounds.width());
+    std::vector<std::pair<double, ObjectPtr>> candidates;
+    while (true) {
+      candidates.clear();
+      visit_objects(point, radius, [&point, &candidates](ObjectPtr object) {
+        candidates.emplace_back(object->distance_square_to(point), object);
+        return true;
+      });
+      if (static_cast<int>(candidates.size()) >= k || radius >= max_radius) {
+        break;
+      }
+      radius *= 2.0;
+    }
+    const int n = std::min(k, static_cast<int>(candidates.size()));
+    std::partial_sort(candidates.begin(), candidates.begin() + n,
+                      candidates.end());
+    result_objects.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      result_objects.push_back(candidates[i].second);
+    }
+    return result_objects;
+  }
+
+  // 获取轴对齐盒子与'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const AABox2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与有向盒子'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const Box2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeOrientedBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与线段'segment'相交的对象
+  std::vector<ObjectPtr> get_objects(const LineSegment2d& segment) const {
+    return get_overlapping_objects(AABoxKDTreeSegmentQuery(segment));
+  }
+
+  // 对轴对齐盒子与'query'区域重叠的每一个对象调用'visitor'，被停止时返回false。
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects(const Query& query, Visitor&& visitor) const {
+    return visit_candidates(query.bounds(),
+      [&query, &visitor](const CellEntry& entry, ObjectPtr object) {
+        if (!query.overlaps(entry.min_x, entry.max_x, entry.min_y, entry.max_y)) {
+          return true;
+        }
+        return visitor(object);
+      });
+  }
+
+  // 获取轴对齐盒子包含所有的对象
+  AABox2d get_bounding_box() const {
+    if (_records.empty()) {
+      return AABox2d();
+    }
+    const CellEntry& first = first_entry(_records[0]);
+    double min_x = first.min_x;
+    double max_x = first.max_x;
+    double min_y = first.min_y;
+    double max_y = first.max_y;
+    for (const Record& record : _records) {
+      const CellEntry& entry = first_entry(record);
+      min_x = std::fmin(min_x, entry.min_x);
+      max_x = std::fmax(max_x, entry.max_x);
+      min_y = std::fmin(min_y, entry.min_y);
+      max_y = std::fmax(max_y, entry.max_y);
+    }
+    return AABox2d({min_x, min_y}, {max_x, max_y});
+  }
+
+  // 对象的数量
+  int size() const { return static_cast<int>(_records.size()); }
+
+  // 对象在网格中登记的总次数
+  int num_entries() const { return _num_entries; }
+
+  double cell_size() const { return _cell_size; }
+
+private:
+  // 对象在一个网格中的登记，保存在_entries中，通过索引串联
+  struct CellEntry {
+    double min_x;                       // 对象的轴对齐盒子
+    double max_x;
+    double min_y;
+    double max_y;
+    int32_t cell_x;                     // 所在网格，用于排除哈希冲突
+    int32_t cell_y;
+    int32_t record;                     // 对象记录在_records中的索引
+    int32_t prev;                       // 桶链表中的前一项，-1表示桶的第一项
+    int32_t next;                       // 桶链表(或者空闲链表)中的后一项
+    int32_t next_in_record;             // 同一个对象的下一个登记
+  };
+
+  // 对象记录
+  struct Record {
+    ObjectPtr object = nullptr;
+    int min_cell_x = 0;                 // 对象覆盖的网格范围
+    int max_cell_x = 0;
+    int min_cell_y = 0;
+    int max_cell_y = 0;
+    int first_entry = -1;               // 对象登记链表的第一项
+    int num_entries = 0;
+  };
+
+  // 对象到记录索引的开放寻址哈希表的槽位，object为空表示空槽位
+  struct IndexSlot {
+    ObjectPtr object = nullptr;
+    int record = -1;
+  };
+
+  int cell_coordinate(const double value) const {
+    const double c = std::floor(value * _inv_cell_size);
+    // 限制范围，避免溢出
+    const double kLimit = static_cast<double>(std::numeric_limits<int>::max() / 4);
+    return static_cast<int>(clamp(c, -kLimit, kLimit));
+  }
+
+  int bucket_index(const int cx, const int cy) const {
+    const uint32_t h = static_cast<uint32_t>(cx) * 73856093u ^
+                       static_cast<uint32_t>(cy) * 19349663u;
+    return static_cast<int>(h & _bucket_mask);
+  }
+
+  const CellEntry& first_entry(const Record& record) const {
+    return _entries[record.first_entry];
+  }
+
+  // 从空闲链表中取出一个登记，空闲链表为空时扩展数组
+  int allocate_entry() {
+    if (_free_entry >= 0) {
+      const int index = _free_entry;
+      _free_entry = _entries[index].next;
+      return index;
+    }
+    _entries.emplace_back();
+    return static_cast<int>(_entries.size()) - 1;
+  }
+
+  int index_home(ObjectPtr object) const {
+    const uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(object)) *
+                       0x9e3779b97f4a7c15ULL;
+    return static_cast<int>((h >> 32) & (_index_slots.size() - 1));
+  }
+
+  // 线性探测，返回'object'所在的槽位，不存在时返回应该插入的空槽位
+  int find_index_slot(ObjectPtr object) const {
+    const int mask = static_cast<int>(_index_slots.size()) - 1;
+    int slot = index_home(object);
+    while (_index_slots[slot].object != nullptr &&
+           _index_slots[slot].object != object) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  // 删除槽位，之后的槽位向前移动以保持探测序列连续，不需要墓碑
+  void erase_index_slot(int slot) {
+    const int mask = static_cast<int>(_index_slots.size()) - 1;
+    int next = slot;
+    while (true) {
+      next = (next + 1) & mask;
+      if (_index_slots[next].object == nullptr) {
+        break;
+      }
+      const int home = index_home(_index_slots[next].object);
+      // home不在(slot, next]之间时，移动到slot之后仍然可以被找到
+      const bool in_range = slot <= next ? (slot < home && home <= next)
+                                         : (slot < home || home <= next);
+      if (!in_range) {
+        _index_slots[slot] = _index_slots[next];
+        slot = next;
+      }
+    }
+    _index_slots[slot] = IndexSlot();
+    --_index_size;
+  }
+
+  // 保证哈希表可以容纳'count'个对象并且装载率不超过1/2
+  void reserve_index(const int count) {
+    int capacity = static_cast<int>(_index_slots.size());
+    while (capacity < 2 * count + 2) {
+      capacity <<= 1;
+    }
+    if (capacity == static_cast<int>(_index_slots.size())) {
+      return;
+    }
+    std::vector<IndexSlot> slots(capacity);
+    slots.swap(_index_slots);
+    for (const IndexSlot& slot : slots) {
+      if (slot.object != nullptr) {
+        _index_slots[find_index_slot(slot.object)] = slot;
+      }
+    }
+  }
+
+  static double lower_distance_square(const CellEntry& entry, const Vec2d& point) {
+    const double dx = std::fmax(0.0, std::fmax(entry.min_x - point.x(),
+                                               point.x() - entry.max_x));
+    const double dy = std::fmax(0.0, std::fmax(entry.min_y - point.y(),
+                                               point.y() - entry.max_y));
+    return dx * dx + dy * dy;
+  }
+
+  // 遍历以(center_x, center_y)为中心的第'ring'圈网格
+  template <typename Function>
+  static void for_each_ring_cell(const int center_x, const int center_y,
+                                 const int ring, const Function& function) {
+    if (ring == 0) {
+      function(center_x, center_y);
+      return;
+    }
+    for (int cx = center_x - ring; cx <= center_x + ring; ++cx) {
+      function(cx, center_y - ring);
+      function(cx, center_y + ring);
+    }
+    for (int cy = center_y - ring + 1; cy <= center_y + ring - 1; ++cy) {
+      function(center_x - ring, cy);
+      function(center_x + ring, cy);
+    }
+  }
+
+  /*
+   * 对每一个盒子与'bounds'覆盖的网格有交集的对象调用一次'function(entry, object)'，
+   * 'function'返回false时停止。
+   * 跨越多个网格的对象只在其覆盖范围与查询范围的第一个公共网格中被报告。
+   */
+  template <typename Function>
+  bool visit_candidates(const AABox2d& bounds, const Function& function) const {
+    if (_records.empty()) {
+      return true;
+    }
+    const int min_cx = std::max(cell_coordinate(bounds.min_x()), _min_cell_x);
+    const int max_cx = std::min(cell_coordinate(bounds.max_x()), _max_cell_x);
+    const int min_cy = std::max(cell_coordinate(bounds.min_y()), _min_cell_y);
+    const int max_cy = std::min(cell_coordinate(bounds.max_y()), _max_cell_y);
+    if (min_cx > max_cx || min_cy > max_cy) {
+      return true;
+    }
+    const double num_cells = (static_cast<double>(max_cx) - min_cx + 1.0) *
+                             (static_cast<double>(max_cy) - min_cy + 1.0);
+    if (num_cells > _num_entries) {
+      // 查询范围覆盖的网格比登记还多，直接遍历所有对象
+      for (const Record& record : _records) {
+        const CellEntry& entry = first_entry(record);
+        if (entry.max_x < bounds.min_x() || entry.min_x > bounds.max_x() ||
+            entry.max_y < bounds.min_y() || entry.min_y > bounds.max_y()) {
+          continue;
+        }
+        if (!function(entry, record.object)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    for (int cx = min_cx; cx <= max_cx; ++cx) {
+      for (int cy = min_cy; cy <= max_cy; ++cy) {
+        for (int index = _bucket_heads[bucket_index(cx, cy)]; index >= 0;
+             index = _entries[index].next) {
+          const CellEntry& entry = _entries[index];
+          if (entry.cell_x != cx || entry.cell_y != cy) {
+            continue;
+          }
+          const Record& record = _records[entry.record];
+          if (cx != std::max(min_cx, record.min_cell_x) ||
+              cy != std::max(min_cy, record.min_cell_y)) {
+            continue;
+          }
+          if (!function(entry, record.object)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  template <typename Query>
+  std::vector<ObjectPtr> get_overlapping_objects(const Query& query) const {
+    std::vector<ObjectPtr> result_objects;
+    visit_overlapping_objects(query, [&result_objects](ObjectPtr object) {
+      result_objects.push_back(object);
+      return true;
+    });
+    return result_objects;
+  }
+
+private:
+  double _cell_size = 1.0;
+  double _inv_cell_size = 1.0;
+  uint32_t _bucket_mask = 0;
+  std::vector<int32_t> _bucket_heads;  // 每个桶链表的第一项，-1表示空桶
+  std::vector<CellEntry> _entries;     // 所有的登记
+  int _free_entry = -1;                 // 空闲链表的第一项
+  std::vector<Record> _records;
+  std::vector<IndexSlot> _index_slots;  // 对象到记录索引的哈希表，容量为2的幂
+  int _index_size = 0;
+  int _num_entries = 0;
+  // 登记过对象的网格范围，删除对象时不收缩
+  int _min_cell_x = std::numeric_limits<int>::max();
+  int _max_cell_x = std::numeric_limits<int>::min();
+  int _min_cell_y = std::numeric_limits<int>::max();
+  int _max_cell_y = std::numeric_limits<int>::min();
+};
+
+}}
+
+#endif
@@ -1,23 +1,284 @@
 #ifndef MYMATH_AABOXKDTREE2D_HPP
 #define MYMATH_AABOXKDTREE2D_HPP
 
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <vector>
 #include <cassert>
+#include <utility>
+#include <thread>
+#include <iterator>
 #include <algorithm>
+#include <functional>
 
 #include "math_utils.hpp"
 #include "aabox2d.hpp"
+#include "box2d.hpp"
+#include "line_segment2d.hpp"
+#include "aaboxkdtree2d_stats.hpp"
 
 namespace mypilot {
 namespace mymath {
 
+// 节点切分位置的选择策略
+enum AABoxKDTreeSplitStrategy {
+  SPLIT_MIDPOINT = 0,                   // 较长轴的中点
+  SPLIT_MEDIAN = 1,                     // 较长轴上对象中心的中位数
+  SPLIT_SAH = 2,                        // 两个轴上按照面积(周长)启发式代价最小的位置
+};
+
 // 轴对齐盒子KD树的参数
 struct AABoxKDTreeParams {
   int max_depth = -1;                   // kdtree最大深度
   int max_leaf_size = -1;               // 在一个叶子节点的最大项目数量
   double max_leaf_dimension = -1.0;     // 叶子节点的最大维度
+  AABoxKDTreeSplitStrategy split_strategy = SPLIT_MIDPOINT;  // 切分策略
+  int parallel_build_depth = 0;         // 小于该深度的子树并行构建，0表示单线程构建
+};
+
+// SAH切分时每个轴上候选位置的数量
+static constexpr int kAABoxKDTreeSAHBins = 16;
+
+/*
+ * 计算对象集合[begin, end)的切分轴与切分位置
+ *
+ * get_aabox : 从集合元素获取其轴对齐盒子的函数
+ * min_x, max_x, min_y, max_y : 集合的边界
+ * partition_by_x : 输出，是否按照x轴切分
+ * position : 输出，切分位置
+ *
+ * 元素被切分为'max <= position'的左侧对象，'min >= position'的右侧对象，
+ * 其余的跨越切分线的对象留在当前节点。SPLIT_MEDIAN会重新排列区间内的元素。
+ */
+template <typename Iterator, typename GetAABox>
+void compute_kdtree_partition(Iterator begin, Iterator end,
+                              const GetAABox& get_aabox,
+                              const double min_x, const double max_x,
+                              const double min_y, const double max_y,
+                              const AABoxKDTreeSplitStrategy strategy,
+                              bool* const partition_by_x,
+                              double* const position) {
+  *partition_by_x = (max_x - min_x >= max_y - min_y);
+  *position = *partition_by_x ? (min_x + max_x) / 2.0 : (min_y + max_y) / 2.0;
+  if (strategy == SPLIT_MEDIAN) {
+    const bool by_x = *partition_by_x;
+    auto center = [&](const typename std::iterator_traits<Iterator>::value_type&
+                        object) {
+      const auto& box = get_aabox(object);
+      return by_x ? box.center_x() : box.center_y();
+    };
+    Iterator median = begin + (end - begin) / 2;
+    std::nth_element(begin, median, end,
+                     [&](const typename std::iterator_traits<Iterator>::value_type& a,
+                         const typename std::iterator_traits<Iterator>::value_type& b) {
+                       return center(a) < center(b);
+                     });
+    *position = center(*median);
+  } else if (strategy == SPLIT_SAH) {
+    // 以半周长作为二维中的'表面积'，跨越切分线的对象按照当前节点的面积计算代价
+    struct Bin {
+      double min_x = std::numeric_limits<double>::infinity();
+      double max_x = -std::numeric_limits<double>::infinity();
+      double min_y = std::numeric_limits<double>::infinity();
+      double max_y = -std::numeric_limits<double>::infinity();
+      int count = 0;
+      void merge(const Bin& other) {
+        min_x = std::fmin(min_x, other.min_x);
+        max_x = std::fmax(max_x, other.max_x);
+        min_y = std::fmin(min_y, other.min_y);
+        max_y = std::fmax(max_y, other.max_y);
+        count += other.count;
+      }
+      void merge(const double box_min_x, const double box_max_x,
+                 const double box_min_y, const double box_max_y) {
+        min_x = std::fmin(min_x, box_min_x);
+        max_x = std::fmax(max_x, box_max_x);
+        min_y = std::fmin(min_y, box_min_y);
+        max_y = std::fmax(max_y, box_max_y);
+        ++count;
+      }
+      double half_perimeter() const {
+        return count == 0 ? 0.0 : (max_x - min_x) + (max_y - min_y);
+      }
+    };
+    const int num_objects = static_cast<int>(end - begin);
+    const double node_half_perimeter = (max_x - min_x) + (max_y - min_y);
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (const bool by_x : {true, false}) {
+      const double lo = by_x ? min_x : min_y;
+      const double extent = by_x ? (max_x - min_x) : (max_y - min_y);
+      if (extent <= math_epsilon) {
+        continue;
+      }
+      // left_bins[k] : 在切分位置k及之后才能归入左侧的对象
+      // right_bins[k] : 在切分位置k及之前都能归入右侧的对象
+      Bin left_bins[kAABoxKDTreeSAHBins + 1];
+      Bin right_bins[kAABoxKDTreeSAHBins + 1];
+      const double scale = kAABoxKDTreeSAHBins / extent;
+      for (Iterator it = begin; it != end; ++it) {
+        const auto& box = get_aabox(*it);
+        const double box_min = by_x ? box.min_x() : box.min_y();
+        const double box_max = by_x ? box.max_x() : box.max_y();
+        const int kmax = clamp(static_cast<int>(std::ceil((box_max - lo) * scale)),
+                               1, kAABoxKDTreeSAHBins);
+        const int kmin = clamp(static_cast<int>(std::floor((box_min - lo) * scale)),
+                               0, kAABoxKDTreeSAHBins - 1);
+        left_bins[kmax].merge(box.min_x(), box.max_x(), box.min_y(), box.max_y());
+        right_bins[kmin].merge(box.min_x(), box.max_x(), box.min_y(), box.max_y());
+      }
+      for (int k = 1; k <= kAABoxKDTreeSAHBins; ++k) {
+        left_bins[k].merge(left_bins[k - 1]);
+      }
+      for (int k = kAABoxKDTreeSAHBins - 1; k > 0; --k) {
+        right_bins[k - 1].merge(right_bins[k]);
+      }
+      for (int k = 1; k < kAABoxKDTreeSAHBins; ++k) {
+        const Bin& left = left_bins[k];
+        const Bin& right = right_bins[k];
+        const int num_straddling = num_objects - left.count - right.count;
+        const double cost = num_straddling * node_half_perimeter +
+                            left.count * left.half_perimeter() +
+                            right.count * right.half_perimeter();
+        if (cost < best_cost) {
+          best_cost = cost;
+          *partition_by_x = by_x;
+          *position = lo + k / scale;
+        }
+      }
+    }
+  }
+}
+
+// 轴对齐盒子范围查询：查找轴对齐盒子与'box'重叠的对象
+class AABoxKDTreeBoxQuery {
+public:
+  explicit AABoxKDTreeBoxQuery(const AABox2d& box) : _box(box) {}
+
+  // 查询区域的外包盒
+  const AABox2d& bounds() const { return _box; }
+
+  bool overlaps(const double min_x, const double max_x,
+                const double min_y, const double max_y) const {
+    return min_x <= _box.max_x() && max_x >= _box.min_x() &&
+           min_y <= _box.max_y() && max_y >= _box.min_y();
+  }
+
+  template <typename T>
+  bool overlaps(const AABox2<T>& aabox) const {
+    return overlaps(aabox.min_x(), aabox.max_x(), aabox.min_y(), aabox.max_y());
+  }
+
+private:
+  AABox2d _box;
+};
+
+// 有向盒子范围查询：查找轴对齐盒子与有向盒子'box'重叠的对象(分离轴测试)
+class AABoxKDTreeOrientedBoxQuery {
+public:
+  explicit AABoxKDTreeOrientedBoxQuery(const Box2d& box) :
+    _box(box), _bounds(box.get_aabox()) {}
+
+  const AABox2d& bounds() const { return _bounds; }
+
+  bool overlaps(const double min_x, const double max_x,
+                const double min_y, const double max_y) const {
+    // 两个坐标轴
+    if (min_x > _bounds.max_x() || max_x < _bounds.min_x() ||
+        min_y > _bounds.max_y() || max_y < _bounds.min_y()) {
+      return false;
+    }
+    // 有向盒子的两个轴
+    const double half_dx = (max_x - min_x) / 2.0;
+    const double half_dy = (max_y - min_y) / 2.0;
+    const double shift_x = (min_x + max_x) / 2.0 - _box.center_x();
+    const double shift_y = (min_y + max_y) / 2.0 - _box.center_y();
+    const double cos_heading = _box.cos_heading();
+    const double sin_heading = _box.sin_heading();
+    return std::abs(shift_x * cos_heading + shift_y * sin_heading) <=
+             half_dx * std::abs(cos_heading) + half_dy * std::abs(sin_heading) +
+             _box.half_length() &&
+           std::abs(shift_x * sin_heading - shift_y * cos_heading) <=
+             half_dx * std::abs(sin_heading) + half_dy * std::abs(cos_heading) +
+             _box.half_width();
+  }
+
+  template <typename T>
+  bool overlaps(const AABox2<T>& aabox) const {
+    return overlaps(aabox.min_x(), aabox.max_x(), aabox.min_y(), aabox.max_y());
+  }
+
+private:
+  Box2d _box;
+  AABox2d _bounds;
+};
+
+// 线段查询：查找轴对齐盒子与线段'segment'相交的对象，同时用于沿线段的射线检测
+class AABoxKDTreeSegmentQuery {
+public:
+  explicit AABoxKDTreeSegmentQuery(const LineSegment2d& segment) :
+    _segment(segment), _bounds(segment.start(), segment.end()) {}
+
+  const AABox2d& bounds() const { return _bounds; }
+  const LineSegment2d& segment() const { return _segment; }
+
+  /*
+   * 计算线段进入盒子时到起点的距离(slab方法)，线段与盒子不相交时返回false。
+   * 起点在盒子内时距离为0。
+   */
+  bool entry_distance(const double min_x, const double max_x,
+                      const double min_y, const double max_y,
+                      double* const distance) const {
+    const double dx = _segment.end().x() - _segment.start().x();
+    const double dy = _segment.end().y() - _segment.start().y();
+    double t_enter = 0.0;
+    double t_exit = 1.0;
+    if (!clip(dx, min_x - _segment.start().x(), max_x - _segment.start().x(),
+              &t_enter, &t_exit) ||
+        !clip(dy, min_y - _segment.start().y(), max_y - _segment.start().y(),
+              &t_enter, &t_exit)) {
+      return false;
+    }
+    *distance = t_enter * _segment.length();
+    return true;
+  }
+
+  template <typename T>
+  bool entry_distance(const AABox2<T>& aabox, double* const distance) const {
+    return entry_distance(aabox.min_x(), aabox.max_x(), aabox.min_y(),
+                          aabox.max_y(), distance);
+  }
+
+  bool overlaps(const double min_x, const double max_x,
+                const double min_y, const double max_y) const {
+    double distance = 0.0;
+    return entry_distance(min_x, max_x, min_y, max_y, &distance);
+  }
+
+  template <typename T>
+  bool overlaps(const AABox2<T>& aabox) const {
+    return overlaps(aabox.min_x(), aabox.max_x(), aabox.min_y(), aabox.max_y());
+  }
+
+private:
+  // 将参数区间[t_enter, t_exit]裁剪到 lower <= t * d <= upper 的范围
+  static bool clip(const double d, const double lower, const double upper,
+                   double* const t_enter, double* const t_exit) {
+    if (std::abs(d) <= math_epsilon) {
+      return lower <= 0.0 && upper >= 0.0;
+    }
+    double t0 = lower / d;
+    double t1 = upper / d;
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    *t_enter = std::max(*t_enter, t0);
+    *t_exit = std::min(*t_exit, t1);
+    return *t_enter <= *t_exit;
+  }
+
+  LineSegment2d _segment;
+  AABox2d _bounds;
 };
 
 // 轴对齐盒子KD树节点
@@ -31,31 +292,21 @@ public:
                     const AABoxKDTreeParams& params, int depth) : 
     _depth(depth) {
     assert(!objects.empty());
+    // 只复制一次，之后在这个缓冲区上原地切分
+    std::vector<ObjectPtr> buffer(objects);
+    build(buffer.data(), buffer.data() + buffer.size(), params);
+  }
 
-    compute_boundary(objects);
-    compute_partition();
-
-    if (split_to_subnodes(objects, params)) {
-      std::vector<ObjectPtr> left_subnode_objects;
-      std::vector<ObjectPtr> right_subnode_objects;
-      partition_objects(objects, &left_subnode_objects, &right_subnode_objects);
-
-      // 切分子节点
-      if (!left_subnode_objects.empty()) {
-        _left_subnode.reset(new AABoxKDTree2dNode<ObjectType>(
-          left_subnode_objects, params, depth + 1));
-      }
-      if (!right_subnode_objects.empty()) {
-        _right_subnode.reset(new AABoxKDTree2dNode<ObjectType>(
-          right_subnode_objects, params, depth + 1));
-      }
-    } else {
-      init_objects(objects);
-    }
+  // 在区间[begin, end)上原地构建，区间内的元素会被重新排列。
+  AABoxKDTree2dNode(ObjectPtr* const begin, ObjectPtr* const end,
+                    const AABoxKDTreeParams& params, int depth) :
+    _depth(depth) {
+    build(begin, end, params);
   }
 
   // 通过以节点'point'为根的KD树，获取最接近目标点的对象。
   ObjectPtr get_nearest_object(const Vec2d& point) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().num_queries++);
     ObjectPtr nearest_object = nullptr;
     double min_distance_sqr = std::numeric_limits<double>::infinity();
     get_nearest_object_internal(point, &min_distance_sqr, &nearest_object);
@@ -66,20 +317,294 @@ public:
   std::vector<ObjectPtr> get_objects(const Vec2d& point,
                                      const double distance) const {
     std::vector<ObjectPtr> result_objects;
-    get_objects_internal(point, distance, square(distance), &result_objects);
+    get_objects(point, distance, &result_objects);
+    return result_objects;
+  }
+
+  // 同上，结果写入调用者提供的'result_objects'(先清空)，复用其已分配的内存。
+  void get_objects(const Vec2d& point, const double distance,
+                   std::vector<ObjectPtr>* const result_objects) const {
+    assert(result_objects);
+    result_objects->clear();
+    visit_objects(point, distance, [result_objects](ObjectPtr object) {
+      result_objects->push_back(object);
+      return true;
+    });
+  }
+
+  /*
+   * 对到点'point'距离在'distance'之内的每一个对象调用'visitor'，不分配内存。
+   * 'visitor'的签名为 bool(ObjectPtr)，返回false时立即停止搜索。
+   * 搜索被提前停止时返回false。
+   */
+  template <typename Visitor>
+  bool visit_objects(const Vec2d& point, const double distance,
+                     Visitor&& visitor) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().num_queries++);
+    return visit_objects_internal(point, distance, square(distance), visitor);
+  }
+
+  // 获取离点'point'最近的'k'个对象，结果按照距离由近到远排列。
+  std::vector<ObjectPtr> get_k_nearest_objects(const Vec2d& point,
+                                               const int k) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().num_queries++);
+    std::vector<ObjectPtr> result_objects;
+    if (k <= 0) {
+      return result_objects;
+    }
+    // 以距离平方为键的最大堆，堆顶为当前第k近的对象
+    std::vector<std::pair<double, ObjectPtr>> heap;
+    heap.reserve(std::min(static_cast<size_t>(k),
+                          static_cast<size_t>(_num_subtree_objects)));
+    get_k_nearest_objects_internal(point, static_cast<size_t>(k), &heap);
+    std::sort_heap(heap.begin(), heap.end());
+    result_objects.reserve(heap.size());
+    for (const auto& item : heap) {
+      result_objects.push_back(item.second);
+    }
     return result_objects;
   }
 
+  // 获取轴对齐盒子与'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const AABox2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与有向盒子'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const Box2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeOrientedBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与线段'segment'相交的对象
+  std::vector<ObjectPtr> get_objects(const LineSegment2d& segment) const {
+    return get_overlapping_objects(AABoxKDTreeSegmentQuery(segment));
+  }
+
+  /*
+   * 对轴对齐盒子与'query'区域重叠的每一个对象调用'visitor'。
+   * 'query'为AABoxKDTreeBoxQuery、AABoxKDTreeOrientedBoxQuery或者AABoxKDTreeSegmentQuery，
+   * 'visitor'返回false时停止，被停止时返回false。
+   */
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects(const Query& query, Visitor&& visitor) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().num_queries++);
+    return visit_overlapping_objects_internal(query, visitor);
+  }
+
+  /*
+   * 沿着线段'segment'从起点出发的射线检测，返回第一个被击中的对象，没有则返回nullptr。
+   * 'hit'的签名为 bool(ObjectPtr object, double* distance)，计算线段与对象的精确交点，
+   * 'distance'为交点到线段起点的距离，不能小于线段进入对象轴对齐盒子的距离。
+   * 'hit_distance'不为空时输出击中点到起点的距离。
+   */
+  template <typename HitFunction>
+  ObjectPtr get_first_hit(const LineSegment2d& segment, const HitFunction& hit,
+                          double* const hit_distance = nullptr) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().num_queries++);
+    const AABoxKDTreeSegmentQuery query(segment);
+    double min_distance = std::numeric_limits<double>::infinity();
+    ObjectPtr hit_object = nullptr;
+    get_first_hit_internal(query, hit, &min_distance, &hit_object);
+    if (hit_distance != nullptr) {
+      *hit_distance = min_distance;
+    }
+    return hit_object;
+  }
+
+  // 同上，以对象的轴对齐盒子作为击中的判断。
+  ObjectPtr get_first_hit(const LineSegment2d& segment,
+                          double* const hit_distance = nullptr) const {
+    const AABoxKDTreeSegmentQuery query(segment);
+    return get_first_hit(segment,
+                         [&query](ObjectPtr object, double* const distance) {
+                           return query.entry_distance(object->aabox(),
+                                                       distance);
+                         },
+                         hit_distance);
+  }
+
   // 获取轴对齐盒子
   AABox2d get_bounding_box() const {
     return AABox2d({_min_x, _min_y}, {_max_x, _max_y});
   }
 
+  // 以当前节点为根的子树中的对象数量
+  int num_subtree_objects() const { return _num_subtree_objects; }
+
+  // 遍历子树累加构建统计(节点数量、叶子大小、深度与内存占用)
+  void get_build_stats(AABoxKDTreeBuildStats* const stats) const {
+    assert(stats);
+    ++stats->num_nodes;
+    stats->num_objects += _num_objects;
+    stats->max_depth = std::max(stats->max_depth, _depth);
+    stats->memory_bytes += sizeof(*this) +
+      (_objects_sorted_by_min.capacity() + objects_sorted_by_max_.capacity()) *
+        sizeof(ObjectPtr) +
+      (_objects_sorted_by_min_bound.capacity() +
+       _objects_sorted_by_max_bound.capacity()) * sizeof(double);
+    if (_left_subnode == nullptr && _right_subnode == nullptr) {
+      stats->add_leaf(_num_objects);
+      return;
+    }
+    stats->num_interior_objects += _num_objects;
+    for (const auto* subnode : {&_left_subnode, &_right_subnode}) {
+      if (*subnode != nullptr) {
+        (*subnode)->get_build_stats(stats);
+      }
+    }
+  }
+
+  // 插入对象，子树的对象数量偏离构建时过多时重建当前子树。
+  void insert(ObjectPtr object, const AABoxKDTreeParams& params) {
+    assert(object);
+    ++_num_subtree_objects;
+    if (needs_rebuild(params)) {
+      std::vector<ObjectPtr> objects;
+      objects.reserve(_num_subtree_objects);
+      collect_objects(&objects);
+      objects.push_back(object);
+      rebuild(objects, params);
+      return;
+    }
+
+    const auto& box = object->aabox();
+    merge_boundary(box);
+    const bool has_subnodes =
+      (_left_subnode != nullptr || _right_subnode != nullptr);
+    if (has_subnodes) {
+      std::unique_ptr<AABoxKDTree2dNode<ObjectType>>* subnode = nullptr;
+      if (max_bound(box) <= _partition_position) {
+        subnode = &_left_subnode;
+      } else if (min_bound(box) >= _partition_position) {
+        subnode = &_right_subnode;
+      }
+      if (subnode != nullptr) {
+        if (*subnode == nullptr) {
+          subnode->reset(new AABoxKDTree2dNode<ObjectType>(
+            std::vector<ObjectPtr>(1, object), params, _depth + 1));
+        } else {
+          (*subnode)->insert(object, params);
+        }
+        return;
+      }
+    }
+    insert_to_node(object);
+  }
+
+  /*
+   * 沿着轴对齐盒子'aabox'所在的路径删除对象，'aabox'必须是对象插入树时的盒子。
+   * 删除成功返回true。
+   */
+  template <typename T>
+  bool remove(ObjectPtr object, const AABox2<T>& aabox,
+              const AABoxKDTreeParams& params) {
+    std::unique_ptr<AABoxKDTree2dNode<ObjectType>>* subnode = nullptr;
+    if (max_bound(aabox) <= _partition_position && _left_subnode != nullptr) {
+      subnode = &_left_subnode;
+    } else if (min_bound(aabox) >= _partition_position &&
+               _right_subnode != nullptr) {
+      subnode = &_right_subnode;
+    }
+    const bool removed = (subnode == nullptr)
+      ? remove_from_node(object)
+      : remove_from_subnode(subnode, object, aabox, params);
+    if (removed) {
+      on_object_removed(params);
+    }
+    return removed;
+  }
+
+  // 在整棵子树中查找并删除对象，用于对象的盒子未知的情况。
+  bool remove_anywhere(ObjectPtr object, const AABoxKDTreeParams& params) {
+    bool removed = remove_from_node(object);
+    for (auto* subnode : {&_left_subnode, &_right_subnode}) {
+      if (removed) {
+        break;
+      }
+      if (*subnode != nullptr && (*subnode)->remove_anywhere(object, params)) {
+        if ((*subnode)->num_subtree_objects() == 0) {
+          subnode->reset();
+        }
+        removed = true;
+      }
+    }
+    if (removed) {
+      on_object_removed(params);
+    }
+    return removed;
+  }
+
+  // 根据当前的对象重新计算紧凑的节点边界(删除对象后边界只会保守地保持不变)。
+  void refit() {
+    _min_x = std::numeric_limits<double>::infinity();
+    _min_y = std::numeric_limits<double>::infinity();
+    _max_x = -std::numeric_limits<double>::infinity();
+    _max_y = -std::numeric_limits<double>::infinity();
+    for (ObjectPtr object : _objects_sorted_by_min) {
+      merge_boundary(object->aabox());
+    }
+    for (auto* subnode : {&_left_subnode, &_right_subnode}) {
+      if (*subnode != nullptr) {
+        (*subnode)->refit();
+        merge_boundary((*subnode)->get_bounding_box());
+      }
+    }
+  }
+
 private:
-  void init_objects(const std::vector<ObjectPtr>& objects) {
-    _num_objects = objects.size();
-    _objects_sorted_by_min = objects;
-    objects_sorted_by_max_ = objects;
+  void build(ObjectPtr* const begin, ObjectPtr* const end,
+             const AABoxKDTreeParams& params) {
+    assert(begin < end);
+    const int num_objects = static_cast<int>(end - begin);
+    _num_subtree_objects = num_objects;
+    _num_built_objects = num_objects;
+
+    compute_boundary(begin, end);
+    compute_partition(begin, end, params);
+
+    if (!split_to_subnodes(num_objects, params)) {
+      init_objects(begin, end);
+      return;
+    }
+    ObjectPtr* left_end = nullptr;
+    ObjectPtr* right_begin = nullptr;
+    partition_objects(begin, end, &left_end, &right_begin);
+    // 所有对象都落在同一侧时无法继续切分
+    if (left_end == end || right_begin == begin) {
+      init_objects(begin, end);
+      return;
+    }
+    init_objects(left_end, right_begin);
+
+    // 切分子节点，两个子节点的区间互不重叠，可以并行构建。
+    const int depth = _depth;
+    auto build_left = [&]() {
+      if (begin < left_end) {
+        _left_subnode.reset(new AABoxKDTree2dNode<ObjectType>(
+          begin, left_end, params, depth + 1));
+      }
+    };
+    auto build_right = [&]() {
+      if (right_begin < end) {
+        _right_subnode.reset(new AABoxKDTree2dNode<ObjectType>(
+          right_begin, end, params, depth + 1));
+      }
+    };
+    if (depth < params.parallel_build_depth && begin < left_end &&
+        right_begin < end) {
+      std::thread left_thread(build_left);
+      build_right();
+      left_thread.join();
+    } else {
+      build_left();
+      build_right();
+    }
+  }
+
+  void init_objects(ObjectPtr* const begin, ObjectPtr* const end) {
+    _num_objects = static_cast<int>(end - begin);
+    _objects_sorted_by_min.assign(begin, end);
+    objects_sorted_by_max_.assign(begin, end);
     std::sort(_objects_sorted_by_min.begin(), _objects_sorted_by_min.end(),
               [&](ObjectPtr obj1, ObjectPtr obj2) {
                 return _partition == PARTITION_X
@@ -106,12 +631,12 @@ private:
     }
   }
 
-  bool split_to_subnodes(const std::vector<ObjectPtr>& objects,
+  bool split_to_subnodes(const int num_objects,
                          const AABoxKDTreeParams& params) {
     if (params.max_depth >= 0 && _depth >= params.max_depth) {
       return false;
     }
-    if (static_cast<int>(objects.size()) <= std::max(1, params.max_leaf_size)) {
+    if (num_objects <= std::max(1, params.max_leaf_size)) {
       return false;
     }
     if (params.max_leaf_dimension >= 0.0 &&
@@ -146,66 +671,85 @@ private:
     return dx * dx + dy * dy;
   }
 
-  void get_all_objects(std::vector<ObjectPtr>* const result_objects) const {
-    result_objects->insert(result_objects->end(),
-                           _objects_sorted_by_min.begin(),
-                           _objects_sorted_by_min.end());
-    if (_left_subnode != nullptr) {
-      _left_subnode->get_all_objects(result_objects);
+  template <typename Visitor>
+  bool visit_all_objects(Visitor& visitor) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
+    for (ObjectPtr object : _objects_sorted_by_min) {
+      if (!visitor(object)) {
+        return false;
+      }
     }
-    if (_right_subnode != nullptr) {
-      _right_subnode->get_all_objects(result_objects);
+    if (_left_subnode != nullptr && !_left_subnode->visit_all_objects(visitor)) {
+      return false;
+    }
+    if (_right_subnode != nullptr &&
+        !_right_subnode->visit_all_objects(visitor)) {
+      return false;
     }
+    return true;
   }
 
-  void get_objects_internal(const Vec2d& point, const double distance,
-                            const double distance_sqr,
-                            std::vector<ObjectPtr>* const result_objects) const {
+  template <typename Visitor>
+  bool visit_objects_internal(const Vec2d& point, const double distance,
+                              const double distance_sqr,
+                              Visitor& visitor) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
     if (lower_distance_square_to_point(point) > distance_sqr) {
-      return;
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().nodes_pruned++);
+      return true;
     }
     if (upper_distance_square_to_point(point) <= distance_sqr) {
-      get_all_objects(result_objects);
-      return;
+      return visit_all_objects(visitor);
     }
     const double pvalue = (_partition == PARTITION_X ? point.x() : point.y());
     if (pvalue < _partition_position) {
       const double limit = pvalue + distance;
       for (int i = 0; i < _num_objects; ++i) {
         if (_objects_sorted_by_min_bound[i] > limit) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
           break;
         }
         ObjectPtr object = _objects_sorted_by_min[i];
-        if (object->distance_square_to(point) <= distance_sqr) {
-          result_objects->push_back(object);
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+        if (object->distance_square_to(point) <= distance_sqr &&
+            !visitor(object)) {
+          return false;
         }
       }
     } else {
       const double limit = pvalue - distance;
       for (int i = 0; i < _num_objects; ++i) {
         if (_objects_sorted_by_max_bound[i] < limit) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
           break;
         }
         ObjectPtr object = objects_sorted_by_max_[i];
-        if (object->distance_square_to(point) <= distance_sqr) {
-          result_objects->push_back(object);
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+        if (object->distance_square_to(point) <= distance_sqr &&
+            !visitor(object)) {
+          return false;
         }
       }
     }
-    if (_left_subnode != nullptr) {
-      _left_subnode->get_objects_internal(point, distance, distance_sqr,
-                                          result_objects);
+    if (_left_subnode != nullptr &&
+        !_left_subnode->visit_objects_internal(point, distance, distance_sqr,
+                                               visitor)) {
+      return false;
     }
-    if (_right_subnode != nullptr) {
-      _right_subnode->get_objects_internal(point, distance, distance_sqr,
-                                           result_objects);
+    if (_right_subnode != nullptr &&
+        !_right_subnode->visit_objects_internal(point, distance, distance_sqr,
+                                                visitor)) {
+      return false;
     }
+    return true;
   }
 
   void get_nearest_object_internal(const Vec2d& point,
                                    double* const min_distance_sqr,
                                    ObjectPtr* const nearest_object) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
     if (lower_distance_square_to_point(point) >= *min_distance_sqr - math_epsilon) {
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().nodes_pruned++);
       return;
     }
     const double pvalue = (_partition == PARTITION_X ? point.x() : point.y());
@@ -229,9 +773,11 @@ private:
       for (int i = 0; i < _num_objects; ++i) {
         const double bound = _objects_sorted_by_min_bound[i];
         if (bound > pvalue && square(bound - pvalue) > *min_distance_sqr) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
           break;
         }
         ObjectPtr object = _objects_sorted_by_min[i];
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
         const double distance_sqr = object->distance_square_to(point);
         if (distance_sqr < *min_distance_sqr) {
           *min_distance_sqr = distance_sqr;
@@ -242,9 +788,11 @@ private:
       for (int i = 0; i < _num_objects; ++i) {
         const double bound = _objects_sorted_by_max_bound[i];
         if (bound < pvalue && square(bound - pvalue) > *min_distance_sqr) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
           break;
         }
         ObjectPtr object = objects_sorted_by_max_[i];
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
         const double distance_sqr = object->distance_square_to(point);
         if (distance_sqr < *min_distance_sqr) {
           *min_distance_sqr = distance_sqr;
@@ -268,12 +816,285 @@ private:
     }
   }
 
-  void compute_boundary(const std::vector<ObjectPtr>& objects) {
+  template <typename Query>
+  std::vector<ObjectPtr> get_overlapping_objects(const Query& query) const {
+    std::vector<ObjectPtr> result_objects;
+    visit_overlapping_objects(query, [&result_objects](ObjectPtr object) {
+      result_objects.push_back(object);
+      return true;
+    });
+    return result_objects;
+  }
+
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects_internal(const Query& query,
+                                          Visitor& visitor) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
+    if (!query.overlaps(_min_x, _max_x, _min_y, _max_y)) {
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().nodes_pruned++);
+      return true;
+    }
+    // 对象按照切分轴的最小边界升序排列，超过查询区域的最大边界后不再可能重叠
+    const AABox2d& bounds = query.bounds();
+    const double limit = max_bound(bounds);
+    for (int i = 0; i < _num_objects; ++i) {
+      if (_objects_sorted_by_min_bound[i] > limit) {
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
+        break;
+      }
+      ObjectPtr object = _objects_sorted_by_min[i];
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+      if (query.overlaps(object->aabox()) && !visitor(object)) {
+        return false;
+      }
+    }
+    if (_left_subnode != nullptr &&
+        !_left_subnode->visit_overlapping_objects_internal(query, visitor)) {
+      return false;
+    }
+    if (_right_subnode != nullptr &&
+        !_right_subnode->visit_overlapping_objects_internal(query, visitor)) {
+      return false;
+    }
+    return true;
+  }
+
+  template <typename HitFunction>
+  void get_first_hit_internal(const AABoxKDTreeSegmentQuery& query,
+                              const HitFunction& hit,
+                              double* const min_distance,
+                              ObjectPtr* const hit_object) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
+    double node_distance = 0.0;
+    if (!query.entry_distance(_min_x, _max_x, _min_y, _max_y, &node_distance) ||
+        node_distance > *min_distance) {
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().nodes_pruned++);
+      return;
+    }
+    for (ObjectPtr object : _objects_sorted_by_min) {
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+      double box_distance = 0.0;
+      if (!query.entry_distance(object->aabox(), &box_distance) ||
+          box_distance >= *min_distance) {
+        continue;
+      }
+      double distance = 0.0;
+      if (hit(object, &distance) && distance < *min_distance) {
+        *min_distance = distance;
+        *hit_object = object;
+      }
+    }
+    // 先访问线段先进入的子节点
+    double left_distance = std::numeric_limits<double>::infinity();
+    double right_distance = std::numeric_limits<double>::infinity();
+    if (_left_subnode != nullptr) {
+      const AABox2d box = _left_subnode->get_bounding_box();
+      query.entry_distance(box, &left_distance);
+    }
+    if (_right_subnode != nullptr) {
+      const AABox2d box = _right_subnode->get_bounding_box();
+      query.entry_distance(box, &right_distance);
+    }
+    const AABoxKDTree2dNode* first_subnode = _left_subnode.get();
+    const AABoxKDTree2dNode* second_subnode = _right_subnode.get();
+    if (right_distance < left_distance) {
+      std::swap(first_subnode, second_subnode);
+    }
+    if (first_subnode != nullptr) {
+      first_subnode->get_first_hit_internal(query, hit, min_distance,
+                                            hit_object);
+    }
+    if (second_subnode != nullptr) {
+      second_subnode->get_first_hit_internal(query, hit, min_distance,
+                                             hit_object);
+    }
+  }
+
+  // 当前第k近的对象的距离平方，不足k个时为无穷大。
+  static double kth_distance_square(
+      const size_t k, const std::vector<std::pair<double, ObjectPtr>>& heap) {
+    return heap.size() < k ? std::numeric_limits<double>::infinity()
+                           : heap.front().first;
+  }
+
+  static void push_to_heap(const size_t k, const double distance_sqr,
+                           ObjectPtr object,
+                           std::vector<std::pair<double, ObjectPtr>>* const heap) {
+    if (heap->size() < k) {
+      heap->emplace_back(distance_sqr, object);
+      std::push_heap(heap->begin(), heap->end());
+    } else if (distance_sqr < heap->front().first) {
+      std::pop_heap(heap->begin(), heap->end());
+      heap->back() = std::make_pair(distance_sqr, object);
+      std::push_heap(heap->begin(), heap->end());
+    }
+  }
+
+  void get_k_nearest_objects_internal(
+      const Vec2d& point, const size_t k,
+      std::vector<std::pair<double, ObjectPtr>>* const heap) const {
+    MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().on_node_visited(_depth));
+    if (lower_distance_square_to_point(point) >=
+        kth_distance_square(k, *heap) - math_epsilon) {
+      MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().nodes_pruned++);
+      return;
+    }
+    const double pvalue = (_partition == PARTITION_X ? point.x() : point.y());
+    const bool search_left_first = (pvalue < _partition_position);
+    const AABoxKDTree2dNode* first_subnode =
+      search_left_first ? _left_subnode.get() : _right_subnode.get();
+    const AABoxKDTree2dNode* second_subnode =
+      search_left_first ? _right_subnode.get() : _left_subnode.get();
+    if (first_subnode != nullptr) {
+      first_subnode->get_k_nearest_objects_internal(point, k, heap);
+    }
+
+    if (search_left_first) {
+      for (int i = 0; i < _num_objects; ++i) {
+        const double bound = _objects_sorted_by_min_bound[i];
+        if (bound > pvalue &&
+            square(bound - pvalue) > kth_distance_square(k, *heap)) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
+          break;
+        }
+        ObjectPtr object = _objects_sorted_by_min[i];
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+        push_to_heap(k, object->distance_square_to(point), object, heap);
+      }
+    } else {
+      for (int i = 0; i < _num_objects; ++i) {
+        const double bound = _objects_sorted_by_max_bound[i];
+        if (bound < pvalue &&
+            square(bound - pvalue) > kth_distance_square(k, *heap)) {
+          MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().early_breaks++);
+          break;
+        }
+        ObjectPtr object = objects_sorted_by_max_[i];
+        MYMATH_KDTREE_STAT(aabox_kdtree_query_stats().objects_tested++);
+        push_to_heap(k, object->distance_square_to(point), object, heap);
+      }
+    }
+    if (second_subnode != nullptr) {
+      second_subnode->get_k_nearest_objects_internal(point, k, heap);
+    }
+  }
+
+  template <typename T>
+  double min_bound(const AABox2<T>& box) const {
+    return _partition == PARTITION_X ? box.min_x() : box.min_y();
+  }
+
+  template <typename T>
+  double max_bound(const AABox2<T>& box) const {
+    return _partition == PARTITION_X ? box.max_x() : box.max_y();
+  }
+
+  template <typename T>
+  void merge_boundary(const AABox2<T>& box) {
+    _min_x = std::fmin(_min_x, box.min_x());
+    _max_x = std::fmax(_max_x, box.max_x());
+    _min_y = std::fmin(_min_y, box.min_y());
+    _max_y = std::fmax(_max_y, box.max_y());
+    _mid_x = (_min_x + _max_x) / 2.0;
+    _mid_y = (_min_y + _max_y) / 2.0;
+  }
+
+  // 子树的对象数量超过构建时的两倍或者不足一半时需要重建
+  bool needs_rebuild(const AABoxKDTreeParams& params) const {
+    const int leaf_size = std::max(1, params.max_leaf_size);
+    return _num_subtree_objects > 2 * _num_built_objects + leaf_size ||
+      (_num_built_objects > leaf_size &&
+       2 * _num_subtree_objects < _num_built_objects);
+  }
+
+  void rebuild(const std::vector<ObjectPtr>& objects,
+               const AABoxKDTreeParams& params) {
+    const int depth = _depth;
+    *this = AABoxKDTree2dNode<ObjectType>(objects, params, depth);
+  }
+
+  void collect_objects(std::vector<ObjectPtr>* const objects) const {
+    auto collector = [objects](ObjectPtr object) {
+      objects->push_back(object);
+      return true;
+    };
+    visit_all_objects(collector);
+  }
+
+  // 将对象按照切分轴的边界有序地插入当前节点
+  void insert_to_node(ObjectPtr object) {
+    const double min_value = min_bound(object->aabox());
+    const double max_value = max_bound(object->aabox());
+    const auto min_pos = std::upper_bound(_objects_sorted_by_min_bound.begin(),
+                                          _objects_sorted_by_min_bound.end(),
+                                          min_value) -
+                         _objects_sorted_by_min_bound.begin();
+    _objects_sorted_by_min_bound.insert(
+      _objects_sorted_by_min_bound.begin() + min_pos, min_value);
+    _objects_sorted_by_min.insert(_objects_sorted_by_min.begin() + min_pos,
+                                  object);
+    const auto max_pos = std::upper_bound(_objects_sorted_by_max_bound.begin(),
+                                          _objects_sorted_by_max_bound.end(),
+                                          max_value, std::greater<double>()) -
+                         _objects_sorted_by_max_bound.begin();
+    _objects_sorted_by_max_bound.insert(
+      _objects_sorted_by_max_bound.begin() + max_pos, max_value);
+    objects_sorted_by_max_.insert(objects_sorted_by_max_.begin() + max_pos,
+                                  object);
+    ++_num_objects;
+  }
+
+  // 从当前节点的对象列表中删除对象
+  bool remove_from_node(ObjectPtr object) {
+    const auto min_it = std::find(_objects_sorted_by_min.begin(),
+                                  _objects_sorted_by_min.end(), object);
+    if (min_it == _objects_sorted_by_min.end()) {
+      return false;
+    }
+    _objects_sorted_by_min_bound.erase(_objects_sorted_by_min_bound.begin() +
+                                       (min_it - _objects_sorted_by_min.begin()));
+    _objects_sorted_by_min.erase(min_it);
+    const auto max_it = std::find(objects_sorted_by_max_.begin(),
+                                  objects_sorted_by_max_.end(), object);
+    assert(max_it != objects_sorted_by_max_.end());
+    _objects_sorted_by_max_bound.erase(_objects_sorted_by_max_bound.begin() +
+                                       (max_it - objects_sorted_by_max_.begin()));
+    objects_sorted_by_max_.erase(max_it);
+    --_num_objects;
+    return true;
+  }
+
+  template <typename T>
+  bool remove_from_subnode(
+      std::unique_ptr<AABoxKDTree2dNode<ObjectType>>* const subnode,
+      ObjectPtr object, const AABox2<T>& aabox,
+      const AABoxKDTreeParams& params) {
+    if (!(*subnode)->remove(object, aabox, params)) {
+      return false;
+    }
+    if ((*subnode)->num_subtree_objects() == 0) {
+      subnode->reset();
+    }
+    return true;
+  }
+
+  void on_object_removed(const AABoxKDTreeParams& params) {
+    --_num_subtree_objects;
+    if (_num_subtree_objects > 0 && needs_rebuild(params)) {
+      std::vector<ObjectPtr> objects;
+      objects.reserve(_num_subtree_objects);
+      collect_objects(&objects);
+      rebuild(objects, params);
+    }
+  }
+
+  void compute_boundary(ObjectPtr* const begin, ObjectPtr* const end) {
     _min_x = std::numeric_limits<double>::infinity();
     _min_y = std::numeric_limits<double>::infinity();
     _max_x = -std::numeric_limits<double>::infinity();
     _max_y = -std::numeric_limits<double>::infinity();
-    for (ObjectPtr object : objects) {
+    for (ObjectPtr* it = begin; it != end; ++it) {
+      ObjectPtr object = *it;
       _min_x = std::fmin(_min_x, object->aabox().min_x());
       _max_x = std::fmax(_max_x, object->aabox().max_x());
       _min_y = std::fmin(_min_y, object->aabox().min_y());
@@ -288,44 +1109,28 @@ private:
     // the provided object box size is infinity
   }
 
-  void compute_partition() {
-    if (_max_x - _min_x >= _max_y - _min_y) {
-      _partition = PARTITION_X;
-      _partition_position = (_min_x + _max_x) / 2.0;
-    } else {
-      _partition = PARTITION_Y;
-      _partition_position = (_min_y + _max_y) / 2.0;
-    }
-  }
-
-  void partition_objects(const std::vector<ObjectPtr>& objects,
-                         std::vector<ObjectPtr>* const left_subnode_objects,
-                         std::vector<ObjectPtr>* const right_subnode_objects) {
-    left_subnode_objects->clear();
-    right_subnode_objects->clear();
-    std::vector<ObjectPtr> other_objects;
-    if (_partition == PARTITION_X) {
-      for (ObjectPtr object : objects) {
-        if (object->aabox().max_x() <= _partition_position) {
-          left_subnode_objects->push_back(object);
-        } else if (object->aabox().min_x() >= _partition_position) {
-          right_subnode_objects->push_back(object);
-        } else {
-          other_objects.push_back(object);
-        }
-      }
-    } else {
-      for (ObjectPtr object : objects) {
-        if (object->aabox().max_y() <= _partition_position) {
-          left_subnode_objects->push_back(object);
-        } else if (object->aabox().min_y() >= _partition_position) {
-          right_subnode_objects->push_back(object);
-        } else {
-          other_objects.push_back(object);
-        }
-      }
-    }
-    init_objects(other_objects);
+  void compute_partition(ObjectPtr* const begin, ObjectPtr* const end,
+                         const AABoxKDTreeParams& params) {
+    bool partition_by_x = true;
+    compute_kdtree_partition(
+      begin, end, [](ObjectPtr object) -> decltype(auto) {
+        return object->aabox();
+      },
+      _min_x, _max_x, _min_y, _max_y, params.split_strategy,
+      &partition_by_x, &_partition_position);
+    _partition = partition_by_x ? PARTITION_X : PARTITION_Y;
+  }
+
+  // 原地切分为 [左子节点 | 跨越切分线的对象 | 右子节点]
+  void partition_objects(ObjectPtr* const begin, ObjectPtr* const end,
+                         ObjectPtr** const left_end,
+                         ObjectPtr** const right_begin) const {
+    *left_end = std::partition(begin, end, [this](ObjectPtr object) {
+      return max_bound(object->aabox()) <= _partition_position;
+    });
+    *right_begin = std::partition(*left_end, end, [this](ObjectPtr object) {
+      return min_bound(object->aabox()) < _partition_position;
+    });
   }
 
 private:
@@ -335,6 +1140,8 @@ private:
   std::vector<double> _objects_sorted_by_min_bound;
   std::vector<double> _objects_sorted_by_max_bound;
   int _depth = 0;
+  int _num_subtree_objects = 0;         // 子树中的对象数量
+  int _num_built_objects = 0;           // 子树构建时的对象数量
 
   // 边界
   double _min_x = 0.0;
@@ -362,7 +1169,7 @@ public:
   using ObjectPtr = const ObjectType *;
 
   AABoxKDTree2d(const std::vector<ObjectType>& objects,
-                const AABoxKDTreeParams& params) {
+                const AABoxKDTreeParams& params) : _params(params) {
     if (!objects.empty()) {
       std::vector<ObjectPtr> object_ptrs;
       for (const auto& object : objects) {
@@ -386,12 +1193,158 @@ public:
     return _root->get_objects(point, distance);
   }
 
+  // 获取所有在树上的对象，结果写入调用者提供的'result_objects'。
+  void get_objects(const Vec2d& point, const double distance,
+                   std::vector<ObjectPtr>* const result_objects) const {
+    assert(result_objects);
+    if (_root == nullptr) {
+      result_objects->clear();
+      return;
+    }
+    _root->get_objects(point, distance, result_objects);
+  }
+
+  // 对范围内的每一个对象调用'visitor'，'visitor'返回false时停止，被停止时返回false。
+  template <typename Visitor>
+  bool visit_objects(const Vec2d& point, const double distance,
+                     Visitor&& visitor) const {
+    if (_root == nullptr) {
+      return true;
+    }
+    return _root->visit_objects(point, distance,
+                                std::forward<Visitor>(visitor));
+  }
+
+  // 获取离点'point'最近的'k'个对象，按照距离由近到远排列。
+  std::vector<ObjectPtr> get_k_nearest_objects(const Vec2d& point,
+                                               const int k) const {
+    if (_root == nullptr) {
+      return {};
+    }
+    return _root->get_k_nearest_objects(point, k);
+  }
+
+  // 获取轴对齐盒子与'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const AABox2d& box) const {
+    return _root == nullptr ? std::vector<ObjectPtr>() : _root->get_objects(box);
+  }
+
+  // 获取轴对齐盒子与有向盒子'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const Box2d& box) const {
+    return _root == nullptr ? std::vector<ObjectPtr>() : _root->get_objects(box);
+  }
+
+  // 获取轴对齐盒子与线段'segment'相交的对象
+  std::vector<ObjectPtr> get_objects(const LineSegment2d& segment) const {
+    return _root == nullptr ? std::vector<ObjectPtr>()
+                            : _root->get_objects(segment);
+  }
+
+  // 对轴对齐盒子与'query'区域重叠的每一个对象调用'visitor'，被停止时返回false。
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects(const Query& query, Visitor&& visitor) const {
+    if (_root == nullptr) {
+      return true;
+    }
+    return _root->visit_overlapping_objects(query,
+                                            std::forward<Visitor>(visitor));
+  }
+
+  // 沿线段'segment'的射线检测，'hit'计算对象与线段的精确交点距离。
+  template <typename HitFunction>
+  ObjectPtr get_first_hit(const LineSegment2d& segment, const HitFunction& hit,
+                          double* const hit_distance = nullptr) const {
+    if (_root == nullptr) {
+      if (hit_distance != nullptr) {
+        *hit_distance = std::numeric_limits<double>::infinity();
+      }
+      return nullptr;
+    }
+    return _root->get_first_hit(segment, hit, hit_distance);
+  }
+
+  // 沿线段'segment'的射线检测，以对象的轴对齐盒子作为击中的判断。
+  ObjectPtr get_first_hit(const LineSegment2d& segment,
+                          double* const hit_distance = nullptr) const {
+    if (_root == nullptr) {
+      if (hit_distance != nullptr) {
+        *hit_distance = std::numeric_limits<double>::infinity();
+      }
+      return nullptr;
+    }
+    return _root->get_first_hit(segment, hit_distance);
+  }
+
   // 获取轴对齐盒子包含树里所有的对象
   AABox2d get_bounding_box() const {
     return _root == nullptr ? AABox2d() : _root->get_bounding_box();
   }
 
+  // 树的构建统计
+  AABoxKDTreeBuildStats get_build_stats() const {
+    AABoxKDTreeBuildStats stats;
+    if (_root != nullptr) {
+      _root->get_build_stats(&stats);
+    }
+    return stats;
+  }
+
+  // 树中对象的数量
+  int size() const {
+    return _root == nullptr ? 0 : _root->num_subtree_objects();
+  }
+
+  // 插入一个对象，对象由调用者持有并且必须比树的生命周期长。
+  void insert(ObjectPtr object) {
+    assert(object);
+    if (_root == nullptr) {
+      _root.reset(new AABoxKDTree2dNode<ObjectType>(
+        std::vector<ObjectPtr>(1, object), _params, 0));
+      return;
+    }
+    _root->insert(object, _params);
+  }
+
+  // 删除一个对象，对象的aabox()必须与插入(或者上一次update)时一致。
+  bool remove(ObjectPtr object) {
+    return remove(object, object->aabox());
+  }
+
+  // 对象的盒子从'old_aabox'变化到当前的aabox()后，更新对象在树中的位置。
+  template <typename T>
+  bool update(ObjectPtr object, const AABox2<T>& old_aabox) {
+    if (!remove(object, old_aabox)) {
+      return false;
+    }
+    insert(object);
+    return true;
+  }
+
+  // 删除对象后收紧所有节点的边界
+  void refit() {
+    if (_root != nullptr) {
+      _root->refit();
+    }
+  }
+
+private:
+  template <typename T>
+  bool remove(ObjectPtr object, const AABox2<T>& aabox) {
+    assert(object);
+    if (_root == nullptr) {
+      return false;
+    }
+    // 盒子与记录不一致时，回退到整棵树的查找
+    const bool removed = _root->remove(object, aabox, _params) ||
+                         _root->remove_anywhere(object, _params);
+    if (removed && _root->num_subtree_objects() == 0) {
+      _root.reset();
+    }
+    return removed;
+  }
+
 private:
+  AABoxKDTreeParams _params;
   std::unique_ptr<AABoxKDTree2dNode<ObjectType>> _root = nullptr;
 };
 
@@ -0,0 +1,113 @@
+#ifndef MYMATH_AABOXKDTREE2D_BATCH_HPP
+#define MYMATH_AABOXKDTREE2D_BATCH_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "vec2d.hpp"
+#include "aabox2d.hpp"
+#include "math_utils.hpp"
+#include "thread_pool.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 每个线程任务处理的查询点数量
+static constexpr int kBatchQueryGrainSize = 256;
+
+// 将16位整数的每一位之间插入一个0位
+inline uint32_t morton_spread_bits(uint32_t v) {
+  v &= 0x0000ffff;
+  v = (v | (v << 8)) & 0x00ff00ff;
+  v = (v | (v << 4)) & 0x0f0f0f0f;
+  v = (v | (v << 2)) & 0x33333333;
+  v = (v | (v << 1)) & 0x55555555;
+  return v;
+}
+
+// 计算点'point'在盒子'box'内的Morton(Z序)编码，每个轴量化为16位。
+inline uint32_t morton_code(const Vec2d& point, const AABox2d& box) {
+  const double kScale = 65535.0;
+  const double sx = box.length() > math_epsilon ?
+    (point.x() - box.min_x()) / box.length() : 0.0;
+  const double sy = box.width() > math_epsilon ?
+    (point.y() - box.min_y()) / box.width() : 0.0;
+  const uint32_t qx = static_cast<uint32_t>(clamp(sx, 0.0, 1.0) * kScale);
+  const uint32_t qy = static_cast<uint32_t>(clamp(sy, 0.0, 1.0) * kScale);
+  return morton_spread_bits(qx) | (morton_spread_bits(qy) << 1);
+}
+
+// 返回按照Morton编码排序后的查询点索引，空间上相邻的查询点在结果中也相邻。
+inline std::vector<int> morton_order(const std::vector<Vec2d>& points) {
+  std::vector<int> order(points.size());
+  if (points.empty()) {
+    return order;
+  }
+  const AABox2d box(points);
+  std::vector<std::pair<uint32_t, int>> codes;
+  codes.reserve(points.size());
+  for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+    codes.emplace_back(morton_code(points[i], box), i);
+  }
+  std::sort(codes.begin(), codes.end());
+  for (int i = 0; i < static_cast<int>(codes.size()); ++i) {
+    order[i] = codes[i].second;
+  }
+  return order;
+}
+
+/*
+ * 批量查询每一个点'points[i]'最近的对象，结果与'points'一一对应。
+ *
+ * 查询按照Morton顺序执行，使相邻的查询复用缓存中的树节点；
+ * 如果提供'pool'，排序后的查询被切分成连续的块在线程池中并行执行。
+ * 'KDTree'可以是AABoxKDTree2d或者FlatAABoxKDTree2d。
+ */
+template <class KDTree>
+std::vector<typename KDTree::ObjectPtr> batch_get_nearest_objects(
+    const KDTree& kdtree, const std::vector<Vec2d>& points,
+    ThreadPool* const pool = nullptr) {
+  std::vector<typename KDTree::ObjectPtr> results(points.size(), nullptr);
+  const std::vector<int> order = morton_order(points);
+  auto query = [&](const int begin, const int end) {
+    for (int i = begin; i < end; ++i) {
+      const int index = order[i];
+      results[index] = kdtree.get_nearest_object(points[index]);
+    }
+  };
+  const int num_points = static_cast<int>(points.size());
+  if (pool == nullptr) {
+    query(0, num_points);
+  } else {
+    pool->parallel_for(0, num_points, kBatchQueryGrainSize, query);
+  }
+  return results;
+}
+
+// 批量查询到每一个点'points[i]'距离在'distance'之内的对象，结果与'points'一一对应。
+template <class KDTree>
+std::vector<std::vector<typename KDTree::ObjectPtr>> batch_get_objects(
+    const KDTree& kdtree, const std::vector<Vec2d>& points,
+    const double distance, ThreadPool* const pool = nullptr) {
+  std::vector<std::vector<typename KDTree::ObjectPtr>> results(points.size());
+  const std::vector<int> order = morton_order(points);
+  auto query = [&](const int begin, const int end) {
+    for (int i = begin; i < end; ++i) {
+      const int index = order[i];
+      results[index] = kdtree.get_objects(points[index], distance);
+    }
+  };
+  const int num_points = static_cast<int>(points.size());
+  if (pool == nullptr) {
+    query(0, num_points);
+  } else {
+    pool->parallel_for(0, num_points, kBatchQueryGrainSize, query);
+  }
+  return results;
+}
+
+}}
+
+#endif
@@ -0,0 +1,627 @@
+#ifndef MYMATH_AABOXKDTREE2D_FLAT_HPP
+#define MYMATH_AABOXKDTREE2D_FLAT_HPP
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "math_utils.hpp"
+#include "aabox2d.hpp"
+#include "aaboxkdtree2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 扁平化的kdtree节点
+ *
+ * 所有节点按照先序存放在一个连续的数组中，子节点使用索引表示(-1表示没有子节点)。
+ * 节点上的对象存放在树的SoA数组中 [objects_begin, objects_begin + num_objects)。
+ */
+struct FlatAABoxKDTreeNode {
+  double min_x = 0.0;
+  double max_x = 0.0;
+  double min_y = 0.0;
+  double max_y = 0.0;
+  double partition_position = 0.0;
+  int32_t left_subnode = -1;
+  int32_t right_subnode = -1;
+  int32_t objects_begin = 0;
+  int32_t num_objects = 0;
+  int32_t partition = 0;                // 0 : PARTITION_X, 1 : PARTITION_Y
+  int32_t depth = 0;
+};
+
+// 快照文件头，文件中各个数组的位置由FlatAABoxKDTreeFileLayout计算
+struct FlatAABoxKDTreeFileHeader {
+  uint64_t magic = 0x3245455254444b4dULL;   // "MKDTREE2"，同时用于检查字节序
+  uint32_t version = 1;
+  uint32_t node_size = sizeof(FlatAABoxKDTreeNode);
+  uint64_t num_nodes = 0;
+  uint64_t num_objects = 0;
+  uint64_t num_entries = 0;               // 所有节点上对象数量的总和
+};
+
+// 快照文件中各个数组的偏移，每个数组按照8字节对齐
+struct FlatAABoxKDTreeFileLayout {
+  explicit FlatAABoxKDTreeFileLayout(const FlatAABoxKDTreeFileHeader& header) {
+    nodes_offset = align(sizeof(FlatAABoxKDTreeFileHeader));
+    min_bounds_offset =
+      align(nodes_offset + header.num_nodes * sizeof(FlatAABoxKDTreeNode));
+    max_bounds_offset =
+      align(min_bounds_offset + header.num_entries * sizeof(double));
+    min_objects_offset =
+      align(max_bounds_offset + header.num_entries * sizeof(double));
+    max_objects_offset =
+      align(min_objects_offset + header.num_entries * sizeof(int32_t));
+    file_size = max_objects_offset + header.num_entries * sizeof(int32_t);
+  }
+
+  static uint64_t align(const uint64_t offset) { return (offset + 7) & ~7ULL; }
+
+  uint64_t nodes_offset = 0;
+  uint64_t min_bounds_offset = 0;
+  uint64_t max_bounds_offset = 0;
+  uint64_t min_objects_offset = 0;
+  uint64_t max_objects_offset = 0;
+  uint64_t file_size = 0;
+};
+
+// 只读映射的文件，析构时解除映射
+class MappedFile {
+public:
+  // 映射文件'path'，失败时返回nullptr
+  static std::shared_ptr<MappedFile> open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+      ::close(fd);
+      return nullptr;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      return nullptr;
+    }
+    return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+  }
+
+  ~MappedFile() { ::munmap(_data, _size); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const void* data() const { return _data; }
+  size_t size() const { return _size; }
+
+private:
+  MappedFile(void* data, const size_t size) : _data(data), _size(size) {}
+
+  void* _data = nullptr;
+  size_t _size = 0;
+};
+
+/*
+ * 扁平化的轴对齐kdtree
+ *
+ * 与AABoxKDTree2d使用相同的切分规则与查询接口，但是所有节点存放在一个连续数组里，
+ * 每个节点的对象边界与对象索引分别存放在连续的数组中，查询时避免在堆上跳转。
+ * 对象本身不被复制，'objects'必须比树的生命周期长。
+ * 构建好的树可以保存为快照文件，之后通过mmap直接在文件上查询。
+ */
+template <class ObjectType>
+class FlatAABoxKDTree2d {
+public:
+  using ObjectPtr = const ObjectType *;
+
+  FlatAABoxKDTree2d(const std::vector<ObjectType>& objects,
+                    const AABoxKDTreeParams& params) {
+    if (objects.empty()) {
+      return;
+    }
+    _objects = objects.data();
+    _num_objects = static_cast<int>(objects.size());
+
+    std::vector<int32_t> indices(_num_objects);
+    for (int i = 0; i < _num_objects; ++i) {
+      indices[i] = i;
+    }
+    _min_object_storage.reserve(_num_objects);
+    _min_bound_storage.reserve(_num_objects);
+    _max_object_storage.reserve(_num_objects);
+    _max_bound_storage.reserve(_num_objects);
+    build(&indices, 0, _num_objects, params, 0);
+    attach_storage();
+  }
+
+  // 查询使用的指针指向自身的存储(或者映射的文件)，不能复制，只能移动。
+  FlatAABoxKDTree2d(const FlatAABoxKDTree2d&) = delete;
+  FlatAABoxKDTree2d& operator=(const FlatAABoxKDTree2d&) = delete;
+  FlatAABoxKDTree2d(FlatAABoxKDTree2d&&) = default;
+  FlatAABoxKDTree2d& operator=(FlatAABoxKDTree2d&&) = default;
+
+  /*
+   * 将树保存为二进制快照文件：文件头、节点数组与四个对象数组按照内存布局直接写入。
+   * 对象本身不被保存，加载时需要提供与构建时顺序相同的对象数组。
+   */
+  bool save(const std::string& path) const {
+    FlatAABoxKDTreeFileHeader header;
+    header.num_nodes = _num_nodes;
+    header.num_objects = _num_objects;
+    header.num_entries = _num_entries;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    const FlatAABoxKDTreeFileLayout layout(header);
+    auto write_section = [&file](const uint64_t offset, const void* data,
+                                 const uint64_t size) {
+      const uint64_t position = static_cast<uint64_t>(file.tellp());
+      assert(position <= offset);
+      const char padding[8] = {0};
+      file.write(padding, static_cast<std::streamsize>(offset - position));
+      file.write(static_cast<const char*>(data),
+                 static_cast<std::streamsize>(size));
+    };
+    write_section(0, &header, sizeof(header));
+    write_section(layout.nodes_offset, _nodes,
+                  sizeof(FlatAABoxKDTreeNode) * _num_nodes);
+    write_section(layout.min_bounds_offset, _min_bounds,
+                  sizeof(double) * _num_entries);
+    write_section(layout.max_bounds_offset, _max_bounds,
+                  sizeof(double) * _num_entries);
+    write_section(layout.min_objects_offset, _min_objects,
+                  sizeof(int32_t) * _num_entries);
+    write_section(layout.max_objects_offset, _max_objects,
+                  sizeof(int32_t) * _num_entries);
+    return static_cast<bool>(file);
+  }
+
+  /*
+   * 使用mmap加载快照文件，直接在映射的内存上查询，不重新构建。
+   * 多个进程映射同一个文件时共享物理内存。
+   * 'objects'必须与保存快照时构建树的对象数组一致(数量与顺序)，并且比树的生命周期长。
+   * 文件无效时返回nullptr。
+   */
+  static std::unique_ptr<FlatAABoxKDTree2d> load_mapped(
+      const std::string& path, const std::vector<ObjectType>& objects) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (file == nullptr || file->size() < sizeof(FlatAABoxKDTreeFileHeader)) {
+      return nullptr;
+    }
+    const char* data = static_cast<const char*>(file->data());
+    const FlatAABoxKDTreeFileHeader& header =
+      *reinterpret_cast<const FlatAABoxKDTreeFileHeader*>(data);
+    const FlatAABoxKDTreeFileHeader expected_header;
+    if (header.magic != expected_header.magic ||
+        header.version != expected_header.version ||
+        header.node_size != expected_header.node_size ||
+        header.num_objects != objects.size() ||
+        header.num_entries != objects.size() ||
+        (header.num_nodes == 0) != objects.empty()) {
+      return nullptr;
+    }
+    // 计算偏移之前限制数量，损坏的文件头不能使偏移溢出或者数量在转换为int时截断
+    const uint64_t max_count = static_cast<uint64_t>(std::numeric_limits<int>::max());
+    if (header.num_nodes >
+          std::min<uint64_t>(max_count, file->size() / sizeof(FlatAABoxKDTreeNode)) ||
+        header.num_entries > std::min<uint64_t>(max_count, file->size() / sizeof(double)) ||
+        header.num_objects > max_count) {
+      return nullptr;
+    }
+    const FlatAABoxKDTreeFileLayout layout(header);
+    if (file->size() < layout.file_size) {
+      return nullptr;
+    }
+
+    std::unique_ptr<FlatAABoxKDTree2d> tree(new FlatAABoxKDTree2d());
+    tree->_objects = objects.data();
+    tree->_num_objects = static_cast<int>(header.num_objects);
+    tree->_num_nodes = static_cast<int>(header.num_nodes);
+    tree->_num_entries = static_cast<int>(header.num_entries);
+    tree->_nodes = reinterpret_cast<const FlatAABoxKDTreeNode*>(
+      data + layout.nodes_offset);
+    tree->_min_bounds =
+      reinterpret_cast<const double*>(data + layout.min_bounds_offset);
+    tree->_max_bounds =
+      reinterpret_cast<const double*>(data + layout.max_bounds_offset);
+    tree->_min_objects =
+      reinterpret_cast<const int32_t*>(data + layout.min_objects_offset);
+    tree->_max_objects =
+      reinterpret_cast<const int32_t*>(data + layout.max_objects_offset);
+    tree->_mapped_file = std::move(file);
+    if (!tree->is_valid()) {
+      return nullptr;
+    }
+    return tree;
+  }
+
+  // 获取离点'point'最近的对象
+  ObjectPtr get_nearest_object(const Vec2d& point) const {
+    if (_num_nodes == 0) {
+      return nullptr;
+    }
+    int nearest_object = -1;
+    double min_distance_sqr = std::numeric_limits<double>::infinity();
+    get_nearest_object_internal(0, point, &min_distance_sqr, &nearest_object);
+    return nearest_object < 0 ? nullptr : _objects + nearest_object;
+  }
+
+  // 搜索以'point'为中心，'distance'为距离的范围，获取到点距离之内的对象。
+  std::vector<ObjectPtr> get_objects(const Vec2d& point,
+                                     const double distance) const {
+    std::vector<ObjectPtr> result_objects;
+    if (_num_nodes > 0) {
+      get_objects_internal(0, point, distance, square(distance),
+                           &result_objects);
+    }
+    return result_objects;
+  }
+
+  // 获取轴对齐盒子包含树里所有的对象
+  AABox2d get_bounding_box() const {
+    if (_num_nodes == 0) {
+      return AABox2d();
+    }
+    const FlatAABoxKDTreeNode& root = _nodes[0];
+    return AABox2d({root.min_x, root.min_y}, {root.max_x, root.max_y});
+  }
+
+  const FlatAABoxKDTreeNode* nodes() const { return _nodes; }
+  int num_nodes() const { return _num_nodes; }
+  int num_objects() const { return _num_objects; }
+  // 是否直接查询映射的快照文件
+  bool is_mapped() const { return _mapped_file != nullptr; }
+
+private:
+  FlatAABoxKDTree2d() = default;
+
+  // 查询使用的指针指向自身的存储
+  void attach_storage() {
+    _num_nodes = static_cast<int>(_node_storage.size());
+    _num_entries = static_cast<int>(_min_object_storage.size());
+    _nodes = _node_storage.data();
+    _min_bounds = _min_bound_storage.data();
+    _max_bounds = _max_bound_storage.data();
+    _min_objects = _min_object_storage.data();
+    _max_objects = _max_object_storage.data();
+  }
+
+  // 检查节点与对象索引没有越界，防止损坏的快照文件造成非法访问
+  bool is_valid() const {
+    for (int i = 0; i < _num_nodes; ++i) {
+      const FlatAABoxKDTreeNode& node = _nodes[i];
+      if (node.left_subnode >= _num_nodes || node.right_subnode >= _num_nodes ||
+          (node.left_subnode >= 0 && node.left_subnode <= i) ||
+          (node.right_subnode >= 0 && node.right_subnode <= i) ||
+          node.objects_begin < 0 || node.num_objects < 0 ||
+          node.objects_begin > _num_entries - node.num_objects ||
+          (node.partition != 0 && node.partition != 1)) {
+        return false;
+      }
+    }
+    for (int i = 0; i < _num_entries; ++i) {
+      if (_min_objects[i] < 0 || _min_objects[i] >= _num_objects ||
+          _max_objects[i] < 0 || _max_objects[i] >= _num_objects) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static double lower_distance_square_to_point(const FlatAABoxKDTreeNode& node,
+                                               const Vec2d& point) {
+    double dx = 0.0;
+    if (point.x() < node.min_x) {
+      dx = node.min_x - point.x();
+    } else if (point.x() > node.max_x) {
+      dx = point.x() - node.max_x;
+    }
+    double dy = 0.0;
+    if (point.y() < node.min_y) {
+      dy = node.min_y - point.y();
+    } else if (point.y() > node.max_y) {
+      dy = point.y() - node.max_y;
+    }
+    return dx * dx + dy * dy;
+  }
+
+  static double upper_distance_square_to_point(const FlatAABoxKDTreeNode& node,
+                                               const Vec2d& point) {
+    const double mid_x = (node.min_x + node.max_x) / 2.0;
+    const double mid_y = (node.min_y + node.max_y) / 2.0;
+    const double dx =
+      (point.x() > mid_x ? (point.x() - node.min_x) : (point.x() - node.max_x));
+    const double dy =
+      (point.y() > mid_y ? (point.y() - node.min_y) : (point.y() - node.max_y));
+    return dx * dx + dy * dy;
+  }
+
+  // 返回新节点的索引
+  int build(std::vector<int32_t>* const indices, const int begin, const int end,
+            const AABoxKDTreeParams& params, const int depth) {
+    assert(begin < end);
+    const int node_index = static_cast<int>(_node_storage.size());
+    _node_storage.emplace_back();
+    FlatAABoxKDTreeNode node;
+    node.depth = depth;
+
+    // 计算边界
+    node.min_x = std::numeric_limits<double>::infinity();
+    node.min_y = std::numeric_limits<double>::infinity();
+    node.max_x = -std::numeric_limits<double>::infinity();
+    node.max_y = -std::numeric_limits<double>::infinity();
+    for (int i = begin; i < end; ++i) {
+      const auto& box = _objects[(*indices)[i]].aabox();
+      node.min_x = std::fmin(node.min_x, box.min_x());
+      node.max_x = std::fmax(node.max_x, box.max_x());
+      node.min_y = std::fmin(node.min_y, box.min_y());
+      node.max_y = std::fmax(node.max_y, box.max_y());
+    }
+    assert(!std::isinf(node.max_x) && !std::isinf(node.max_y) &&
+           !std::isinf(node.min_x) && !std::isinf(node.min_y));
+
+    // 计算切分
+    auto first = indices->begin() + begin;
+    auto last = indices->begin() + end;
+    bool by_x = true;
+    compute_kdtree_partition(
+      first, last, [this](const int i) -> decltype(auto) {
+        return _objects[i].aabox();
+      },
+      node.min_x, node.max_x, node.min_y, node.max_y, params.split_strategy,
+      &by_x, &node.partition_position);
+    node.partition = by_x ? 0 : 1;
+
+    int left_end = end;
+    int right_begin = begin;
+    if (split_to_subnodes(node, end - begin, params)) {
+      // 原地切分为 [左子节点 | 跨越切分线的对象 | 右子节点]
+      const double position = node.partition_position;
+      auto mid1 = std::partition(first, last, [&](const int i) {
+        const auto& box = _objects[i].aabox();
+        return (by_x ? box.max_x() : box.max_y()) <= position;
+      });
+      auto mid2 = std::partition(mid1, last, [&](const int i) {
+        const auto& box = _objects[i].aabox();
+        return (by_x ? box.min_x() : box.min_y()) < position;
+      });
+      left_end = static_cast<int>(mid1 - indices->begin());
+      right_begin = static_cast<int>(mid2 - indices->begin());
+    }
+    // 所有对象都落在同一侧时无法继续切分
+    if (left_end < end && right_begin > begin) {
+      init_objects(&node, *indices, left_end, right_begin);
+
+      if (begin < left_end) {
+        node.left_subnode = build(indices, begin, left_end, params, depth + 1);
+      }
+      if (right_begin < end) {
+        node.right_subnode = build(indices, right_begin, end, params, depth + 1);
+      }
+    } else {
+      init_objects(&node, *indices, begin, end);
+    }
+    _node_storage[node_index] = node;
+    return node_index;
+  }
+
+  bool split_to_subnodes(const FlatAABoxKDTreeNode& node, const int num_objects,
+                         const AABoxKDTreeParams& params) const {
+    if (params.max_depth >= 0 && node.depth >= params.max_depth) {
+      return false;
+    }
+    if (num_objects <= std::max(1, params.max_leaf_size)) {
+      return false;
+    }
+    if (params.max_leaf_dimension >= 0.0 &&
+        std::max(node.max_x - node.min_x, node.max_y - node.min_y) <=
+          params.max_leaf_dimension) {
+      return false;
+    }
+    return true;
+  }
+
+  double min_bound(const int object, const int partition) const {
+    const auto& box = _objects[object].aabox();
+    return partition == 0 ? box.min_x() : box.min_y();
+  }
+
+  double max_bound(const int object, const int partition) const {
+    const auto& box = _objects[object].aabox();
+    return partition == 0 ? box.max_x() : box.max_y();
+  }
+
+  void init_objects(FlatAABoxKDTreeNode* const node,
+                    const std::vector<int32_t>& indices,
+                    const int begin, const int end) {
+    const int partition = node->partition;
+    node->objects_begin = static_cast<int>(_min_object_storage.size());
+    node->num_objects = end - begin;
+
+    std::vector<int32_t> sorted_by_min(indices.begin() + begin,
+                                   indices.begin() + end);
+    std::vector<int> sorted_by_max = sorted_by_min;
+    std::sort(sorted_by_min.begin(), sorted_by_min.end(),
+              [&](const int obj1, const int obj2) {
+                return min_bound(obj1, partition) < min_bound(obj2, partition);
+              });
+    std::sort(sorted_by_max.begin(), sorted_by_max.end(),
+              [&](const int obj1, const int obj2) {
+                return max_bound(obj1, partition) > max_bound(obj2, partition);
+              });
+    for (const int object : sorted_by_min) {
+      _min_object_storage.push_back(object);
+      _min_bound_storage.push_back(min_bound(object, partition));
+    }
+    for (const int object : sorted_by_max) {
+      _max_object_storage.push_back(object);
+      _max_bound_storage.push_back(max_bound(object, partition));
+    }
+  }
+
+  void get_all_objects(const int node_index,
+                       std::vector<ObjectPtr>* const result_objects) const {
+    const FlatAABoxKDTreeNode& node = _nodes[node_index];
+    for (int i = 0; i < node.num_objects; ++i) {
+      result_objects->push_back(_objects + _min_objects[node.objects_begin + i]);
+    }
+    if (node.left_subnode >= 0) {
+      get_all_objects(node.left_subnode, result_objects);
+    }
+    if (node.right_subnode >= 0) {
+      get_all_objects(node.right_subnode, result_objects);
+    }
+  }
+
+  void get_objects_internal(const int node_index, const Vec2d& point,
+                            const double distance, const double distance_sqr,
+                            std::vector<ObjectPtr>* const result_objects) const {
+    const FlatAABoxKDTreeNode& node = _nodes[node_index];
+    if (lower_distance_square_to_point(node, point) > distance_sqr) {
+      return;
+    }
+    if (upper_distance_square_to_point(node, point) <= distance_sqr) {
+      get_all_objects(node_index, result_objects);
+      return;
+    }
+    const double pvalue = (node.partition == 0 ? point.x() : point.y());
+    const int begin = node.objects_begin;
+    const int end = node.objects_begin + node.num_objects;
+    if (pvalue < node.partition_position) {
+      const double limit = pvalue + distance;
+      for (int i = begin; i < end; ++i) {
+        if (_min_bounds[i] > limit) {
+          break;
+        }
+        ObjectPtr object = _objects + _min_objects[i];
+        if (object->distance_square_to(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    } else {
+      const double limit = pvalue - distance;
+      for (int i = begin; i < end; ++i) {
+        if (_max_bounds[i] < limit) {
+          break;
+        }
+        ObjectPtr object = _objects + _max_objects[i];
+        if (object->distance_square_to(point) <= distance_sqr) {
+          result_objects->push_back(object);
+        }
+      }
+    }
+    if (node.left_subnode >= 0) {
+      get_objects_internal(node.left_subnode, point, distance, distance_sqr,
+                           result_objects);
+    }
+    if (node.right_subnode >= 0) {
+      get_objects_internal(node.right_subnode, point, distance, distance_sqr,
+                           result_objects);
+    }
+  }
+
+  void get_nearest_object_internal(const int node_index, const Vec2d& point,
+                                   double* const min_distance_sqr,
+                                   int* const nearest_object) const {
+    const FlatAABoxKDTreeNode& node = _nodes[node_index];
+    if (lower_distance_square_to_point(node, point) >=
+        *min_distance_sqr - math_epsilon) {
+      return;
+    }
+    const double pvalue = (node.partition == 0 ? point.x() : point.y());
+    const bool search_left_first = (pvalue < node.partition_position);
+    const int first_subnode =
+      search_left_first ? node.left_subnode : node.right_subnode;
+    const int second_subnode =
+      search_left_first ? node.right_subnode : node.left_subnode;
+    if (first_subnode >= 0) {
+      get_nearest_object_internal(first_subnode, point, min_distance_sqr,
+                                  nearest_object);
+    }
+    if (*min_distance_sqr <= math_epsilon) {
+      return;
+    }
+
+    const int begin = node.objects_begin;
+    const int end = node.objects_begin + node.num_objects;
+    if (search_left_first) {
+      for (int i = begin; i < end; ++i) {
+        const double bound = _min_bounds[i];
+        if (bound > pvalue && square(bound - pvalue) > *min_distance_sqr) {
+          break;
+        }
+        const int object = _min_objects[i];
+        const double distance_sqr = _objects[object].distance_square_to(point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest_object = object;
+        }
+      }
+    } else {
+      for (int i = begin; i < end; ++i) {
+        const double bound = _max_bounds[i];
+        if (bound < pvalue && square(bound - pvalue) > *min_distance_sqr) {
+          break;
+        }
+        const int object = _max_objects[i];
+        const double distance_sqr = _objects[object].distance_square_to(point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest_object = object;
+        }
+      }
+    }
+    if (*min_distance_sqr <= math_epsilon) {
+      return;
+    }
+    if (second_subnode >= 0) {
+      get_nearest_object_internal(second_subnode, point, min_distance_sqr,
+                                  nearest_object);
+    }
+  }
+
+private:
+  const ObjectType* _objects = nullptr;
+  int _num_objects = 0;
+  int _num_nodes = 0;
+  int _num_entries = 0;
+
+  // 查询使用的数组，指向下面的存储或者映射的快照文件
+  // 按照先序存放的节点
+  const FlatAABoxKDTreeNode* _nodes = nullptr;
+  // 每个节点的对象，按照切分轴的最小边界升序排列
+  const int32_t* _min_objects = nullptr;
+  const double* _min_bounds = nullptr;
+  // 每个节点的对象，按照切分轴的最大边界降序排列
+  const int32_t* _max_objects = nullptr;
+  const double* _max_bounds = nullptr;
+
+  // 构建时持有的存储
+  std::vector<FlatAABoxKDTreeNode> _node_storage;
+  std::vector<int32_t> _min_object_storage;
+  std::vector<double> _min_bound_storage;
+  std::vector<int32_t> _max_object_storage;
+  std::vector<double> _max_bound_storage;
+
+  // 加载快照时映射的文件
+  std::shared_ptr<MappedFile> _mapped_file;
+};
+
+}}
+
+#endif
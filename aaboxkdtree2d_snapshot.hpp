@@ -0,0 +1,41 @@
+#ifndef MYMATH_AABOXKDTREE2D_SNAPSHOT_HPP
+#define MYMATH_AABOXKDTREE2D_SNAPSHOT_HPP
+
+#include <vector>
+#include <utility>
+
+#include "aaboxkdtree2d.hpp"
+#include "snapshot_holder.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * kdtree的一个不可变版本，同时持有对象与建立在对象上的树，
+ * 保证树中的对象指针与树的生命周期一致。
+ */
+template <class ObjectType>
+struct AABoxKDTree2dSnapshot {
+  AABoxKDTree2dSnapshot(std::vector<ObjectType> objects_,
+                        const AABoxKDTreeParams& params)
+      : objects(std::move(objects_)), kdtree(objects, params) {}
+
+  AABoxKDTree2dSnapshot(const AABoxKDTree2dSnapshot&) = delete;
+  AABoxKDTree2dSnapshot& operator=(const AABoxKDTree2dSnapshot&) = delete;
+
+  const std::vector<ObjectType> objects;
+  const AABoxKDTree2d<ObjectType> kdtree;
+};
+
+/*
+ * 并发读写的kdtree持有者
+ *
+ * 写线程在锁外构建新的AABoxKDTree2dSnapshot后publish()，
+ * 查询线程通过各自的Reader获取快照查询，重建期间读者不会被阻塞。
+ */
+template <class ObjectType>
+using AABoxKDTree2dHolder = SnapshotHolder<AABoxKDTree2dSnapshot<ObjectType>>;
+
+}}
+
+#endif
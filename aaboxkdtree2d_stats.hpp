@@ -0,0 +1,119 @@
+#ifndef MYMATH_AABOXKDTREE2D_STATS_HPP
+#define MYMATH_AABOXKDTREE2D_STATS_HPP
+
+#include "mymath_config.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#ifdef MYMATH_DBG
+#include <string>
+#include <sstream>
+#endif
+
+namespace mypilot {
+namespace mymath {
+
+// 查询统计中记录的最大深度，更深的节点计入最后一项
+static constexpr int kAABoxKDTreeStatsMaxDepth = 64;
+
+/*
+ * kdtree查询统计
+ *
+ * 只有定义了MYMATH_KDTREE_STATS时才会被收集，否则统计代码在编译时被完全去除。
+ * 每个线程有自己的统计(aabox_kdtree_query_stats())，在查询前reset()，
+ * 查询后读取即可得到单次或者一批查询的数据。
+ */
+struct AABoxKDTreeQueryStats {
+  int64_t num_queries = 0;              // 查询次数
+  int64_t nodes_visited = 0;            // 访问的节点数量
+  int64_t nodes_pruned = 0;             // 因为节点边界被剪枝的节点数量
+  int64_t objects_tested = 0;           // 计算过距离(或者重叠)的对象数量
+  int64_t early_breaks = 0;             // 有序的对象列表被提前终止扫描的次数
+  int64_t depth_histogram[kAABoxKDTreeStatsMaxDepth] = {0};  // 按照深度统计访问的节点
+
+  void reset() { *this = AABoxKDTreeQueryStats(); }
+
+  void on_node_visited(const int depth) {
+    ++nodes_visited;
+    ++depth_histogram[std::min(std::max(depth, 0),
+                               kAABoxKDTreeStatsMaxDepth - 1)];
+  }
+
+#ifdef MYMATH_DBG
+  std::string str() const {
+    std::ostringstream ss;
+    ss << "kdtree query stats ( queries = " << num_queries
+       << "  visited = " << nodes_visited
+       << "  pruned = " << nodes_pruned
+       << "  tested = " << objects_tested
+       << "  breaks = " << early_breaks << "  depths = [";
+    int max_depth = kAABoxKDTreeStatsMaxDepth - 1;
+    while (max_depth > 0 && depth_histogram[max_depth] == 0) {
+      --max_depth;
+    }
+    for (int i = 0; i <= max_depth; ++i) {
+      ss << (i == 0 ? "" : " ") << depth_histogram[i];
+    }
+    ss << "] )";
+    return ss.str();
+  }
+#endif
+};
+
+// 当前线程的kdtree查询统计
+inline AABoxKDTreeQueryStats& aabox_kdtree_query_stats() {
+  static thread_local AABoxKDTreeQueryStats stats;
+  return stats;
+}
+
+#ifdef MYMATH_KDTREE_STATS
+#define MYMATH_KDTREE_STAT(statement) statement
+#else
+#define MYMATH_KDTREE_STAT(statement)
+#endif
+
+// kdtree构建统计，通过遍历树计算，不依赖MYMATH_KDTREE_STATS
+struct AABoxKDTreeBuildStats {
+  int num_nodes = 0;                    // 节点数量
+  int num_leaves = 0;                   // 叶子节点数量
+  int num_objects = 0;                  // 对象数量
+  int num_interior_objects = 0;         // 存放在非叶子节点(跨越切分线)的对象数量
+  int max_depth = 0;                    // 最大深度
+  size_t memory_bytes = 0;              // 节点与对象列表占用的内存
+  std::vector<int> leaf_size_histogram; // leaf_size_histogram[n] : 包含n个对象的叶子数量
+
+  // 叶子节点的平均对象数量
+  double average_leaf_size() const {
+    return num_leaves == 0 ? 0.0 :
+      static_cast<double>(num_objects - num_interior_objects) / num_leaves;
+  }
+
+  void add_leaf(const int leaf_size) {
+    ++num_leaves;
+    if (static_cast<int>(leaf_size_histogram.size()) <= leaf_size) {
+      leaf_size_histogram.resize(leaf_size + 1, 0);
+    }
+    ++leaf_size_histogram[leaf_size];
+  }
+
+#ifdef MYMATH_DBG
+  std::string str() const {
+    std::ostringstream ss;
+    ss << "kdtree build stats ( nodes = " << num_nodes
+       << "  leaves = " << num_leaves
+       << "  objects = " << num_objects
+       << "  interior objects = " << num_interior_objects
+       << "  max depth = " << max_depth
+       << "  average leaf size = " << average_leaf_size()
+       << "  memory = " << memory_bytes << " bytes )";
+    return ss.str();
+  }
+#endif
+};
+
+}}
+
+#endif
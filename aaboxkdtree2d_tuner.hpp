@@ -0,0 +1,142 @@
+#ifndef MYMATH_AABOXKDTREE2D_TUNER_HPP
+#define MYMATH_AABOXKDTREE2D_TUNER_HPP
+
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+#include "vec2d.hpp"
+#include "aaboxkdtree2d.hpp"
+#include "aaboxkdtree2d_stats.hpp"
+
+#ifdef MYMATH_DBG
+#include <string>
+#include <sstream>
+#endif
+
+namespace mypilot {
+namespace mymath {
+
+// kdtree参数调优的候选集合与约束
+struct AABoxKDTreeTunerOptions {
+  std::vector<int> max_leaf_sizes = {1, 2, 4, 8, 16, 32, 64};
+  std::vector<int> max_depths = {-1};
+  std::vector<double> max_leaf_dimensions = {-1.0};
+  std::vector<AABoxKDTreeSplitStrategy> split_strategies = {
+    SPLIT_MIDPOINT, SPLIT_MEDIAN, SPLIT_SAH};
+  size_t memory_budget = 0;             // 树占用内存的上限(字节)，0表示不限制
+  double query_distance = -1.0;         // 大于0时同时计时距离'query_distance'内的范围查询
+  int num_repeats = 3;                  // 每个候选重复计时的次数，取最小值
+};
+
+// 一个候选参数的测量结果
+struct AABoxKDTreeTunerResult {
+  AABoxKDTreeParams params;
+  double query_time = 0.0;              // 平均每次查询的时间(秒)
+  double build_time = 0.0;              // 构建时间(秒)
+  size_t memory_bytes = 0;              // 树占用的内存
+  bool within_budget = true;            // 是否满足内存限制
+
+#ifdef MYMATH_DBG
+  std::string str() const {
+    std::ostringstream ss;
+    ss << "kdtree tuner result ( leaf size = " << params.max_leaf_size
+       << "  depth = " << params.max_depth
+       << "  leaf dimension = " << params.max_leaf_dimension
+       << "  strategy = " << params.split_strategy
+       << "  query = " << query_time * 1e9 << " ns"
+       << "  build = " << build_time * 1e3 << " ms"
+       << "  memory = " << memory_bytes << " bytes"
+       << (within_budget ? "" : "  over budget") << " )";
+    return ss.str();
+  }
+#endif
+};
+
+/*
+ * 按照查询负载为AABoxKDTree2d选择参数
+ *
+ * 对'options'中的每一组候选参数，用'objects'构建kdtree，
+ * 以'query_points'作为查询负载计时(最近对象查询，以及可选的范围查询)，
+ * 在满足内存限制的候选中选择平均查询时间最短的参数写入'best_params'。
+ *
+ * results : 可选，输出所有候选的测量结果
+ * 返回值 : 没有对象、没有查询点或者没有候选满足内存限制时返回false
+ */
+template <class ObjectType>
+bool tune_aabox_kdtree_params(
+    const std::vector<ObjectType>& objects,
+    const std::vector<Vec2d>& query_points,
+    const AABoxKDTreeTunerOptions& options,
+    AABoxKDTreeParams* const best_params,
+    std::vector<AABoxKDTreeTunerResult>* const results = nullptr) {
+  assert(best_params);
+  if (results != nullptr) {
+    results->clear();
+  }
+  if (objects.empty() || query_points.empty()) {
+    return false;
+  }
+  using Clock = std::chrono::steady_clock;
+  auto seconds_since = [](const Clock::time_point& start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+  const int num_repeats = std::max(1, options.num_repeats);
+  double best_time = std::numeric_limits<double>::infinity();
+  // 防止查询被编译器优化掉
+  volatile size_t sink = 0;
+
+  for (const AABoxKDTreeSplitStrategy strategy : options.split_strategies) {
+    for (const int max_depth : options.max_depths) {
+      for (const double max_leaf_dimension : options.max_leaf_dimensions) {
+        for (const int max_leaf_size : options.max_leaf_sizes) {
+          AABoxKDTreeTunerResult result;
+          result.params.split_strategy = strategy;
+          result.params.max_depth = max_depth;
+          result.params.max_leaf_dimension = max_leaf_dimension;
+          result.params.max_leaf_size = max_leaf_size;
+
+          const Clock::time_point build_start = Clock::now();
+          const AABoxKDTree2d<ObjectType> kdtree(objects, result.params);
+          result.build_time = seconds_since(build_start);
+          result.memory_bytes = kdtree.get_build_stats().memory_bytes;
+          result.within_budget = options.memory_budget == 0 ||
+                                 result.memory_bytes <= options.memory_budget;
+
+          if (result.within_budget) {
+            std::vector<const ObjectType*> buffer;
+            double min_time = std::numeric_limits<double>::infinity();
+            for (int r = 0; r < num_repeats; ++r) {
+              const Clock::time_point query_start = Clock::now();
+              for (const Vec2d& point : query_points) {
+                sink += reinterpret_cast<size_t>(kdtree.get_nearest_object(point));
+                if (options.query_distance > 0.0) {
+                  kdtree.get_objects(point, options.query_distance, &buffer);
+                  sink += buffer.size();
+                }
+              }
+              min_time = std::min(min_time, seconds_since(query_start));
+            }
+            result.query_time = min_time / query_points.size();
+            if (result.query_time < best_time) {
+              best_time = result.query_time;
+              *best_params = result.params;
+            }
+          }
+          if (results != nullptr) {
+            results->push_back(result);
+          }
+        }
+      }
+    }
+  }
+  return !std::isinf(best_time);
+}
+
+}}
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef MYMATH_AABOXRTREE2D_HPP
+#define MYMATH_AABOXRTREE2D_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <algorithm>
+
+#include "math_utils.hpp"
+#include "aabox2d.hpp"
+#include "box2d.hpp"
+#include "line_segment2d.hpp"
+#include "aaboxkdtree2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 每个节点的最大子节点(或者对象)数量，每个坐标的边界数组正好占用一个缓存行
+static constexpr int kAABoxRTreeNodeCapacity = 8;
+
+/*
+ * R树节点
+ *
+ * 子节点的边界按照坐标分别连续存放(SoA)，一次节点测试只读取四个缓存行，
+ * 整个节点填充为五个缓存行的大小，并且按照缓存行对齐，节点数组需要使用AABoxRTreeAllocator。
+ */
+struct alignas(64) AABoxRTreeNode {
+  double min_x[kAABoxRTreeNodeCapacity];
+  double max_x[kAABoxRTreeNodeCapacity];
+  double min_y[kAABoxRTreeNodeCapacity];
+  double max_y[kAABoxRTreeNodeCapacity];
+  int32_t children[kAABoxRTreeNodeCapacity];  // 子节点索引，叶子节点中为对象索引
+  int32_t num_children;
+  int32_t is_leaf;
+  char padding[24];
+};
+
+static_assert(sizeof(AABoxRTreeNode) == 5 * 64,
+              "AABoxRTreeNode should be 5 cache lines");
+static_assert(alignof(AABoxRTreeNode) == 64,
+              "AABoxRTreeNode should be aligned to a cache line");
+
+/*
+ * 按照'T'的对齐要求分配内存的分配器
+ * C++14的operator new只保证基本对齐，缓存行对齐的节点放在std::vector中需要使用它。
+ */
+template <typename T>
+struct AABoxRTreeAllocator {
+  using value_type = T;
+
+  AABoxRTreeAllocator() = default;
+  template <typename U>
+  AABoxRTreeAllocator(const AABoxRTreeAllocator<U>&) {}
+
+  T* allocate(const size_t n) {
+    void* data = nullptr;
+    if (::posix_memalign(&data, alignof(T), n * sizeof(T)) != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(data);
+  }
+
+  void deallocate(T* const data, const size_t) { ::free(data); }
+};
+
+template <typename T, typename U>
+bool operator==(const AABoxRTreeAllocator<T>&, const AABoxRTreeAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AABoxRTreeAllocator<T>&, const AABoxRTreeAllocator<U>&) {
+  return false;
+}
+
+/*
+ * 静态的轴对齐盒子R树
+ *
+ * 用Sort-Tile-Recursive(STR)方法自底向上一次性构建：
+ * 按照中心的x坐标把盒子切成竖条，每个竖条内按照中心的y坐标排序，
+ * 再依次打包成满的节点，逐层向上直到只剩一个根节点。
+ * 每个对象只属于一个叶子节点，相互重叠或者跨越切分线的对象不会堆积在内部节点，
+ * 适合车道多边形、人行横道等大量重叠的地图元素。
+ *
+ * 查询接口与AABoxKDTree2d相同，两者可以相互替换。
+ * 对象需要提供aabox()与distance_square_to(point)。
+ */
+template <class ObjectType>
+class AABoxRTree2d {
+public:
+  using ObjectPtr = const ObjectType *;
+
+  explicit AABoxRTree2d(const std::vector<ObjectType>& objects) {
+    std::vector<Entry> entries;
+    entries.reserve(objects.size());
+    _objects.reserve(objects.size());
+    for (const auto& object : objects) {
+      const AABox2d& box = object.aabox();
+      entries.push_back({box.min_x(), box.max_x(), box.min_y(), box.max_y(),
+                         static_cast<int>(_objects.size())});
+      _objects.push_back(&object);
+    }
+    build(&entries);
+  }
+
+  // 获取离点'point'最近的对象
+  ObjectPtr get_nearest_object(const Vec2d& point) const {
+    ObjectPtr nearest_object = nullptr;
+    double min_distance_sqr = std::numeric_limits<double>::infinity();
+    if (_root >= 0) {
+      get_nearest_object_internal(_root, point, &min_distance_sqr,
+                                  &nearest_object);
+    }
+    return nearest_object;
+  }
+
+  // 获取到点'point'的距离在'distance'之内的对象
+  std::vector<ObjectPtr> get_objects(const Vec2d& point,
+                                     const double distance) const {
+    std::vector<ObjectPtr> result_objects;
+    get_objects(point, distance, &result_objects);
+    return result_objects;
+  }
+
+  // 获取到点'point'的距离在'distance'之内的对象，结果写入调用者提供的'result_objects'。
+  void get_objects(const Vec2d& point, const double distance,
+                   std::vector<ObjectPtr>* const result_objects) const {
+    assert(result_objects);
+    result_objects->clear();
+    visit_objects(point, distance, [result_objects](ObjectPtr object) {
+      result_objects->push_back(object);
+      return true;
+    });
+  }
+
+  // 对范围内的每一个对象调用'visitor'，'visitor'返回false时停止，被停止时返回false。
+  template <typename Visitor>
+  bool visit_objects(const Vec2d& point, const double distance,
+                     Visitor&& visitor) const {
+    if (_root < 0 || distance < 0.0) {
+      return true;
+    }
+    return visit_objects_internal(_root, point, distance * distance, visitor);
+  }
+
+  // 获取离点'point'最近的'k'个对象，按照距离由近到远排列。
+  std::vector<ObjectPtr> get_k_nearest_objects(const Vec2d& point,
+                                               const int k) const {
+    std::vector<ObjectPtr> result_objects;
+    if (k <= 0 || _root < 0) {
+      return result_objects;
+    }
+    std::vector<std::pair<double, ObjectPtr>> heap;
+    heap.reserve(std::min(static_cast<size_t>(k), _objects.size()) + 1);
+    get_k_nearest_objects_internal(_root, point, k, &heap);
+    std::sort_heap(heap.begin(), heap.end());
+    result_objects.reserve(heap.size());
+    for (const auto& item : heap) {
+      result_objects.push_back(item.second);
+    }
+    return result_objects;
+  }
+
+  // 获取轴对齐盒子与'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const AABox2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与有向盒子'box'重叠的对象
+  std::vector<ObjectPtr> get_objects(const Box2d& box) const {
+    return get_overlapping_objects(AABoxKDTreeOrientedBoxQuery(box));
+  }
+
+  // 获取轴对齐盒子与线段'segment'相交的对象
+  std::vector<ObjectPtr> get_objects(const LineSegment2d& segment) const {
+    return get_overlapping_objects(AABoxKDTreeSegmentQuery(segment));
+  }
+
+  // 对轴对齐盒子与'query'区域重叠的每一个对象调用'visitor'，被停止时返回false。
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects(const Query& query, Visitor&& visitor) const {
+    if (_root < 0) {
+      return true;
+    }
+    return visit_overlapping_objects_internal(_root, query, visitor);
+  }
+
+  // 获取轴对齐盒子包含树里所有的对象
+  AABox2d get_bounding_box() const { return _bounding_box; }
+
+  // 树中对象的数量
+  int size() const { return static_cast<int>(_objects.size()); }
+
+  // 节点数量与树的高度
+  int num_nodes() const { return static_cast<int>(_nodes.size()); }
+  int height() const { return _height; }
+
+private:
+  // 构建时的一个盒子，对应一个对象或者一个节点
+  struct Entry {
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+    int index;
+  };
+
+  void build(std::vector<Entry>* const entries) {
+    if (entries->empty()) {
+      return;
+    }
+    bool is_leaf = true;
+    while (true) {
+      std::vector<Entry> parents;
+      pack_level(entries, is_leaf, &parents);
+      ++_height;
+      is_leaf = false;
+      if (parents.size() == 1) {
+        _root = parents[0].index;
+        _bounding_box = AABox2d({parents[0].min_x, parents[0].min_y},
+                                {parents[0].max_x, parents[0].max_y});
+        return;
+      }
+      entries->swap(parents);
+    }
+  }
+
+  // 用STR方法把一层的盒子打包成节点，输出上一层的盒子
+  void pack_level(std::vector<Entry>* const entries, const bool is_leaf,
+                  std::vector<Entry>* const parents) {
+    const int n = static_cast<int>(entries->size());
+    const int num_nodes =
+      (n + kAABoxRTreeNodeCapacity - 1) / kAABoxRTreeNodeCapacity;
+    const int num_slices =
+      static_cast<int>(std::ceil(std::sqrt(static_cast<double>(num_nodes))));
+    const int slice_size = num_slices * kAABoxRTreeNodeCapacity;
+
+    std::sort(entries->begin(), entries->end(),
+              [](const Entry& a, const Entry& b) {
+                return a.min_x + a.max_x < b.min_x + b.max_x;
+              });
+    for (int slice_begin = 0; slice_begin < n; slice_begin += slice_size) {
+      const int slice_end = std::min(n, slice_begin + slice_size);
+      std::sort(entries->begin() + slice_begin, entries->begin() + slice_end,
+                [](const Entry& a, const Entry& b) {
+                  return a.min_y + a.max_y < b.min_y + b.max_y;
+                });
+      for (int begin = slice_begin; begin < slice_end;
+           begin += kAABoxRTreeNodeCapacity) {
+        const int end = std::min(slice_end, begin + kAABoxRTreeNodeCapacity);
+        parents->push_back(make_node(*entries, begin, end, is_leaf));
+      }
+    }
+  }
+
+  Entry make_node(const std::vector<Entry>& entries, const int begin,
+                  const int end, const bool is_leaf) {
+    AABoxRTreeNode node;
+    node.num_children = end - begin;
+    node.is_leaf = is_leaf ? 1 : 0;
+    Entry parent = {std::numeric_limits<double>::infinity(),
+                    -std::numeric_limits<double>::infinity(),
+                    std::numeric_limits<double>::infinity(),
+                    -std::numeric_limits<double>::infinity(),
+                    static_cast<int>(_nodes.size())};
+    for (int i = 0; i < kAABoxRTreeNodeCapacity; ++i) {
+      if (begin + i < end) {
+        const Entry& entry = entries[begin + i];
+        node.min_x[i] = entry.min_x;
+        node.max_x[i] = entry.max_x;
+        node.min_y[i] = entry.min_y;
+        node.max_y[i] = entry.max_y;
+        node.children[i] = entry.index;
+        parent.min_x = std::fmin(parent.min_x, entry.min_x);
+        parent.max_x = std::fmax(parent.max_x, entry.max_x);
+        parent.min_y = std::fmin(parent.min_y, entry.min_y);
+        parent.max_y = std::fmax(parent.max_y, entry.max_y);
+      } else {
+        // 空位置的盒子不与任何区域重叠
+        node.min_x[i] = std::numeric_limits<double>::infinity();
+        node.max_x[i] = -std::numeric_limits<double>::infinity();
+        node.min_y[i] = std::numeric_limits<double>::infinity();
+        node.max_y[i] = -std::numeric_limits<double>::infinity();
+        node.children[i] = -1;
+      }
+    }
+    _nodes.push_back(node);
+    return parent;
+  }
+
+  // 点到节点中第'i'个盒子的距离平方的下界
+  static double lower_distance_square(const AABoxRTreeNode& node, const int i,
+                                      const Vec2d& point) {
+    const double dx = std::fmax(0.0, std::fmax(node.min_x[i] - point.x(),
+                                               point.x() - node.max_x[i]));
+    const double dy = std::fmax(0.0, std::fmax(node.min_y[i] - point.y(),
+                                               point.y() - node.max_y[i]));
+    return dx * dx + dy * dy;
+  }
+
+  // 按照到点的距离下界对子节点排序，距离写入'distances'，返回子节点数量
+  static int sort_children(const AABoxRTreeNode& node, const Vec2d& point,
+                           std::pair<double, int>* const distances) {
+    // 子节点很少，直接插入排序
+    for (int i = 0; i < node.num_children; ++i) {
+      const std::pair<double, int> item(lower_distance_square(node, i, point), i);
+      int j = i;
+      for (; j > 0 && item < distances[j - 1]; --j) {
+        distances[j] = distances[j - 1];
+      }
+      distances[j] = item;
+    }
+    return node.num_children;
+  }
+
+  template <typename Visitor>
+  bool visit_objects_internal(const int node_index, const Vec2d& point,
+                              const double distance_sqr,
+                              Visitor& visitor) const {
+    const AABoxRTreeNode& node = _nodes[node_index];
+    for (int i = 0; i < node.num_children; ++i) {
+      if (lower_distance_square(node, i, point) > distance_sqr) {
+        continue;
+      }
+      if (node.is_leaf) {
+        ObjectPtr object = _objects[node.children[i]];
+        if (object->distance_square_to(point) <= distance_sqr &&
+            !visitor(object)) {
+          return false;
+        }
+      } else if (!visit_objects_internal(node.children[i], point,
+                                         distance_sqr, visitor)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void get_nearest_object_internal(const int node_index, const Vec2d& point,
+                                   double* const min_distance_sqr,
+                                   ObjectPtr* const nearest_object) const {
+    const AABoxRTreeNode& node = _nodes[node_index];
+    std::pair<double, int> distances[kAABoxRTreeNodeCapacity];
+    const int num_children = sort_children(node, point, distances);
+    for (int i = 0; i < num_children; ++i) {
+      if (distances[i].first >= *min_distance_sqr) {
+        break;
+      }
+      const int child = node.children[distances[i].second];
+      if (node.is_leaf) {
+        ObjectPtr object = _objects[child];
+        const double distance_sqr = object->distance_square_to(point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest_object = object;
+        }
+      } else {
+        get_nearest_object_internal(child, point, min_distance_sqr,
+                                    nearest_object);
+      }
+    }
+  }
+
+  void get_k_nearest_objects_internal(
+      const int node_index, const Vec2d& point, const int k,
+      std::vector<std::pair<double, ObjectPtr>>* const heap) const {
+    const AABoxRTreeNode& node = _nodes[node_index];
+    std::pair<double, int> distances[kAABoxRTreeNodeCapacity];
+    const int num_children = sort_children(node, point, distances);
+    for (int i = 0; i < num_children; ++i) {
+      if (static_cast<int>(heap->size()) == k &&
+          distances[i].first >= heap->front().first) {
+        break;
+      }
+      const int child = node.children[distances[i].second];
+      if (!node.is_leaf) {
+        get_k_nearest_objects_internal(child, point, k, heap);
+        continue;
+      }
+      ObjectPtr object = _objects[child];
+      const double distance_sqr = object->distance_square_to(point);
+      if (static_cast<int>(heap->size()) < k) {
+        heap->emplace_back(distance_sqr, object);
+        std::push_heap(heap->begin(), heap->end());
+      } else if (distance_sqr < heap->front().first) {
+        std::pop_heap(heap->begin(), heap->end());
+        heap->back() = std::make_pair(distance_sqr, object);
+        std::push_heap(heap->begin(), heap->end());
+      }
+    }
+  }
+
+  template <typename Query>
+  std::vector<ObjectPtr> get_overlapping_objects(const Query& query) const {
+    std::vector<ObjectPtr> result_objects;
+    visit_overlapping_objects(query, [&result_objects](ObjectPtr object) {
+      result_objects.push_back(object);
+      return true;
+    });
+    return result_objects;
+  }
+
+  template <typename Query, typename Visitor>
+  bool visit_overlapping_objects_internal(const int node_index,
+                                          const Query& query,
+                                          Visitor& visitor) const {
+    const AABoxRTreeNode& node = _nodes[node_index];
+    for (int i = 0; i < node.num_children; ++i) {
+      if (!query.overlaps(node.min_x[i], node.max_x[i],
+                          node.min_y[i], node.max_y[i])) {
+        continue;
+      }
+      if (node.is_leaf) {
+        if (!visitor(_objects[node.children[i]])) {
+          return false;
+        }
+      } else if (!visit_overlapping_objects_internal(node.children[i], query,
+                                                     visitor)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::vector<ObjectPtr> _objects;
+  // 自底向上逐层排列，根节点在最后
+  std::vector<AABoxRTreeNode, AABoxRTreeAllocator<AABoxRTreeNode>> _nodes;
+  int _root = -1;
+  int _height = 0;
+  AABox2d _bounding_box;
+};
+
+}}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef MYMATH_BOX2D_HPP
 #define MYMATH_BOX2D_HPP
 
+#include <array>
 #include <cmath>
 #include <limits>
 #include <vector>
@@ -27,112 +28,120 @@ namespace mymath {
  * 迫使我们假定此处的'X/Y'，盒子为'东/北'（左手坐标系）。
  * 为了消除歧义，我们将与方向平行的矩形的轴称为'航向轴'。
  * 航向轴的大小称为'长度'，而垂直于该轴的轴的大小称为'宽度'。
+ *
+ * 盒子只保存中心、尺寸与航向，顶点与外包范围在读取时由闭式计算得到，
+ * 复制盒子不会分配内存，const的读取操作也不修改盒子，可以被多个线程同时读取。
  */
-class Box2d {
+template <typename T>
+class Box2 {
 public:
-  Box2d() = default;
+  Box2() = default;
 
   // heading x轴与航向轴的夹角, length 航向轴长度, width 轴的垂足到航向轴的长度。
-  Box2d(const Vec2d& center, const double heading, const double length,
-        const double width) : 
+  Box2(const Vec2<T>& center, const T heading, const T length,
+       const T width) : 
     _center(center),
     _length(length),
     _width(width),
-    _half_length(length / 2.0),
-    _half_width(width / 2.0),
+    _half_length(length / 2),
+    _half_width(width / 2),
     _heading(heading),
-    _cos_heading(cos(heading)),
-    _sin_heading(sin(heading)) {
-    assert(_length > -math_epsilon);
-    assert(_width > -math_epsilon);
-    init_corners();
+    _cos_heading(std::cos(heading)),
+    _sin_heading(std::sin(heading)) {
+    assert(_length > -math_epsilon_of<T>());
+    assert(_width > -math_epsilon_of<T>());
   }
 
   // 盒子的宽度，垂直于航向轴方向。
-  Box2d(const LineSegment2d& axis, const double width) : 
+  Box2(const LineSegment2<T>& axis, const T width) : 
     _center(axis.center()),
     _length(axis.length()),
     _width(width),
-    _half_length(axis.length() / 2.0),
-    _half_width(width / 2.0),
+    _half_length(axis.length() / 2),
+    _half_width(width / 2),
     _heading(axis.heading()),
     _cos_heading(axis.cos_heading()),
     _sin_heading(axis.sin_heading()) {
-    assert(_length > -math_epsilon);
-    assert(_width > -math_epsilon);
-    init_corners();
+    assert(_length > -math_epsilon_of<T>());
+    assert(_width > -math_epsilon_of<T>());
   }
 
-  void init_corners() {
-    const double dx1 = _cos_heading * _half_length;
-    const double dy1 = _sin_heading * _half_length;
-    const double dx2 = _sin_heading * _half_width;
-    const double dy2 = -_cos_heading * _half_width;
-    _corners.clear();
-    _corners.emplace_back(_center.x() + dx1 + dx2, _center.y() + dy1 + dy2);
-    _corners.emplace_back(_center.x() + dx1 - dx2, _center.y() + dy1 - dy2);
-    _corners.emplace_back(_center.x() - dx1 - dx2, _center.y() - dy1 - dy2);
-    _corners.emplace_back(_center.x() - dx1 + dx2, _center.y() - dy1 + dy2);
-
-    for (auto& corner : _corners) {
-      _max_x = std::fmax(corner.x(), _max_x);
-      _min_x = std::fmin(corner.x(), _min_x);
-      _max_y = std::fmax(corner.y(), _max_y);
-      _min_y = std::fmin(corner.y(), _min_y);
-    }
-  }
+  // 顶点与外包范围在读取时计算，不再需要预先计算，保留该接口以兼容已有的调用
+  void init_corners() const {}
 
   // 通过轴对齐盒子构造
-  explicit Box2d(const AABox2d& aabox) : 
+  explicit Box2(const AABox2<T>& aabox) : 
     _center(aabox.center()),
     _length(aabox.length()),
     _width(aabox.width()),
     _half_length(aabox.half_length()),
     _half_width(aabox.half_width()),
-    _heading(0.0),
-    _cos_heading(1.0),
-    _sin_heading(0.0) {
-    assert(_length > -math_epsilon);
-    assert(_width > -math_epsilon);
+    _heading(0),
+    _cos_heading(1),
+    _sin_heading(0) {
+    assert(_length > -math_epsilon_of<T>());
+    assert(_width > -math_epsilon_of<T>());
   }
 
+  // 不同精度之间的转换
+  template <typename U>
+  explicit Box2(const Box2<U>& other) :
+    Box2(Vec2<T>(other.center()), static_cast<T>(other.heading()),
+         static_cast<T>(other.length()), static_cast<T>(other.width())) {}
+
   // 使用两个对应的顶点坐标创建盒子
-  static Box2d create_aabox(const Vec2d& one_corner,
-                            const Vec2d& opposite_corner) {
-    const double x1 = std::min(one_corner.x(), opposite_corner.x());
-    const double x2 = std::max(one_corner.x(), opposite_corner.x());
-    const double y1 = std::min(one_corner.y(), opposite_corner.y());
-    const double y2 = std::max(one_corner.y(), opposite_corner.y());
-    return Box2d({(x1 + x2) / 2.0, (y1 + y2) / 2.0}, 0.0, x2 - x1, y2 - y1);
+  static Box2 create_aabox(const Vec2<T>& one_corner,
+                           const Vec2<T>& opposite_corner) {
+    const T x1 = std::min(one_corner.x(), opposite_corner.x());
+    const T x2 = std::max(one_corner.x(), opposite_corner.x());
+    const T y1 = std::min(one_corner.y(), opposite_corner.y());
+    const T y2 = std::max(one_corner.y(), opposite_corner.y());
+    return Box2({(x1 + x2) / 2, (y1 + y2) / 2}, 0, x2 - x1, y2 - y1);
   }
 
-  const Vec2d& center() const { return _center; }
-  double center_x() const { return _center.x(); }
-  double center_y() const { return _center.y(); }
-  double length() const { return _length; }
-  double width() const { return _width; }
-  double half_length() const { return _half_length; }
-  double half_width() const { return _half_width; }
-  double heading() const { return _heading; }
-  double cos_heading() const { return _cos_heading; }
-  double sin_heading() const { return _sin_heading; }
-  double area() const { return _length * _width; }
-  double diagonal() const { return std::hypot(_length, _width); }
+  const Vec2<T>& center() const { return _center; }
+  T center_x() const { return _center.x(); }
+  T center_y() const { return _center.y(); }
+  T length() const { return _length; }
+  T width() const { return _width; }
+  T half_length() const { return _half_length; }
+  T half_width() const { return _half_width; }
+  T heading() const { return _heading; }
+  T cos_heading() const { return _cos_heading; }
+  T sin_heading() const { return _sin_heading; }
+  T area() const { return _length * _width; }
+  T diagonal() const { return std::hypot(_length, _width); }
 
   // 获取所有的顶点
-  void get_all_corners(std::vector<Vec2d>* const corners) const {
+  void get_all_corners(std::vector<Vec2<T>>* const corners) const {
     if (corners == nullptr) return;
-    *corners = _corners;
+    const std::array<Vec2<T>, 4> all_corners = this->corners();
+    corners->assign(all_corners.begin(), all_corners.end());
+  }
+  std::vector<Vec2<T>> get_all_corners() const {
+    const std::array<Vec2<T>, 4> all_corners = corners();
+    return std::vector<Vec2<T>>(all_corners.begin(), all_corners.end());
+  }
+
+  // 不分配内存地获取所有的顶点
+  std::array<Vec2<T>, 4> corners() const {
+    const T dx1 = _cos_heading * _half_length;
+    const T dy1 = _sin_heading * _half_length;
+    const T dx2 = _sin_heading * _half_width;
+    const T dy2 = -_cos_heading * _half_width;
+    return {{Vec2<T>(_center.x() + dx1 + dx2, _center.y() + dy1 + dy2),
+             Vec2<T>(_center.x() + dx1 - dx2, _center.y() + dy1 - dy2),
+             Vec2<T>(_center.x() - dx1 - dx2, _center.y() - dy1 - dy2),
+             Vec2<T>(_center.x() - dx1 + dx2, _center.y() - dy1 + dy2)}};
   }
-  std::vector<Vec2d> get_all_corners() const { return _corners; }
 
   // 按照'ccw'顺序对端点进行排序
-  static void sort_corners_by_ccw(std::vector<Vec2d>& corners) {
+  static void sort_corners_by_ccw(std::vector<Vec2<T>>& corners) {
     size_t num_points = corners.size();
     assert(num_points >= 3);
 
     // 确认点的顺序为'ccw'顺序
-    double area = 0.0;
+    T area = 0;
     for (int i = 1; i < num_points; ++i) {
       area += cross_prod(corners[0], corners[i - 1], corners[i]);
     }
@@ -140,17 +149,18 @@ public:
       area = -area;
       std::reverse(corners.begin(), corners.end());
     }
-    area /= 2.0;
-    assert(area > math_epsilon);
+    area /= 2;
+    assert(area > math_epsilon_of<T>());
     return;
   }
 
-  std::vector<LineSegment2d> get_all_segments() const {
-    std::vector<Vec2d> points = get_all_corners();
+  std::vector<LineSegment2<T>> get_all_segments() const {
+    std::vector<Vec2<T>> points = get_all_corners();
     return get_all_segments(points);
   }
 
-  static std::vector<LineSegment2d> get_all_segments(std::vector<Vec2d>& points) {
+  static std::vector<LineSegment2<T>> get_all_segments(
+      std::vector<Vec2<T>>& points) {
     size_t num_points = points.size();
     assert(num_points >= 3);
 
@@ -158,7 +168,7 @@ public:
     sort_corners_by_ccw(points);
 
     // 构造线段
-    std::vector<LineSegment2d> line_segments;
+    std::vector<LineSegment2<T>> line_segments;
     line_segments.reserve(num_points);
     for (int i = 0; i < num_points; ++i) {
       int next_i = i >= num_points - 1 ? 0 : i + 1;
@@ -168,65 +178,60 @@ public:
   }
 
   // 判断端点是否在盒子内
-  bool is_point_in(const Vec2d& point) const {
-    const double x0 = point.x() - _center.x();
-    const double y0 = point.y() - _center.y();
-    const double dx = std::abs(x0 * _cos_heading + y0 * _sin_heading);
-    const double dy = std::abs(-x0 * _sin_heading + y0 * _cos_heading);
-    return dx <= _half_length + math_epsilon && dy <= _half_width + math_epsilon;
+  bool is_point_in(const Vec2<T>& point) const {
+    const T x0 = point.x() - _center.x();
+    const T y0 = point.y() - _center.y();
+    const T dx = std::abs(x0 * _cos_heading + y0 * _sin_heading);
+    const T dy = std::abs(-x0 * _sin_heading + y0 * _cos_heading);
+    return dx <= _half_length + math_epsilon_of<T>() &&
+           dy <= _half_width + math_epsilon_of<T>();
   }
 
   // 在点上在盒子的边界上
-  bool is_point_on_boundary(const Vec2d& point) const {
-    const double x0 = point.x() - _center.x();
-    const double y0 = point.y() - _center.y();
-    const double dx = std::abs(x0 * _cos_heading + y0 * _sin_heading);
-    const double dy = std::abs(x0 * _sin_heading - y0 * _cos_heading);
-    return (std::abs(dx - _half_length) <= math_epsilon &&
-            dy <= _half_width + math_epsilon) ||
-          (std::abs(dy - _half_width) <= math_epsilon &&
-            dx <= _half_length + math_epsilon);
+  bool is_point_on_boundary(const Vec2<T>& point) const {
+    const T x0 = point.x() - _center.x();
+    const T y0 = point.y() - _center.y();
+    const T dx = std::abs(x0 * _cos_heading + y0 * _sin_heading);
+    const T dy = std::abs(x0 * _sin_heading - y0 * _cos_heading);
+    return (std::abs(dx - _half_length) <= math_epsilon_of<T>() &&
+            dy <= _half_width + math_epsilon_of<T>()) ||
+          (std::abs(dy - _half_width) <= math_epsilon_of<T>() &&
+            dx <= _half_length + math_epsilon_of<T>());
   }
 
   // 测试与点的距离
-  double distance_to(const Vec2d& point) const {
-    const double x0 = point.x() - _center.x();
-    const double y0 = point.y() - _center.y();
-    const double dx =
-      std::abs(x0 * _cos_heading + y0 * _sin_heading) - _half_length;
-    const double dy =
-      std::abs(x0 * _sin_heading - y0 * _cos_heading) - _half_width;
-    if (dx <= 0.0)
-      return std::max(0.0, dy);
-    if (dy <= 0.0)
-      return dx;
-    return hypot(dx, dy);
+  T distance_to(const Vec2<T>& point) const {
+    const T x0 = point.x() - _center.x();
+    const T y0 = point.y() - _center.y();
+    return local_distance(x0 * _cos_heading + y0 * _sin_heading,
+                          x0 * _sin_heading - y0 * _cos_heading,
+                          _half_length, _half_width);
   }
 
   // 与线段的距离
-  double distance_to(const LineSegment2d& line_segment) const {
-    if (line_segment.length() <= math_epsilon)
+  T distance_to(const LineSegment2<T>& line_segment) const {
+    if (line_segment.length() <= math_epsilon_of<T>())
       return distance_to(line_segment.start());
 
-    const double ref_x1 = line_segment.start().x() - _center.x();
-    const double ref_y1 = line_segment.start().y() - _center.y();
-    double x1 = ref_x1 * _cos_heading + ref_y1 * _sin_heading;
-    double y1 = ref_x1 * _sin_heading - ref_y1 * _cos_heading;
-    double box_x = _half_length;
-    double box_y = _half_width;
+    const T ref_x1 = line_segment.start().x() - _center.x();
+    const T ref_y1 = line_segment.start().y() - _center.y();
+    T x1 = ref_x1 * _cos_heading + ref_y1 * _sin_heading;
+    T y1 = ref_x1 * _sin_heading - ref_y1 * _cos_heading;
+    T box_x = _half_length;
+    T box_y = _half_width;
     int gx1 = (x1 >= box_x ? 1 : (x1 <= -box_x ? -1 : 0));
     int gy1 = (y1 >= box_y ? 1 : (y1 <= -box_y ? -1 : 0));
     if (gx1 == 0 && gy1 == 0)
-      return 0.0;
+      return 0;
     
-    const double ref_x2 = line_segment.end().x() - _center.x();
-    const double ref_y2 = line_segment.end().y() - _center.y();
-    double x2 = ref_x2 * _cos_heading + ref_y2 * _sin_heading;
-    double y2 = ref_x2 * _sin_heading - ref_y2 * _cos_heading;
+    const T ref_x2 = line_segment.end().x() - _center.x();
+    const T ref_y2 = line_segment.end().y() - _center.y();
+    T x2 = ref_x2 * _cos_heading + ref_y2 * _sin_heading;
+    T y2 = ref_x2 * _sin_heading - ref_y2 * _cos_heading;
     int gx2 = (x2 >= box_x ? 1 : (x2 <= -box_x ? -1 : 0));
     int gy2 = (y2 >= box_y ? 1 : (y2 <= -box_y ? -1 : 0));
     if (gx2 == 0 && gy2 == 0)
-      return 0.0;
+      return 0;
 
     if (gx1 < 0 || (gx1 == 0 && gx2 < 0)) {
       x1 = -x1;
@@ -262,16 +267,16 @@ public:
                            : ptseg_distance(box_x, box_y, x1, y1, x2, y2,
                                             line_segment.length());
         case -1:
-          return cross_prod({x1, y1}, {x2, y2}, {box_x, -box_y}) >= 0.0
-                    ? 0.0
+          return cross_prod({x1, y1}, {x2, y2}, {box_x, -box_y}) >= 0
+                    ? 0
                     : ptseg_distance(box_x, -box_y, x1, y1, x2, y2,
                                      line_segment.length());
         case -4:
-          return cross_prod({x1, y1}, {x2, y2}, {box_x, -box_y}) <= 0.0
+          return cross_prod({x1, y1}, {x2, y2}, {box_x, -box_y}) <= 0
                     ? ptseg_distance(box_x, -box_y, x1, y1, x2, y2,
                                      line_segment.length())
-                    : (cross_prod({x1, y1}, {x2, y2}, {-box_x, box_y}) <= 0.0
-                            ? 0.0
+                    : (cross_prod({x1, y1}, {x2, y2}, {-box_x, box_y}) <= 0
+                            ? 0
                             : ptseg_distance(-box_x, box_y, x1, y1, x2, y2,
                                              line_segment.length()));
       }/* end switch */
@@ -285,41 +290,35 @@ public:
           return std::min(x1, x2) - box_x;
         case 1:
         case -2:
-          return cross_prod({x1, y1}, {x2, y2}, {box_x, box_y}) <= 0.0
-                    ? 0.0
+          return cross_prod({x1, y1}, {x2, y2}, {box_x, box_y}) <= 0
+                    ? 0
                     : ptseg_distance(box_x, box_y, x1, y1, x2, y2,
                                      line_segment.length());
         case -3:
-          return 0.0;
+          return 0;
       }
     }
 
     // 到达这里就出错
     assert(0);
     // unimplemented state: gx1, gy1, gx2 gy2
-    return 0.0;
+    return 0;
   }
 
   // 计算两个盒子的距离,重叠返回0。
-  double distance_to(const Box2d& box) const {
-    //return Polygon2d(box).distance_to(*this);
-    std::vector<Vec2d> corners = box.get_all_corners();
-    assert(corners.size() >= 3);
-    sort_corners_by_ccw(corners);
-
-    std::vector<LineSegment2d> line_segments = get_all_segments(corners);
-    double distance = std::numeric_limits<double>::infinity();
-    for (int i = 0; i < corners.size(); ++i) {
-      // 检测box的顶点是否在当前盒子内，在则返回。
-      if (is_point_in(corners[i])) return 0.0;
-      distance = std::min(distance, box.distance_to(line_segments[i]));
-    }
-    return distance;
+  T distance_to(const Box2& box) const {
+    return box_distance(box, 0);
+  }
+
+  // 两个盒子的距离是否小于'distance'，重叠视为距离为0。
+  bool distance_less_than(const Box2& box, const T distance) const {
+    if (distance <= 0) return false;
+    return box_distance(box, distance) < distance;
   }
 
   // 检查与线段是否重叠
-  bool has_overlap(const LineSegment2d& line_segment) const {
-    if (line_segment.length() <= math_epsilon) {
+  bool has_overlap(const LineSegment2<T>& line_segment) const {
+    if (line_segment.length() <= math_epsilon_of<T>()) {
       return is_point_in(line_segment.start());
     }
     if (std::fmax(line_segment.start().x(), line_segment.end().x()) < min_x() ||
@@ -328,27 +327,27 @@ public:
         std::fmin(line_segment.start().y(), line_segment.end().y()) > max_x()) {
       return false;
     }
-    return distance_to(line_segment) <= math_epsilon;
+    return distance_to(line_segment) <= math_epsilon_of<T>();
   }
 
   // 检查两个盒子是否重合
-  bool has_overlap(const Box2d& box) const {
+  bool has_overlap(const Box2& box) const {
     if (box.max_x() < min_x() || box.min_x() > max_x() || box.max_y() < min_y() ||
         box.min_y() > max_y()) {
       return false;
     }
 
-    const double shift_x = box.center_x() - _center.x();
-    const double shift_y = box.center_y() - _center.y();
+    const T shift_x = box.center_x() - _center.x();
+    const T shift_y = box.center_y() - _center.y();
 
-    const double dx1 = _cos_heading * _half_length;
-    const double dy1 = _sin_heading * _half_length;
-    const double dx2 = _sin_heading * _half_width;
-    const double dy2 = -_cos_heading * _half_width;
-    const double dx3 = box.cos_heading() * box.half_length();
-    const double dy3 = box.sin_heading() * box.half_length();
-    const double dx4 = box.sin_heading() * box.half_width();
-    const double dy4 = -box.cos_heading() * box.half_width();
+    const T dx1 = _cos_heading * _half_length;
+    const T dy1 = _sin_heading * _half_length;
+    const T dx2 = _sin_heading * _half_width;
+    const T dy2 = -_cos_heading * _half_width;
+    const T dx3 = box.cos_heading() * box.half_length();
+    const T dy3 = box.sin_heading() * box.half_length();
+    const T dx4 = box.sin_heading() * box.half_width();
+    const T dy4 = -box.cos_heading() * box.half_width();
 
     return std::abs(shift_x * _cos_heading + shift_y * _sin_heading) <=
            std::abs(dx3 * _cos_heading + dy3 * _sin_heading) +
@@ -369,39 +368,35 @@ public:
   }
 
   // 获取一个最小的轴对齐盒子
-  AABox2d get_aabox() const {
-    const double dx1 = std::abs(_cos_heading * _half_length);
-    const double dy1 = std::abs(_sin_heading * _half_length);
-    const double dx2 = std::abs(_sin_heading * _half_width);
-    const double dy2 = std::abs(_cos_heading * _half_width);
-    return AABox2d(_center, (dx1 + dx2) * 2.0, (dy1 + dy2) * 2.0);
+  AABox2<T> get_aabox() const {
+    const T dx1 = std::abs(_cos_heading * _half_length);
+    const T dy1 = std::abs(_sin_heading * _half_length);
+    const T dx2 = std::abs(_sin_heading * _half_width);
+    const T dy2 = std::abs(_cos_heading * _half_width);
+    return AABox2<T>(_center, (dx1 + dx2) * 2, (dy1 + dy2) * 2);
   }
 
   // 以中央点进行'rotate_angle'角度旋转
-  void rotate_from_center(const double rotate_angle) {
+  void rotate_from_center(const T rotate_angle) {
     _heading = normalize_angle(_heading + rotate_angle);
     _cos_heading = std::cos(_heading);
     _sin_heading = std::sin(_heading);
-    init_corners();
   }
 
   // 通过给定的偏移'shift_vec'移动盒子
-  void shift(const Vec2d& shift_vec) {
+  void shift(const Vec2<T>& shift_vec) {
     _center += shift_vec;
-    init_corners();
   }
 
   // 纵向地扩展盒子'extension_length'长度
-  void longitudinal_extend(const double extension_length) {
+  void longitudinal_extend(const T extension_length) {
     _length += extension_length;
-    _half_length += extension_length / 2.0;
-    init_corners();
+    _half_length += extension_length / 2;
   }
 
-  void lateral_extend(const double extension_length) {
+  void lateral_extend(const T extension_length) {
     _width += extension_length;
-    _half_width += extension_length / 2.0;
-    init_corners();
+    _half_width += extension_length / 2;
   }
 
 #if MYMATH_DBG
@@ -416,46 +411,121 @@ public:
   }
 #endif
 
-  double max_x() const { return _max_x; }
-  double min_x() const { return _min_x; }
-  double max_y() const { return _max_y; }
-  double min_y() const { return _min_y; }
-
-  static double ptseg_distance(double query_x, double query_y, double start_x,
-                               double start_y, double end_x, double end_y,
-                               double length) {
-    const double x0 = query_x - start_x;
-    const double y0 = query_y - start_y;
-    const double dx = end_x - start_x;
-    const double dy = end_y - start_y;
-    const double proj = x0 * dx + y0 * dy;
-    if (proj <= 0.0) {
-      return hypot(x0, y0);
+  // 外包范围，中心加减航向轴与宽度轴在坐标轴上投影的绝对值
+  T max_x() const { return _center.x() + extent_x(); }
+  T min_x() const { return _center.x() - extent_x(); }
+  T max_y() const { return _center.y() + extent_y(); }
+  T min_y() const { return _center.y() - extent_y(); }
+
+  static T ptseg_distance(T query_x, T query_y, T start_x,
+                          T start_y, T end_x, T end_y,
+                          T length) {
+    const T x0 = query_x - start_x;
+    const T y0 = query_y - start_y;
+    const T dx = end_x - start_x;
+    const T dy = end_y - start_y;
+    const T proj = x0 * dx + y0 * dy;
+    if (proj <= 0) {
+      return std::hypot(x0, y0);
     }
     if (proj >= length * length) {
-      return hypot(x0 - dx, y0 - dy);
+      return std::hypot(x0 - dx, y0 - dy);
     }
     return std::abs(x0 * dy - y0 * dx) / length;
   }
 
 private:
-  Vec2d _center;
-  double _length = 0.0;
-  double _width = 0.0;
-  double _half_length = 0.0;
-  double _half_width = 0.0;
-  double _heading = 0.0;
-  double _cos_heading = 1.0;
-  double _sin_heading = 0.0;
-
-  std::vector<Vec2d> _corners;
-
-  double _max_x = std::numeric_limits<double>::min();
-  double _min_x = std::numeric_limits<double>::max();
-  double _max_y = std::numeric_limits<double>::min();
-  double _min_y = std::numeric_limits<double>::max();
+  // 局部坐标系中的点(x, y)到以原点为中心、半长半宽为'half_length'与'half_width'的盒子的距离
+  static T local_distance(const T x, const T y, const T half_length,
+                          const T half_width) {
+    const T dx = std::abs(x) - half_length;
+    const T dy = std::abs(y) - half_width;
+    if (dx <= 0)
+      return std::max(T(0), dy);
+    if (dy <= 0)
+      return dx;
+    return std::hypot(dx, dy);
+  }
+
+  /*
+   * 在当前盒子的局部坐标系中计算与'box'的距离，不分配内存。
+   * 先计算四个分离轴上的间隔，最大间隔不大于0即为重叠，否则它是距离的下界；
+   * 两个盒子分离时最近点对中至少有一个是顶点，因此距离为8个顶点到另一个盒子的最小距离。
+   * 'threshold'大于0时提前返回：下界不小于'threshold'时返回该下界，
+   * 某个候选距离小于'threshold'时返回该候选距离，返回值与'threshold'的大小关系和实际距离一致。
+   */
+  T box_distance(const Box2& box, const T threshold) const {
+    // 'box'的中心与航向轴单位向量(ex, ey)在局部坐标系中的坐标
+    const T shift_x = box.center_x() - _center.x();
+    const T shift_y = box.center_y() - _center.y();
+    const T cx = shift_x * _cos_heading + shift_y * _sin_heading;
+    const T cy = shift_x * _sin_heading - shift_y * _cos_heading;
+    const T ex = box.cos_heading() * _cos_heading + box.sin_heading() * _sin_heading;
+    const T ey = box.cos_heading() * _sin_heading - box.sin_heading() * _cos_heading;
+    const T abs_ex = std::abs(ex);
+    const T abs_ey = std::abs(ey);
+    // 当前盒子中心在'box'坐标系中的坐标
+    const T bx = -(cx * ex + cy * ey);
+    const T by = cx * ey - cy * ex;
+
+    const T separation = std::max(
+      std::max(std::abs(cx) - (_half_length + box.half_length() * abs_ex +
+                               box.half_width() * abs_ey),
+               std::abs(cy) - (_half_width + box.half_length() * abs_ey +
+                               box.half_width() * abs_ex)),
+      std::max(std::abs(bx) - (box.half_length() + _half_length * abs_ex +
+                               _half_width * abs_ey),
+               std::abs(by) - (box.half_width() + _half_length * abs_ey +
+                               _half_width * abs_ex)));
+    if (separation <= 0) return 0;
+    if (threshold > 0 && separation >= threshold) return separation;
+
+    const T ux = ex * box.half_length();
+    const T uy = ey * box.half_length();
+    const T vx = -ey * box.half_width();
+    const T vy = ex * box.half_width();
+    T distance = std::numeric_limits<T>::infinity();
+    for (const T su : {T(1), T(-1)}) {
+      for (const T sv : {T(1), T(-1)}) {
+        // 'box'的顶点到当前盒子
+        distance = std::min(distance, local_distance(cx + su * ux + sv * vx,
+                                                     cy + su * uy + sv * vy,
+                                                     _half_length, _half_width));
+        // 当前盒子的顶点到'box'
+        const T x = su * _half_length;
+        const T y = sv * _half_width;
+        distance = std::min(distance, local_distance(bx + x * ex + y * ey,
+                                                     by - x * ey + y * ex,
+                                                     box.half_length(),
+                                                     box.half_width()));
+        if (distance < threshold) return distance;
+      }
+    }
+    return distance;
+  }
+
+  T extent_x() const {
+    return std::abs(_cos_heading) * _half_length + std::abs(_sin_heading) * _half_width;
+  }
+
+  T extent_y() const {
+    return std::abs(_sin_heading) * _half_length + std::abs(_cos_heading) * _half_width;
+  }
+
+private:
+  Vec2<T> _center;
+  T _length = 0;
+  T _width = 0;
+  T _half_length = 0;
+  T _half_width = 0;
+  T _heading = 0;
+  T _cos_heading = 1;
+  T _sin_heading = 0;
 };
 
+using Box2d = Box2<double>;
+using Box2f = Box2<float>;
+
 }}
 
 #endif
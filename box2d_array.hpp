@@ -0,0 +1,209 @@
+#ifndef MYMATH_BOX2D_ARRAY_HPP
+#define MYMATH_BOX2D_ARRAY_HPP
+
+#include "mymath_config.h"
+
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "vec2d.hpp"
+#include "box2d.hpp"
+#include "vec2d_array.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 按照SoA存放的一组有向盒子，用于一个盒子与多个盒子的批量重叠检测
+ *
+ * 每个盒子保存中心、航向的cos/sin、半长与半宽，以及其轴对齐外包盒的半尺寸。
+ * 检测时使用与Vec2dArray相同的SIMD封装，每次处理一组盒子：
+ * 先用轴对齐外包盒排除，整组都被排除时跳过分离轴测试；
+ * 否则计算四个分离轴上的间隔，最大间隔不大于0即为重叠(与Box2d::has_overlap一致)。
+ */
+class Box2dArray {
+public:
+  Box2dArray() = default;
+
+  explicit Box2dArray(const std::vector<Box2d>& boxes) {
+    reserve(static_cast<int>(boxes.size()));
+    for (const auto& box : boxes) {
+      push_back(box);
+    }
+  }
+
+  int size() const { return static_cast<int>(_center_x.size()); }
+  bool empty() const { return _center_x.empty(); }
+
+  void reserve(const int size) {
+    for_each_values([size](std::vector<double>* values) { values->reserve(size); });
+  }
+
+  void clear() {
+    for_each_values([](std::vector<double>* values) { values->clear(); });
+  }
+
+  void push_back(const Box2d& box) {
+    for_each_values([](std::vector<double>* values) { values->push_back(0.0); });
+    set(size() - 1, box);
+  }
+
+  void set(const int i, const Box2d& box) {
+    assert(i >= 0 && i < size());
+    _center_x[i] = box.center_x();
+    _center_y[i] = box.center_y();
+    _cos_heading[i] = box.cos_heading();
+    _sin_heading[i] = box.sin_heading();
+    _half_length[i] = box.half_length();
+    _half_width[i] = box.half_width();
+    _half_extent_x[i] = std::abs(box.cos_heading()) * box.half_length() +
+                        std::abs(box.sin_heading()) * box.half_width();
+    _half_extent_y[i] = std::abs(box.sin_heading()) * box.half_length() +
+                        std::abs(box.cos_heading()) * box.half_width();
+  }
+
+  Box2d operator[](const int i) const {
+    assert(i >= 0 && i < size());
+    return Box2d({_center_x[i], _center_y[i]},
+                 std::atan2(_sin_heading[i], _cos_heading[i]),
+                 _half_length[i] * 2.0, _half_width[i] * 2.0);
+  }
+
+  /*
+   * 查找与'box'重叠的盒子，按照编号升序写入'indices'，返回重叠的数量。
+   */
+  int get_overlapping_indices(const Box2d& box,
+                              std::vector<int>* const indices) const {
+    assert(indices);
+    indices->clear();
+    visit_overlaps(box, [indices](const int i) {
+      indices->push_back(i);
+      return true;
+    });
+    return static_cast<int>(indices->size());
+  }
+
+  /*
+   * 计算与'box'重叠的位掩码，第i个盒子对应(*mask)[i / 64]的第(i % 64)位。
+   * 返回重叠的数量。
+   */
+  int get_overlap_mask(const Box2d& box, std::vector<uint64_t>* const mask) const {
+    assert(mask);
+    mask->assign((_center_x.size() + 63) / 64, 0);
+    int count = 0;
+    visit_overlaps(box, [mask, &count](const int i) {
+      (*mask)[i / 64] |= (uint64_t(1) << (i % 64));
+      ++count;
+      return true;
+    });
+    return count;
+  }
+
+  // 是否与任意一个盒子重叠，找到第一个重叠的盒子后立即返回
+  bool has_overlap(const Box2d& box) const {
+    return !visit_overlaps(box, [](const int) { return false; });
+  }
+
+private:
+  template <typename Function>
+  void for_each_values(const Function& function) {
+    for (std::vector<double>* values :
+         {&_center_x, &_center_y, &_cos_heading, &_sin_heading,
+          &_half_length, &_half_width, &_half_extent_x, &_half_extent_y}) {
+      function(values);
+    }
+  }
+
+  // 对每个与'box'重叠的盒子按照编号升序调用visitor(i)，visitor返回false时停止，被停止时返回false
+  template <typename Visitor>
+  bool visit_overlaps(const Box2d& box, const Visitor& visitor) const {
+    const double ax = box.center_x();
+    const double ay = box.center_y();
+    const double ca = box.cos_heading();
+    const double sa = box.sin_heading();
+    const double a_hl = box.half_length();
+    const double a_hw = box.half_width();
+    const double a_ex = std::abs(ca) * a_hl + std::abs(sa) * a_hw;
+    const double a_ey = std::abs(sa) * a_hl + std::abs(ca) * a_hw;
+
+    const double* const center_x = _center_x.data();
+    const double* const center_y = _center_y.data();
+    const double* const cos_heading = _cos_heading.data();
+    const double* const sin_heading = _sin_heading.data();
+    const double* const half_length = _half_length.data();
+    const double* const half_width = _half_width.data();
+    const double* const half_extent_x = _half_extent_x.data();
+    const double* const half_extent_y = _half_extent_y.data();
+
+    return for_each_vec2d_pack_until(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      double separation[P::kWidth];
+
+      // 轴对齐外包盒排除
+      const auto dx = P::sub(P::load(center_x + i), P::set1(ax));
+      const auto dy = P::sub(P::load(center_y + i), P::set1(ay));
+      const auto aabox_separation = P::max(
+        P::sub(P::abs(dx), P::add(P::load(half_extent_x + i), P::set1(a_ex))),
+        P::sub(P::abs(dy), P::add(P::load(half_extent_y + i), P::set1(a_ey))));
+      P::store(separation, aabox_separation);
+      bool all_separated = true;
+      for (int k = 0; k < P::kWidth; ++k) {
+        all_separated = all_separated && separation[k] > 0.0;
+      }
+      if (all_separated) {
+        return true;
+      }
+
+      // 分离轴测试，c与s为两个盒子航向夹角的|cos|与|sin|
+      const auto cb = P::load(cos_heading + i);
+      const auto sb = P::load(sin_heading + i);
+      const auto b_hl = P::load(half_length + i);
+      const auto b_hw = P::load(half_width + i);
+      const auto vca = P::set1(ca);
+      const auto vsa = P::set1(sa);
+      const auto va_hl = P::set1(a_hl);
+      const auto va_hw = P::set1(a_hw);
+      const auto c = P::abs(P::add(P::mul(vca, cb), P::mul(vsa, sb)));
+      const auto s = P::abs(P::sub(P::mul(vsa, cb), P::mul(vca, sb)));
+      // 当前盒子的两个轴
+      const auto sep1 = P::sub(
+        P::abs(P::add(P::mul(dx, vca), P::mul(dy, vsa))),
+        P::add(P::add(P::mul(b_hl, c), P::mul(b_hw, s)), va_hl));
+      const auto sep2 = P::sub(
+        P::abs(P::sub(P::mul(dx, vsa), P::mul(dy, vca))),
+        P::add(P::add(P::mul(b_hl, s), P::mul(b_hw, c)), va_hw));
+      // 另一个盒子的两个轴
+      const auto sep3 = P::sub(
+        P::abs(P::add(P::mul(dx, cb), P::mul(dy, sb))),
+        P::add(P::add(P::mul(va_hl, c), P::mul(va_hw, s)), b_hl));
+      const auto sep4 = P::sub(
+        P::abs(P::sub(P::mul(dx, sb), P::mul(dy, cb))),
+        P::add(P::add(P::mul(va_hl, s), P::mul(va_hw, c)), b_hw));
+      P::store(separation, P::max(P::max(aabox_separation, sep1),
+                                  P::max(P::max(sep2, sep3), sep4)));
+      for (int k = 0; k < P::kWidth; ++k) {
+        if (separation[k] <= 0.0 && !visitor(i + k)) {
+          return false;
+        }
+      }
+      return true;
+    });
+  }
+
+private:
+  std::vector<double> _center_x;
+  std::vector<double> _center_y;
+  std::vector<double> _cos_heading;
+  std::vector<double> _sin_heading;
+  std::vector<double> _half_length;
+  std::vector<double> _half_width;
+  std::vector<double> _half_extent_x;     // 轴对齐外包盒的半长
+  std::vector<double> _half_extent_y;     // 轴对齐外包盒的半宽
+};
+
+}}
+
+#endif
@@ -0,0 +1,490 @@
+#ifndef MYMATH_DYNAMIC_AABOX_TREE2D_HPP
+#define MYMATH_DYNAMIC_AABOX_TREE2D_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+#include "aabox2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 默认的盒子扩展量，对象在扩展量之内移动不需要更新树
+static constexpr double kDynamicAABoxTreeDefaultMargin = 0.5;
+
+/*
+ * 动态轴对齐盒子树(broad phase)
+ *
+ * 每个对象(proxy)是一个叶子节点，叶子保存的是扩展了'margin'的盒子(fat box)，
+ * 对象在扩展范围内移动时只需要比较，不需要修改树。
+ * 插入时按照周长增量的代价选择兄弟节点，插入与删除后沿途用旋转保持平衡。
+ * 节点保存在连续的数组中，删除的节点放入空闲链表复用。
+ *
+ * UserData : 叶子节点附带的用户数据，例如对象指针
+ */
+template <typename UserData>
+class DynamicAABoxTree2d {
+public:
+  static constexpr int kNullNode = -1;
+
+  explicit DynamicAABoxTree2d(const double margin = kDynamicAABoxTreeDefaultMargin)
+      : _margin(margin) {
+    assert(margin >= 0.0);
+  }
+
+  /*
+   * 插入一个对象，返回其proxy编号。
+   * 编号在对象被删除之前保持不变，删除之后可能被复用。
+   */
+  int create_proxy(const AABox2d& aabox, const UserData& user_data) {
+    const int proxy = allocate_node();
+    Node& node = _nodes[proxy];
+    node.set_fat_bounds(aabox, _margin);
+    node.user_data = user_data;
+    node.height = 0;
+    insert_leaf(proxy);
+    ++_num_proxies;
+    return proxy;
+  }
+
+  // 删除一个对象
+  void destroy_proxy(const int proxy) {
+    assert(is_leaf(proxy));
+    remove_leaf(proxy);
+    free_node(proxy);
+    --_num_proxies;
+  }
+
+  /*
+   * 对象的盒子变为'aabox'。
+   * 仍然在叶子的扩展盒子之内时什么都不做并返回false，否则重新插入并返回true。
+   */
+  bool move_proxy(const int proxy, const AABox2d& aabox) {
+    assert(is_leaf(proxy));
+    if (_nodes[proxy].contains(aabox)) {
+      return false;
+    }
+    remove_leaf(proxy);
+    _nodes[proxy].set_fat_bounds(aabox, _margin);
+    insert_leaf(proxy);
+    return true;
+  }
+
+  const UserData& get_user_data(const int proxy) const {
+    assert(is_leaf(proxy));
+    return _nodes[proxy].user_data;
+  }
+
+  // 叶子保存的扩展盒子
+  AABox2d get_fat_aabox(const int proxy) const {
+    assert(proxy >= 0 && proxy < static_cast<int>(_nodes.size()));
+    return _nodes[proxy].aabox();
+  }
+
+  /*
+   * 对扩展盒子与'aabox'重叠的每一个对象调用'visitor(proxy)'，
+   * 'visitor'返回false时停止，被停止时返回false。
+   */
+  template <typename Visitor>
+  bool query(const AABox2d& aabox, Visitor&& visitor) const {
+    if (_root == kNullNode) {
+      return true;
+    }
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+      const int index = stack.back();
+      stack.pop_back();
+      const Node& node = _nodes[index];
+      if (!node.overlaps(aabox.min_x(), aabox.max_x(),
+                         aabox.min_y(), aabox.max_y())) {
+        continue;
+      }
+      if (node.is_leaf()) {
+        if (!visitor(index)) {
+          return false;
+        }
+      } else {
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+      }
+    }
+    return true;
+  }
+
+  // 获取扩展盒子与'aabox'重叠的对象的用户数据
+  std::vector<UserData> get_objects(const AABox2d& aabox) const {
+    std::vector<UserData> result;
+    query(aabox, [this, &result](const int proxy) {
+      result.push_back(_nodes[proxy].user_data);
+      return true;
+    });
+    return result;
+  }
+
+  /*
+   * 枚举扩展盒子相互重叠的所有对象对，结果写入'pairs'，
+   * 每一对只出现一次，且pair.first的proxy编号小于pair.second。
+   * 返回的是候选对，需要再用精确的几何(Box2d、Polygon2d)检测。
+   */
+  void get_overlapping_pairs(
+      std::vector<std::pair<UserData, UserData>>* const pairs) const {
+    assert(pairs);
+    pairs->clear();
+    if (_root == kNullNode || _nodes[_root].is_leaf()) {
+      return;
+    }
+    // 同时遍历两棵子树，避免逐个叶子查询时对内部节点的重复测试
+    std::vector<std::pair<int, int>> stack;
+    stack.reserve(64);
+    stack.emplace_back(_root, _root);
+    while (!stack.empty()) {
+      const int a = stack.back().first;
+      const int b = stack.back().second;
+      stack.pop_back();
+      const Node& node_a = _nodes[a];
+      const Node& node_b = _nodes[b];
+      if (a == b) {
+        // 同一个子树内部的重叠对
+        if (!node_a.is_leaf()) {
+          stack.emplace_back(node_a.left, node_a.left);
+          stack.emplace_back(node_a.right, node_a.right);
+          stack.emplace_back(node_a.left, node_a.right);
+        }
+        continue;
+      }
+      if (!node_a.overlaps(node_b)) {
+        continue;
+      }
+      if (node_a.is_leaf() && node_b.is_leaf()) {
+        if (a < b) {
+          pairs->emplace_back(node_a.user_data, node_b.user_data);
+        } else {
+          pairs->emplace_back(node_b.user_data, node_a.user_data);
+        }
+      } else if (node_b.is_leaf() ||
+                 (!node_a.is_leaf() && node_a.perimeter() >= node_b.perimeter())) {
+        // 展开较大的节点
+        stack.emplace_back(node_a.left, b);
+        stack.emplace_back(node_a.right, b);
+      } else {
+        stack.emplace_back(a, node_b.left);
+        stack.emplace_back(a, node_b.right);
+      }
+    }
+  }
+
+  // 对象数量
+  int size() const { return _num_proxies; }
+
+  // 树的高度，空树为-1，只有一个对象时为0
+  int height() const { return _root == kNullNode ? -1 : _nodes[_root].height; }
+
+  // 所有内部节点周长之和与根节点周长的比值，用于衡量树的质量
+  double area_ratio() const {
+    if (_root == kNullNode) {
+      return 0.0;
+    }
+    const double root_perimeter = _nodes[_root].perimeter();
+    if (root_perimeter <= 0.0) {
+      return 0.0;
+    }
+    double total = 0.0;
+    for (const Node& node : _nodes) {
+      if (node.height > 0) {
+        total += node.perimeter();
+      }
+    }
+    return total / root_perimeter;
+  }
+
+  // 检查树的结构(父子关系、高度、包围盒)是否一致，用于调试
+  bool is_valid() const {
+    if (_root == kNullNode) {
+      return _num_proxies == 0;
+    }
+    if (_nodes[_root].parent != kNullNode) {
+      return false;
+    }
+    int num_leaves = 0;
+    return is_valid_subtree(_root, &num_leaves) && num_leaves == _num_proxies;
+  }
+
+private:
+  struct Node {
+    double min_x = 0.0;
+    double max_x = 0.0;
+    double min_y = 0.0;
+    double max_y = 0.0;
+    int parent = kNullNode;             // 父节点；空闲节点中为下一个空闲节点
+    int left = kNullNode;
+    int right = kNullNode;
+    int height = -1;                    // 叶子为0，空闲节点为-1
+    UserData user_data = UserData();
+
+    bool is_leaf() const { return left == kNullNode; }
+
+    AABox2d aabox() const { return AABox2d({min_x, min_y}, {max_x, max_y}); }
+
+    double perimeter() const { return 2.0 * ((max_x - min_x) + (max_y - min_y)); }
+
+    void set_fat_bounds(const AABox2d& box, const double margin) {
+      min_x = box.min_x() - margin;
+      max_x = box.max_x() + margin;
+      min_y = box.min_y() - margin;
+      max_y = box.max_y() + margin;
+    }
+
+    void set_union(const Node& a, const Node& b) {
+      min_x = std::fmin(a.min_x, b.min_x);
+      max_x = std::fmax(a.max_x, b.max_x);
+      min_y = std::fmin(a.min_y, b.min_y);
+      max_y = std::fmax(a.max_y, b.max_y);
+    }
+
+    bool contains(const AABox2d& box) const {
+      return box.min_x() >= min_x && box.max_x() <= max_x &&
+             box.min_y() >= min_y && box.max_y() <= max_y;
+    }
+
+    bool overlaps(const double other_min_x, const double other_max_x,
+                  const double other_min_y, const double other_max_y) const {
+      return !(other_min_x > max_x || other_max_x < min_x ||
+               other_min_y > max_y || other_max_y < min_y);
+    }
+
+    bool overlaps(const Node& other) const {
+      return overlaps(other.min_x, other.max_x, other.min_y, other.max_y);
+    }
+  };
+
+  // 两个节点合并后盒子的周长
+  static double union_perimeter(const Node& a, const Node& b) {
+    return 2.0 * ((std::fmax(a.max_x, b.max_x) - std::fmin(a.min_x, b.min_x)) +
+                  (std::fmax(a.max_y, b.max_y) - std::fmin(a.min_y, b.min_y)));
+  }
+
+  bool is_leaf(const int index) const {
+    return index >= 0 && index < static_cast<int>(_nodes.size()) &&
+           _nodes[index].height == 0;
+  }
+
+  int allocate_node() {
+    if (_free_list == kNullNode) {
+      _nodes.emplace_back();
+      return static_cast<int>(_nodes.size()) - 1;
+    }
+    const int index = _free_list;
+    _free_list = _nodes[index].parent;
+    _nodes[index] = Node();
+    return index;
+  }
+
+  void free_node(const int index) {
+    _nodes[index] = Node();
+    _nodes[index].parent = _free_list;
+    _free_list = index;
+  }
+
+  void insert_leaf(const int leaf) {
+    if (_root == kNullNode) {
+      _root = leaf;
+      _nodes[leaf].parent = kNullNode;
+      return;
+    }
+
+    // 沿着代价最小的方向下降，寻找最佳的兄弟节点
+    const Node& leaf_node = _nodes[leaf];
+    int index = _root;
+    while (!_nodes[index].is_leaf()) {
+      const Node& node = _nodes[index];
+      const double perimeter = node.perimeter();
+      const double combined_perimeter = union_perimeter(node, leaf_node);
+      // 在当前节点创建新的父节点的代价
+      const double cost = 2.0 * combined_perimeter;
+      // 继续下降时所有祖先节点增加的代价
+      const double inheritance_cost = 2.0 * (combined_perimeter - perimeter);
+      auto child_cost = [&](const int child) {
+        const Node& child_node = _nodes[child];
+        const double new_perimeter = union_perimeter(child_node, leaf_node);
+        return child_node.is_leaf() ?
+          new_perimeter + inheritance_cost :
+          new_perimeter - child_node.perimeter() + inheritance_cost;
+      };
+      const double cost_left = child_cost(node.left);
+      const double cost_right = child_cost(node.right);
+      if (cost < cost_left && cost < cost_right) {
+        break;
+      }
+      index = cost_left < cost_right ? node.left : node.right;
+    }
+    const int sibling = index;
+
+    // 创建新的父节点
+    const int old_parent = _nodes[sibling].parent;
+    const int new_parent = allocate_node();
+    Node& parent_node = _nodes[new_parent];
+    parent_node.parent = old_parent;
+    parent_node.set_union(_nodes[leaf], _nodes[sibling]);
+    parent_node.height = _nodes[sibling].height + 1;
+    parent_node.left = sibling;
+    parent_node.right = leaf;
+    _nodes[sibling].parent = new_parent;
+    _nodes[leaf].parent = new_parent;
+    if (old_parent == kNullNode) {
+      _root = new_parent;
+    } else if (_nodes[old_parent].left == sibling) {
+      _nodes[old_parent].left = new_parent;
+    } else {
+      _nodes[old_parent].right = new_parent;
+    }
+
+    refit_ancestors(new_parent);
+  }
+
+  void remove_leaf(const int leaf) {
+    if (leaf == _root) {
+      _root = kNullNode;
+      return;
+    }
+    const int parent = _nodes[leaf].parent;
+    const int grand_parent = _nodes[parent].parent;
+    const int sibling = _nodes[parent].left == leaf ?
+      _nodes[parent].right : _nodes[parent].left;
+    if (grand_parent == kNullNode) {
+      _root = sibling;
+      _nodes[sibling].parent = kNullNode;
+      free_node(parent);
+      return;
+    }
+    // 用兄弟节点替换父节点
+    if (_nodes[grand_parent].left == parent) {
+      _nodes[grand_parent].left = sibling;
+    } else {
+      _nodes[grand_parent].right = sibling;
+    }
+    _nodes[sibling].parent = grand_parent;
+    free_node(parent);
+    refit_ancestors(grand_parent);
+  }
+
+  // 从'index'向上平衡并更新盒子与高度
+  void refit_ancestors(int index) {
+    while (index != kNullNode) {
+      index = balance(index);
+      Node& node = _nodes[index];
+      const Node& left = _nodes[node.left];
+      const Node& right = _nodes[node.right];
+      node.height = 1 + std::max(left.height, right.height);
+      node.set_union(left, right);
+      index = node.parent;
+    }
+  }
+
+  /*
+   * 如果节点'a'的两个子树高度相差超过1，把较高的子节点旋转上来，
+   * 返回旋转后位于原来'a'位置的节点。
+   *
+   *         a                c
+   *       /   \            /   \
+   *      b     c    =>    a     f(或g)
+   *           / \        / \
+   *          f   g      b   g(或f)
+   */
+  int balance(const int a) {
+    Node& node_a = _nodes[a];
+    if (node_a.is_leaf() || node_a.height < 2) {
+      return a;
+    }
+    const int b = node_a.left;
+    const int c = node_a.right;
+    const int difference = _nodes[c].height - _nodes[b].height;
+    if (difference > 1) {
+      return rotate_up(a, c, false);
+    }
+    if (difference < -1) {
+      return rotate_up(a, b, true);
+    }
+    return a;
+  }
+
+  // 把'a'的较高子节点'high'旋转到'a'的位置
+  int rotate_up(const int a, const int high, const bool high_is_left) {
+    Node& node_a = _nodes[a];
+    Node& node_high = _nodes[high];
+    const int f = node_high.left;
+    const int g = node_high.right;
+
+    // 'high'取代'a'
+    node_high.left = a;
+    node_high.parent = node_a.parent;
+    node_a.parent = high;
+    if (node_high.parent == kNullNode) {
+      _root = high;
+    } else if (_nodes[node_high.parent].left == a) {
+      _nodes[node_high.parent].left = high;
+    } else {
+      _nodes[node_high.parent].right = high;
+    }
+
+    // 'high'较高的子节点留下，较低的子节点交给'a'
+    const bool keep_f = _nodes[f].height > _nodes[g].height;
+    const int keep = keep_f ? f : g;
+    const int give = keep_f ? g : f;
+    node_high.right = keep;
+    if (high_is_left) {
+      node_a.left = give;
+    } else {
+      node_a.right = give;
+    }
+    _nodes[give].parent = a;
+
+    node_a.set_union(_nodes[node_a.left], _nodes[node_a.right]);
+    node_a.height = 1 + std::max(_nodes[node_a.left].height,
+                                 _nodes[node_a.right].height);
+    node_high.set_union(node_a, _nodes[keep]);
+    node_high.height = 1 + std::max(node_a.height, _nodes[keep].height);
+    return high;
+  }
+
+  bool is_valid_subtree(const int index, int* const num_leaves) const {
+    const Node& node = _nodes[index];
+    if (node.is_leaf()) {
+      ++*num_leaves;
+      return node.height == 0 && node.right == kNullNode;
+    }
+    const Node& left = _nodes[node.left];
+    const Node& right = _nodes[node.right];
+    if (left.parent != index || right.parent != index ||
+        node.height != 1 + std::max(left.height, right.height)) {
+      return false;
+    }
+    if (node.min_x != std::fmin(left.min_x, right.min_x) ||
+        node.max_x != std::fmax(left.max_x, right.max_x) ||
+        node.min_y != std::fmin(left.min_y, right.min_y) ||
+        node.max_y != std::fmax(left.max_y, right.max_y)) {
+      return false;
+    }
+    return is_valid_subtree(node.left, num_leaves) &&
+           is_valid_subtree(node.right, num_leaves);
+  }
+
+private:
+  double _margin = kDynamicAABoxTreeDefaultMargin;
+  std::vector<Node> _nodes;
+  int _root = kNullNode;
+  int _free_list = kNullNode;
+  int _num_proxies = 0;
+};
+
+template <typename UserData>
+constexpr int DynamicAABoxTree2d<UserData>::kNullNode;
+
+}}
+
+#endif
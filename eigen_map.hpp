@@ -0,0 +1,139 @@
+#ifndef MYMATH_EIGEN_MAP_HPP
+#define MYMATH_EIGEN_MAP_HPP
+
+#include <vector>
+#include <cassert>
+#include <type_traits>
+
+#include <Eigen/Dense>
+
+#include "vec2d.hpp"
+#include "polygon2d.hpp"
+#include "my_path_point.hpp"
+#include "my_trajectory_point.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * Vec2d、PathPoint、TrajectoryPoint缓冲区与Eigen矩阵之间的零拷贝映射
+ *
+ * 连续的Vec2d数组在内存中就是按列存放的2xN矩阵，可以直接映射；
+ * PathPoint与TrajectoryPoint带有虚函数表，x与y之后还有其它成员，
+ * 映射为列间距为对象大小的2xN矩阵。映射不持有数据，原缓冲区改变大小后映射失效。
+ */
+
+static_assert(std::is_standard_layout<Vec2d>::value,
+              "Vec2d must be standard layout to be mapped");
+static_assert(sizeof(Vec2d) == 2 * sizeof(double),
+              "Vec2d must be exactly two packed doubles to be mapped");
+static_assert(sizeof(PathPoint) % sizeof(double) == 0,
+              "PathPoint size must be a multiple of double");
+static_assert(sizeof(TrajectoryPoint) % sizeof(double) == 0,
+              "TrajectoryPoint size must be a multiple of double");
+
+using Matrix2Xd = Eigen::Matrix<double, 2, Eigen::Dynamic>;
+using Vec2dMatrixMap = Eigen::Map<Matrix2Xd>;
+using ConstVec2dMatrixMap = Eigen::Map<const Matrix2Xd>;
+using StridedVec2dMatrixMap =
+  Eigen::Map<Matrix2Xd, Eigen::Unaligned, Eigen::OuterStride<>>;
+using ConstStridedVec2dMatrixMap =
+  Eigen::Map<const Matrix2Xd, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+// 把'n'个连续的Vec2d映射为2xN矩阵
+inline ConstVec2dMatrixMap as_matrix(const Vec2d* const points, const int n) {
+  return ConstVec2dMatrixMap(reinterpret_cast<const double*>(points), 2, n);
+}
+
+inline Vec2dMatrixMap as_matrix(Vec2d* const points, const int n) {
+  return Vec2dMatrixMap(reinterpret_cast<double*>(points), 2, n);
+}
+
+inline ConstVec2dMatrixMap as_matrix(const std::vector<Vec2d>& points) {
+  return as_matrix(points.data(), static_cast<int>(points.size()));
+}
+
+inline Vec2dMatrixMap as_matrix(std::vector<Vec2d>* const points) {
+  assert(points);
+  return as_matrix(points->data(), static_cast<int>(points->size()));
+}
+
+// 多边形的顶点
+inline ConstVec2dMatrixMap as_matrix(const Polygon2d& polygon) {
+  return as_matrix(polygon.points());
+}
+
+// 路径点的(x, y)
+inline ConstStridedVec2dMatrixMap as_matrix(const std::vector<PathPoint>& points) {
+  const double* const data = points.empty() ? nullptr : points[0].xy_data();
+  return ConstStridedVec2dMatrixMap(
+    data, 2, static_cast<int>(points.size()),
+    Eigen::OuterStride<>(sizeof(PathPoint) / sizeof(double)));
+}
+
+inline StridedVec2dMatrixMap as_matrix(std::vector<PathPoint>* const points) {
+  assert(points);
+  double* const data = points->empty() ? nullptr : (*points)[0].mutable_xy_data();
+  return StridedVec2dMatrixMap(
+    data, 2, static_cast<int>(points->size()),
+    Eigen::OuterStride<>(sizeof(PathPoint) / sizeof(double)));
+}
+
+// 轨迹点中路径点的(x, y)
+inline ConstStridedVec2dMatrixMap as_matrix(
+    const std::vector<TrajectoryPoint>& points) {
+  const double* const data =
+    points.empty() ? nullptr : points[0].path_point().xy_data();
+  return ConstStridedVec2dMatrixMap(
+    data, 2, static_cast<int>(points.size()),
+    Eigen::OuterStride<>(sizeof(TrajectoryPoint) / sizeof(double)));
+}
+
+inline StridedVec2dMatrixMap as_matrix(
+    std::vector<TrajectoryPoint>* const points) {
+  assert(points);
+  double* const data = points->empty() ? nullptr :
+    (*points)[0].mutable_path_point()->mutable_xy_data();
+  return StridedVec2dMatrixMap(
+    data, 2, static_cast<int>(points->size()),
+    Eigen::OuterStride<>(sizeof(TrajectoryPoint) / sizeof(double)));
+}
+
+/*
+ * 把按列存放的2xN矩阵看作连续的Vec2d，支持下标访问与范围for循环。
+ * V为Vec2d或者const Vec2d。
+ */
+template <typename V>
+class Vec2dView {
+public:
+  Vec2dView(V* const data, const int size) : _data(data), _size(size) {}
+
+  int size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  V* data() const { return _data; }
+  V* begin() const { return _data; }
+  V* end() const { return _data + _size; }
+  V& operator[](const int i) const {
+    assert(i >= 0 && i < _size);
+    return _data[i];
+  }
+
+private:
+  V* _data = nullptr;
+  int _size = 0;
+};
+
+inline Vec2dView<const Vec2d> as_vec2d(const Matrix2Xd& matrix) {
+  return Vec2dView<const Vec2d>(reinterpret_cast<const Vec2d*>(matrix.data()),
+                                static_cast<int>(matrix.cols()));
+}
+
+inline Vec2dView<Vec2d> as_vec2d(Matrix2Xd* const matrix) {
+  assert(matrix);
+  return Vec2dView<Vec2d>(reinterpret_cast<Vec2d*>(matrix->data()),
+                          static_cast<int>(matrix->cols()));
+}
+
+}}
+
+#endif
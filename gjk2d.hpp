@@ -0,0 +1,518 @@
+#ifndef MYMATH_GJK2D_HPP
+#define MYMATH_GJK2D_HPP
+
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+#include "math_utils.hpp"
+#include "vec2d.hpp"
+#include "line_segment2d.hpp"
+#include "aabox2d.hpp"
+#include "box2d.hpp"
+#include "polygon2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+static constexpr int kGJKMaxIterations = 64;
+static constexpr int kEPAMaxVertices = 128;
+
+/*
+ * 凸形状的支撑函数，返回形状上沿'direction'方向投影最远的点。
+ * 其他凸形状只需在自己的命名空间中提供同名的重载，即可用于GJK2。
+ */
+template <typename T>
+Vec2<T> support_point(const Vec2<T>& point, const Vec2<T>& /*direction*/) {
+  return point;
+}
+
+template <typename T>
+Vec2<T> support_point(const LineSegment2<T>& line_segment,
+                      const Vec2<T>& direction) {
+  return direction.inner_prod(line_segment.end() - line_segment.start()) > 0
+             ? line_segment.end()
+             : line_segment.start();
+}
+
+template <typename T>
+Vec2<T> support_point(const AABox2<T>& box, const Vec2<T>& direction) {
+  return Vec2<T>(
+    direction.x() >= 0 ? box.max_x() : box.min_x(),
+    direction.y() >= 0 ? box.max_y() : box.min_y());
+}
+
+template <typename T>
+Vec2<T> support_point(const Box2<T>& box, const Vec2<T>& direction) {
+  // 航向轴(cos, sin)与宽度轴(sin, -cos)上分别取半长与半宽
+  const T proj_x =
+    direction.x() * box.cos_heading() + direction.y() * box.sin_heading();
+  const T proj_y =
+    direction.x() * box.sin_heading() - direction.y() * box.cos_heading();
+  const T dl = proj_x >= 0 ? box.half_length() : -box.half_length();
+  const T dw = proj_y >= 0 ? box.half_width() : -box.half_width();
+  return Vec2<T>(box.center_x() + dl * box.cos_heading() + dw * box.sin_heading(),
+                 box.center_y() + dl * box.sin_heading() - dw * box.cos_heading());
+}
+
+// 非凸多边形按照其凸包处理，凸多边形的极点为二分查找
+template <typename T>
+Vec2<T> support_point(const Polygon2<T>& polygon, const Vec2<T>& direction) {
+  return polygon.extreme_point(direction);
+}
+
+/*
+ * GJK的单纯形缓存，用于热启动
+ *
+ * 保存上一次查询结束时单纯形各个顶点的搜索方向。两个形状在帧与帧之间移动很小时，
+ * 用这些方向重新求支撑点得到的单纯形已经接近结果，迭代次数明显减少。
+ */
+template <typename T>
+struct GJKSimplex2 {
+  int size = 0;
+  Vec2<T> directions[3];
+};
+
+// GJK距离查询的结果
+template <typename T>
+struct GJKResult2 {
+  bool overlap = false;
+  T distance = 0;                       // 重叠时为0
+  Vec2<T> point_a;                      // 形状A上的最近点
+  Vec2<T> point_b;                      // 形状B上的最近点
+  int num_iterations = 0;
+};
+
+// EPA穿透查询的结果，形状B沿'normal'移动'depth'后与形状A刚好接触
+template <typename T>
+struct PenetrationResult2 {
+  T depth = 0;
+  Vec2<T> normal;                       // 单位向量，由A指向B
+  Vec2<T> point_a;                      // A在B内最深的点
+  Vec2<T> point_b;                      // B在A内最深的点
+};
+
+/*
+ * 基于GJK/EPA的凸形状距离、重叠与穿透深度查询
+ *
+ * 形状只通过support_point()访问，在形状A与B的闵可夫斯基差A - B上迭代：
+ * 维护最多3个顶点的单纯形，每次求单纯形上离原点最近的点，并沿指向原点的方向取
+ * 新的支撑点，单纯形包含原点即为重叠，否则最近点的长度即为距离。
+ * 一次查询的代价约为迭代次数乘以支撑函数的代价，与两个多边形顶点数的乘积无关。
+ *
+ * 穿透深度由EPA计算：从GJK结束时包含原点的三角形出发，不断沿离原点最近的边的外法线
+ * 取支撑点扩展多边形，直到该边不再外扩，此时边到原点的距离即为穿透深度。
+ * 扩展的顶点保存在栈上的固定数组中，查询过程不分配内存。
+ */
+template <typename T>
+class GJK2 {
+public:
+  /*
+   * 计算两个凸形状的距离，重叠时返回0。
+   * 'result'不为空时写入最近点与迭代次数，'simplex'不为空时用于热启动并写回。
+   */
+  template <typename ShapeA, typename ShapeB>
+  static T distance(const ShapeA& a, const ShapeB& b,
+                    GJKResult2<T>* const result = nullptr,
+                    GJKSimplex2<T>* const simplex = nullptr) {
+    Simplex s;
+    int num_iterations = 0;
+    const bool overlap = solve_gjk(a, b, false, &s, simplex, &num_iterations);
+    Vec2<T> point_a;
+    Vec2<T> point_b;
+    witness_points(s, &point_a, &point_b);
+    const T distance = overlap ? T(0) : point_a.distance_to(point_b);
+    if (result) {
+      result->overlap = overlap;
+      result->distance = distance;
+      result->point_a = point_a;
+      result->point_b = point_b;
+      result->num_iterations = num_iterations;
+    }
+    return distance;
+  }
+
+  // 两个凸形状是否重叠(边界接触视为重叠)，找到分离方向后立即返回
+  template <typename ShapeA, typename ShapeB>
+  static bool has_overlap(const ShapeA& a, const ShapeB& b,
+                          GJKSimplex2<T>* const simplex = nullptr) {
+    Simplex s;
+    return solve_gjk(a, b, true, &s, simplex, nullptr);
+  }
+
+  /*
+   * 计算两个凸形状的穿透深度，不重叠时返回false。
+   */
+  template <typename ShapeA, typename ShapeB>
+  static bool penetration(const ShapeA& a, const ShapeB& b,
+                          PenetrationResult2<T>* const result,
+                          GJKSimplex2<T>* const simplex = nullptr) {
+    assert(result);
+    Simplex s;
+    if (!solve_gjk(a, b, false, &s, simplex, nullptr)) {
+      return false;
+    }
+
+    Vertex polytope[kEPAMaxVertices];
+    int n = s.count;
+    for (int i = 0; i < n; ++i) {
+      polytope[i] = s.v[i];
+    }
+    // GJK在原点落在顶点或者边上时提前结束，补齐为三角形
+    if (n == 1) {
+      for (const Vec2<T>& direction : {Vec2<T>(1, 0), Vec2<T>(-1, 0),
+                                       Vec2<T>(0, 1), Vec2<T>(0, -1)}) {
+        const Vertex vertex = make_vertex(a, b, direction);
+        if (vertex.w.distance_square_to(polytope[0].w) > square_epsilon()) {
+          polytope[n++] = vertex;
+          break;
+        }
+      }
+    }
+    if (n == 2) {
+      const Vec2<T> e = polytope[1].w - polytope[0].w;
+      for (const Vec2<T>& direction : {Vec2<T>(-e.y(), e.x()),
+                                       Vec2<T>(e.y(), -e.x())}) {
+        const Vertex vertex = make_vertex(a, b, direction);
+        if (std::abs(e.cross_prod(vertex.w - polytope[0].w)) >
+            math_epsilon_of<T>() * e.length()) {
+          polytope[n++] = vertex;
+          break;
+        }
+      }
+    }
+    if (n < 3) {
+      // 闵可夫斯基差退化为线段或者点，两个形状只是接触
+      result->depth = 0;
+      result->normal = Vec2<T>(1, 0);
+      witness_points(s, &result->point_a, &result->point_b);
+      return true;
+    }
+    if ((polytope[1].w - polytope[0].w).cross_prod(polytope[2].w - polytope[0].w) < 0) {
+      std::swap(polytope[1], polytope[2]);
+    }
+
+    int edge = 0;
+    T edge_distance = 0;
+    Vec2<T> edge_normal;
+    while (true) {
+      // 逆时针多边形上离原点最近的边，外法线为边方向顺时针旋转90度
+      edge_distance = std::numeric_limits<T>::infinity();
+      for (int i = 0; i < n; ++i) {
+        const Vec2<T> e = polytope[(i + 1) % n].w - polytope[i].w;
+        const T length = e.length();
+        if (length <= math_epsilon_of<T>()) {
+          continue;
+        }
+        const Vec2<T> normal(e.y() / length, -e.x() / length);
+        const T distance = normal.inner_prod(polytope[i].w);
+        if (distance < edge_distance) {
+          edge_distance = distance;
+          edge_normal = normal;
+          edge = i;
+        }
+      }
+      if (n == kEPAMaxVertices) {
+        break;
+      }
+      const Vertex vertex = make_vertex(a, b, edge_normal);
+      if (vertex.w.inner_prod(edge_normal) - edge_distance <=
+          math_epsilon_of<T>() * std::max(T(1), vertex.w.length())) {
+        break;
+      }
+      for (int i = n; i > edge + 1; --i) {
+        polytope[i] = polytope[i - 1];
+      }
+      polytope[edge + 1] = vertex;
+      ++n;
+    }
+
+    // 原点在最近边上的投影对应两个形状上的点
+    const Vertex& v1 = polytope[edge];
+    const Vertex& v2 = polytope[(edge + 1) % n];
+    const Vec2<T> e = v2.w - v1.w;
+    const T t = clamp(-v1.w.inner_prod(e) / std::max(e.length_square(), square_epsilon()),
+                      T(0), T(1));
+    result->depth = std::max(T(0), edge_distance);
+    result->normal = edge_normal;
+    result->point_a = v1.a + (v2.a - v1.a) * t;
+    result->point_b = v1.b + (v2.b - v1.b) * t;
+    return true;
+  }
+
+private:
+  // 闵可夫斯基差上的顶点
+  struct Vertex {
+    Vec2<T> a;                          // 形状A上的支撑点
+    Vec2<T> b;                          // 形状B上的支撑点
+    Vec2<T> w;                          // a - b
+    Vec2<T> direction;                  // 求支撑点的方向
+    T u = 0;                            // 最近点的重心坐标
+  };
+
+  struct Simplex {
+    Vertex v[3];
+    int count = 0;
+  };
+
+  static T square_epsilon() {
+    return math_epsilon_of<T>() * math_epsilon_of<T>();
+  }
+
+  template <typename ShapeA, typename ShapeB>
+  static Vertex make_vertex(const ShapeA& a, const ShapeB& b,
+                            const Vec2<T>& direction) {
+    Vertex vertex;
+    vertex.a = support_point(a, direction);
+    vertex.b = support_point(b, Vec2<T>(-direction.x(), -direction.y()));
+    vertex.w = vertex.a - vertex.b;
+    vertex.direction = direction;
+    return vertex;
+  }
+
+  /*
+   * GJK迭代，返回是否重叠，结束时's'为最小的单纯形及其重心坐标。
+   * 'stop_if_separated'为true时，支撑点说明存在分离方向后立即返回。
+   */
+  template <typename ShapeA, typename ShapeB>
+  static bool solve_gjk(const ShapeA& a, const ShapeB& b,
+                        const bool stop_if_separated, Simplex* const s,
+                        GJKSimplex2<T>* const cache, int* const num_iterations) {
+    s->count = 0;
+    bool separated = false;
+    if (cache) {
+      assert(cache->size >= 0 && cache->size <= 3);
+      for (int i = 0; i < cache->size && !separated; ++i) {
+        const Vertex vertex = make_vertex(a, b, cache->directions[i]);
+        separated = stop_if_separated && vertex.direction.inner_prod(vertex.w) < 0;
+        if (!is_duplicate(*s, vertex)) {
+          s->v[s->count++] = vertex;
+        }
+      }
+      // 三个顶点共线时无法构成三角形
+      if (s->count == 3 &&
+          std::abs((s->v[1].w - s->v[0].w).cross_prod(s->v[2].w - s->v[0].w)) <=
+            square_epsilon()) {
+        s->count = 2;
+      }
+    }
+    if (s->count == 0) {
+      s->v[s->count++] = make_vertex(a, b, Vec2<T>(1, 0));
+    }
+
+    bool overlap = false;
+    int iteration = 0;
+    while (true) {
+      solve(s);
+      if (s->count == 3) {
+        overlap = true;
+        break;
+      }
+      const Vec2<T> closest = closest_point(*s);
+      const T closest_square = closest.length_square();
+      if (closest_square <= square_epsilon()) {
+        overlap = true;
+        break;
+      }
+      if (separated || iteration >= kGJKMaxIterations) {
+        break;
+      }
+      ++iteration;
+
+      const Vertex vertex = make_vertex(a, b, search_direction(*s));
+      if (stop_if_separated && vertex.direction.inner_prod(vertex.w) < 0) {
+        // 保留分离方向，下一次热启动时第一个顶点即可判定分离
+        s->count = 1;
+        s->v[0] = vertex;
+        s->v[0].u = 1;
+        break;
+      }
+      // 新的支撑点不能使最近点更靠近原点时收敛
+      if (closest_square - closest.inner_prod(vertex.w) <=
+          math_epsilon_of<T>() * closest_square) {
+        break;
+      }
+      if (is_duplicate(*s, vertex)) {
+        break;
+      }
+      s->v[s->count++] = vertex;
+    }
+
+    if (num_iterations) {
+      *num_iterations = iteration;
+    }
+    if (cache) {
+      cache->size = s->count;
+      for (int i = 0; i < s->count; ++i) {
+        cache->directions[i] = s->v[i].direction;
+      }
+    }
+    return overlap;
+  }
+
+  static bool is_duplicate(const Simplex& s, const Vertex& vertex) {
+    for (int i = 0; i < s.count; ++i) {
+      if (s.v[i].w.distance_square_to(vertex.w) <= square_epsilon()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 将单纯形缩减为包含离原点最近点的最小子集，并计算重心坐标
+  static void solve(Simplex* const s) {
+    if (s->count == 1) {
+      s->v[0].u = 1;
+    } else if (s->count == 2) {
+      solve2(s);
+    } else if (s->count == 3) {
+      solve3(s);
+    }
+  }
+
+  static void solve2(Simplex* const s) {
+    const Vec2<T> w1 = s->v[0].w;
+    const Vec2<T> w2 = s->v[1].w;
+    const Vec2<T> e12 = w2 - w1;
+
+    // 在w1一侧的顶点区域
+    const T d12_2 = -w1.inner_prod(e12);
+    if (d12_2 <= 0) {
+      s->v[0].u = 1;
+      s->count = 1;
+      return;
+    }
+    // 在w2一侧的顶点区域
+    const T d12_1 = w2.inner_prod(e12);
+    if (d12_1 <= 0) {
+      s->v[0] = s->v[1];
+      s->v[0].u = 1;
+      s->count = 1;
+      return;
+    }
+    const T inv_d12 = 1 / (d12_1 + d12_2);
+    s->v[0].u = d12_1 * inv_d12;
+    s->v[1].u = d12_2 * inv_d12;
+  }
+
+  static void solve3(Simplex* const s) {
+    const Vec2<T> w1 = s->v[0].w;
+    const Vec2<T> w2 = s->v[1].w;
+    const Vec2<T> w3 = s->v[2].w;
+
+    const Vec2<T> e12 = w2 - w1;
+    const T d12_1 = w2.inner_prod(e12);
+    const T d12_2 = -w1.inner_prod(e12);
+    const Vec2<T> e13 = w3 - w1;
+    const T d13_1 = w3.inner_prod(e13);
+    const T d13_2 = -w1.inner_prod(e13);
+    const Vec2<T> e23 = w3 - w2;
+    const T d23_1 = w3.inner_prod(e23);
+    const T d23_2 = -w2.inner_prod(e23);
+
+    // 三角形的有向面积
+    const T n123 = e12.cross_prod(e13);
+    const T d123_1 = n123 * w2.cross_prod(w3);
+    const T d123_2 = n123 * w3.cross_prod(w1);
+    const T d123_3 = n123 * w1.cross_prod(w2);
+
+    if (d12_2 <= 0 && d13_2 <= 0) {
+      s->v[0].u = 1;
+      s->count = 1;
+      return;
+    }
+    if (d12_1 > 0 && d12_2 > 0 && d123_3 <= 0) {
+      const T inv_d12 = 1 / (d12_1 + d12_2);
+      s->v[0].u = d12_1 * inv_d12;
+      s->v[1].u = d12_2 * inv_d12;
+      s->count = 2;
+      return;
+    }
+    if (d13_1 > 0 && d13_2 > 0 && d123_2 <= 0) {
+      const T inv_d13 = 1 / (d13_1 + d13_2);
+      s->v[0].u = d13_1 * inv_d13;
+      s->v[1] = s->v[2];
+      s->v[1].u = d13_2 * inv_d13;
+      s->count = 2;
+      return;
+    }
+    if (d12_1 <= 0 && d23_2 <= 0) {
+      s->v[0] = s->v[1];
+      s->v[0].u = 1;
+      s->count = 1;
+      return;
+    }
+    if (d13_1 <= 0 && d23_1 <= 0) {
+      s->v[0] = s->v[2];
+      s->v[0].u = 1;
+      s->count = 1;
+      return;
+    }
+    if (d23_1 > 0 && d23_2 > 0 && d123_1 <= 0) {
+      const T inv_d23 = 1 / (d23_1 + d23_2);
+      s->v[0] = s->v[2];
+      s->v[0].u = d23_2 * inv_d23;
+      s->v[1].u = d23_1 * inv_d23;
+      s->count = 2;
+      return;
+    }
+    const T d123 = d123_1 + d123_2 + d123_3;
+    if (d123 <= 0) {
+      // 退化的三角形，退回到第一条边
+      s->count = 2;
+      solve2(s);
+      return;
+    }
+    // 原点在三角形内
+    const T inv_d123 = 1 / d123;
+    s->v[0].u = d123_1 * inv_d123;
+    s->v[1].u = d123_2 * inv_d123;
+    s->v[2].u = d123_3 * inv_d123;
+  }
+
+  static Vec2<T> closest_point(const Simplex& s) {
+    if (s.count == 1) {
+      return s.v[0].w;
+    }
+    return s.v[0].w * s.v[0].u + s.v[1].w * s.v[1].u;
+  }
+
+  // 从单纯形指向原点的搜索方向
+  static Vec2<T> search_direction(const Simplex& s) {
+    const Vec2<T>& w1 = s.v[0].w;
+    if (s.count == 1) {
+      return Vec2<T>(-w1.x(), -w1.y());
+    }
+    const Vec2<T> e12 = s.v[1].w - w1;
+    if (e12.cross_prod(Vec2<T>(-w1.x(), -w1.y())) > 0) {
+      // 原点在边的左侧
+      return Vec2<T>(-e12.y(), e12.x());
+    }
+    return Vec2<T>(e12.y(), -e12.x());
+  }
+
+  static void witness_points(const Simplex& s, Vec2<T>* const point_a,
+                             Vec2<T>* const point_b) {
+    *point_a = Vec2<T>(0, 0);
+    *point_b = Vec2<T>(0, 0);
+    for (int i = 0; i < s.count; ++i) {
+      *point_a += s.v[i].a * s.v[i].u;
+      *point_b += s.v[i].b * s.v[i].u;
+    }
+  }
+};
+
+using GJK2d = GJK2<double>;
+using GJK2f = GJK2<float>;
+using GJKSimplex2d = GJKSimplex2<double>;
+using GJKSimplex2f = GJKSimplex2<float>;
+using GJKResult2d = GJKResult2<double>;
+using GJKResult2f = GJKResult2<float>;
+using PenetrationResult2d = PenetrationResult2<double>;
+using PenetrationResult2f = PenetrationResult2<float>;
+
+}}
+
+#endif
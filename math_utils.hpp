@@ -36,6 +36,21 @@ double inner_prod(const Vec2d& start_point,
   return (end_point_1 - start_point).inner_prod(end_point_2 - start_point);
 }
 
+// 任意精度(如Vec2f)的cross_prod与inner_prod
+template <typename T>
+T cross_prod(const Vec2<T>& start_point,
+             const Vec2<T>& end_point_1,
+             const Vec2<T>& end_point_2) {
+  return (end_point_1 - start_point).cross_prod(end_point_2 - start_point);
+}
+
+template <typename T>
+T inner_prod(const Vec2<T>& start_point,
+             const Vec2<T>& end_point_1,
+             const Vec2<T>& end_point_2) {
+  return (end_point_1 - start_point).inner_prod(end_point_2 - start_point);
+}
+
 // 计算两条向量的叉积，以原点(0,0)为起点
 double cross_prod(const double x0, const double y0, 
                   const double x1, const double y1) {
@@ -25,6 +25,10 @@ public:
   void set_ddkappa(double ddkappa) { _ddkappa = ddkappa; }
   void set_s(double s) { _s = s; }
 
+  // x与y在内存中连续存放，用于零拷贝的矩阵映射(见eigen_map.hpp)
+  const double* xy_data() const { return &_x; }
+  double* mutable_xy_data() { return &_x; }
+
 private:
   double _x;
   double _y;
@@ -35,6 +39,10 @@ private:
   double _s;
 };
 
+// 虚函数表指针之后的7个double没有填充，按照声明顺序紧密排列，_y紧跟在_x之后
+static_assert(sizeof(PathPoint) == sizeof(void*) + 7 * sizeof(double),
+              "PathPoint members must be packed for xy_data()");
+
 }}
 
 #endif
\ No newline at end of file
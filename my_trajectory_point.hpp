@@ -32,6 +32,11 @@ private:
   bool _has_path_point;
 };
 
+// 除了末尾bool的填充之外没有其它填充，对象大小是double的整数倍，可以作为矩阵映射的列间距
+static_assert(sizeof(TrajectoryPoint) ==
+                sizeof(void*) + 3 * sizeof(double) + sizeof(PathPoint) + sizeof(double),
+              "TrajectoryPoint members must be packed for strided mapping");
+
 }}
 
 #endif
\ No newline at end of file
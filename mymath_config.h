@@ -7,6 +7,8 @@ namespace mymath {
 #define MYMATH_DBG        1           // 启用调试代码
 //#define USE_SIN_TABLE     1           // 启用SIN函数表
 //#define USE_PROTOC        1           // 启用PROTOC的协议代码
+//#define MYMATH_KDTREE_STATS 1         // 启用kdtree查询统计
+//#define MYMATH_DISABLE_SIMD 1         // 禁用SIMD，使用标量实现
 
 }}
 
@@ -0,0 +1,274 @@
+#ifndef MYMATH_POINT_KDTREE_HPP
+#define MYMATH_POINT_KDTREE_HPP
+
+#include <array>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 点集的kdtree
+ *
+ * 与AABoxKDTree2d不同，对象只是'Dim'维的点，没有轴对齐盒子与间接的对象指针：
+ * 构建时点被复制并按照树的顺序重新排列在一段连续的数组中，
+ * 每个叶子节点对应数组中的一段区间。查询返回点在输入中的索引。
+ *
+ * Scalar : 坐标类型(float或者double)
+ * Dim : 维度
+ */
+template <typename Scalar, int Dim>
+class PointKDTree {
+public:
+  using Point = std::array<Scalar, Dim>;
+
+  // 叶子节点包含的最大点数量
+  static constexpr int kDefaultMaxLeafSize = 16;
+
+  PointKDTree() = default;
+
+  explicit PointKDTree(const std::vector<Point>& points,
+                       const int max_leaf_size = kDefaultMaxLeafSize)
+      : _points(points), _max_leaf_size(std::max(1, max_leaf_size)) {
+    build();
+  }
+
+  // 点的数量
+  int size() const { return static_cast<int>(_points.size()); }
+
+  bool empty() const { return _points.empty(); }
+
+  // 按照树的顺序排列的点，以及其在输入中的索引
+  const std::vector<Point>& points() const { return _points; }
+  const std::vector<int>& indices() const { return _indices; }
+
+  /*
+   * 获取离'point'最近的点在输入中的索引，树为空时返回-1。
+   * distance_square : 可选，输出距离的平方
+   */
+  int get_nearest_point(const Point& point,
+                        Scalar* const distance_square = nullptr) const {
+    int nearest = -1;
+    Scalar min_distance_sqr = std::numeric_limits<Scalar>::infinity();
+    if (!_nodes.empty()) {
+      get_nearest_point_internal(0, point, &min_distance_sqr, &nearest);
+    }
+    if (distance_square != nullptr) {
+      *distance_square = min_distance_sqr;
+    }
+    return nearest < 0 ? -1 : _indices[nearest];
+  }
+
+  // 获取离'point'最近的'k'个点的索引，按照距离由近到远排列。
+  std::vector<int> get_k_nearest_points(const Point& point, const int k) const {
+    std::vector<int> result;
+    if (k <= 0 || _nodes.empty()) {
+      return result;
+    }
+    std::vector<std::pair<Scalar, int>> heap;
+    heap.reserve(std::min(k, size()) + 1);
+    get_k_nearest_points_internal(0, point, k, &heap);
+    std::sort_heap(heap.begin(), heap.end());
+    result.reserve(heap.size());
+    for (const auto& item : heap) {
+      result.push_back(_indices[item.second]);
+    }
+    return result;
+  }
+
+  // 获取到'point'的距离不超过'radius'的点的索引
+  std::vector<int> get_points_within(const Point& point,
+                                     const Scalar radius) const {
+    std::vector<int> result;
+    get_points_within(point, radius, &result);
+    return result;
+  }
+
+  // 获取到'point'的距离不超过'radius'的点的索引，结果写入调用者提供的'result'。
+  void get_points_within(const Point& point, const Scalar radius,
+                         std::vector<int>* const result) const {
+    assert(result);
+    result->clear();
+    if (_nodes.empty() || radius < 0) {
+      return;
+    }
+    get_points_within_internal(0, point, radius * radius, result);
+  }
+
+  static Scalar distance_square(const Point& p1, const Point& p2) {
+    Scalar sum = 0;
+    for (int d = 0; d < Dim; ++d) {
+      const Scalar diff = p1[d] - p2[d];
+      sum += diff * diff;
+    }
+    return sum;
+  }
+
+private:
+  struct Node {
+    int begin = 0;                      // 节点在_points中的区间[begin, end)
+    int end = 0;
+    int left = -1;                      // 子节点在_nodes中的索引，叶子节点为-1
+    int right = -1;
+    int axis = 0;                       // 切分轴
+    Scalar position = 0;                // 切分位置
+  };
+
+  void build() {
+    const int n = size();
+    _indices.resize(n);
+    for (int i = 0; i < n; ++i) {
+      _indices[i] = i;
+    }
+    if (n == 0) {
+      return;
+    }
+    _nodes.reserve(2 * (n / _max_leaf_size) + 1);
+    // 先对索引排列，最后一次性按照索引重排点
+    build_node(0, n);
+    std::vector<Point> sorted_points;
+    sorted_points.reserve(n);
+    for (const int index : _indices) {
+      sorted_points.push_back(_points[index]);
+    }
+    _points.swap(sorted_points);
+  }
+
+  int build_node(const int begin, const int end) {
+    const int node_index = static_cast<int>(_nodes.size());
+    _nodes.emplace_back();
+    _nodes[node_index].begin = begin;
+    _nodes[node_index].end = end;
+    if (end - begin <= _max_leaf_size) {
+      return node_index;
+    }
+
+    // 在范围最大的轴上按照中位数切分
+    Point min_point = _points[_indices[begin]];
+    Point max_point = min_point;
+    for (int i = begin + 1; i < end; ++i) {
+      const Point& p = _points[_indices[i]];
+      for (int d = 0; d < Dim; ++d) {
+        min_point[d] = std::min(min_point[d], p[d]);
+        max_point[d] = std::max(max_point[d], p[d]);
+      }
+    }
+    int axis = 0;
+    for (int d = 1; d < Dim; ++d) {
+      if (max_point[d] - min_point[d] > max_point[axis] - min_point[axis]) {
+        axis = d;
+      }
+    }
+    if (max_point[axis] <= min_point[axis]) {
+      // 所有点重合
+      return node_index;
+    }
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(_indices.begin() + begin, _indices.begin() + mid,
+                     _indices.begin() + end, [this, axis](int a, int b) {
+                       return _points[a][axis] < _points[b][axis];
+                     });
+    const Scalar position = _points[_indices[mid]][axis];
+    const int left = build_node(begin, mid);
+    const int right = build_node(mid, end);
+    Node& node = _nodes[node_index];
+    node.axis = axis;
+    node.position = position;
+    node.left = left;
+    node.right = right;
+    return node_index;
+  }
+
+  void get_nearest_point_internal(const int node_index, const Point& point,
+                                  Scalar* const min_distance_sqr,
+                                  int* const nearest) const {
+    const Node& node = _nodes[node_index];
+    if (node.left < 0) {
+      for (int i = node.begin; i < node.end; ++i) {
+        const Scalar distance_sqr = distance_square(_points[i], point);
+        if (distance_sqr < *min_distance_sqr) {
+          *min_distance_sqr = distance_sqr;
+          *nearest = i;
+        }
+      }
+      return;
+    }
+    const Scalar diff = point[node.axis] - node.position;
+    const int near_node = diff < 0 ? node.left : node.right;
+    const int far_node = diff < 0 ? node.right : node.left;
+    get_nearest_point_internal(near_node, point, min_distance_sqr, nearest);
+    if (diff * diff < *min_distance_sqr) {
+      get_nearest_point_internal(far_node, point, min_distance_sqr, nearest);
+    }
+  }
+
+  void get_k_nearest_points_internal(
+      const int node_index, const Point& point, const int k,
+      std::vector<std::pair<Scalar, int>>* const heap) const {
+    const Node& node = _nodes[node_index];
+    if (node.left < 0) {
+      for (int i = node.begin; i < node.end; ++i) {
+        const Scalar distance_sqr = distance_square(_points[i], point);
+        if (static_cast<int>(heap->size()) < k) {
+          heap->emplace_back(distance_sqr, i);
+          std::push_heap(heap->begin(), heap->end());
+        } else if (distance_sqr < heap->front().first) {
+          std::pop_heap(heap->begin(), heap->end());
+          heap->back() = std::make_pair(distance_sqr, i);
+          std::push_heap(heap->begin(), heap->end());
+        }
+      }
+      return;
+    }
+    const Scalar diff = point[node.axis] - node.position;
+    const int near_node = diff < 0 ? node.left : node.right;
+    const int far_node = diff < 0 ? node.right : node.left;
+    get_k_nearest_points_internal(near_node, point, k, heap);
+    if (static_cast<int>(heap->size()) < k || diff * diff < heap->front().first) {
+      get_k_nearest_points_internal(far_node, point, k, heap);
+    }
+  }
+
+  void get_points_within_internal(const int node_index, const Point& point,
+                                  const Scalar radius_sqr,
+                                  std::vector<int>* const result) const {
+    const Node& node = _nodes[node_index];
+    if (node.left < 0) {
+      for (int i = node.begin; i < node.end; ++i) {
+        if (distance_square(_points[i], point) <= radius_sqr) {
+          result->push_back(_indices[i]);
+        }
+      }
+      return;
+    }
+    const Scalar diff = point[node.axis] - node.position;
+    const int near_node = diff < 0 ? node.left : node.right;
+    const int far_node = diff < 0 ? node.right : node.left;
+    get_points_within_internal(near_node, point, radius_sqr, result);
+    if (diff * diff <= radius_sqr) {
+      get_points_within_internal(far_node, point, radius_sqr, result);
+    }
+  }
+
+private:
+  std::vector<Point> _points;           // 按照树的顺序排列的点
+  std::vector<int> _indices;            // _points[i]在输入中的索引
+  std::vector<Node> _nodes;             // 前序排列的节点，_nodes[0]为根节点
+  int _max_leaf_size = kDefaultMaxLeafSize;
+};
+
+template <typename Scalar, int Dim>
+constexpr int PointKDTree<Scalar, Dim>::kDefaultMaxLeafSize;
+
+using PointKDTree2d = PointKDTree<double, 2>;
+using PointKDTree3d = PointKDTree<double, 3>;
+using PointKDTree2f = PointKDTree<float, 2>;
+using PointKDTree3f = PointKDTree<float, 3>;
+
+}}
+
+#endif
@@ -23,33 +23,47 @@
 namespace mypilot {
 namespace mymath {
 
+// 凸多边形的顶点数不少于该值时，极点查询使用二分查找，否则直接遍历
+static constexpr int kPolygonBinarySearchMinPoints = 48;
+
 // 2D-多边形
-class Polygon2d {
+template <typename T>
+class Polygon2 {
 public:
-  Polygon2d() = default;
+  Polygon2() = default;
 
-  explicit Polygon2d(const Box2d& box) {
+  explicit Polygon2(const Box2<T>& box) {
     box.get_all_corners(&_points);
     build_from_points();
   }
 
-  explicit Polygon2d(std::vector<Vec2d> points) : _points(std::move(points)) {
+  explicit Polygon2(std::vector<Vec2<T>> points) : _points(std::move(points)) {
+    build_from_points();
+  }
+
+  // 不同精度之间的转换
+  template <typename U>
+  explicit Polygon2(const Polygon2<U>& other) {
+    _points.reserve(other.num_points());
+    for (const auto& point : other.points()) {
+      _points.emplace_back(point);
+    }
     build_from_points();
   }
 
-  const std::vector<Vec2d>& points() const { return _points; }
-  const std::vector<LineSegment2d>& line_segments() const { return _line_segments; }
+  const std::vector<Vec2<T>>& points() const { return _points; }
+  const std::vector<LineSegment2<T>>& line_segments() const { return _line_segments; }
   int num_points() const { return _num_points; }
   bool is_convex() const { return _is_convex; } // 多边形是否是凸的
-  double area() const { return _area; }
+  T area() const { return _area; }
 
   // 计算点到多边形最短距离,如果点在多边形内返回0。
-  double distance_to(const Vec2d& point) const {
+  T distance_to(const Vec2<T>& point) const {
     assert(_points.size() >= 3);
     if (is_point_in(point)) {
-      return 0.0;
+      return 0;
     }
-    double distance = std::numeric_limits<double>::infinity();
+    T distance = std::numeric_limits<T>::infinity();
     for (int i = 0; i < _num_points; ++i) {
       distance = std::min(distance, _line_segments[i].distance_to(point));
     }
@@ -57,12 +71,12 @@ public:
   }
 
   // 计算点到多边形最短距离的平方,如果点在多边形内返回0。
-  double distance_square_to(const Vec2d& point) const {
+  T distance_square_to(const Vec2<T>& point) const {
     assert(_points.size() >= 3);
     if (is_point_in(point)) {
-      return 0.0;
+      return 0;
     }
-    double distance_sqr = std::numeric_limits<double>::infinity();
+    T distance_sqr = std::numeric_limits<T>::infinity();
     for (int i = 0; i < _num_points; ++i) {
       distance_sqr =
         std::min(distance_sqr, _line_segments[i].distance_square_to(point));
@@ -71,23 +85,23 @@ public:
   }
 
   // 计算线段到多边形最短距离,如果线段与多边形存在交集返回0。
-  double distance_to(const LineSegment2d& line_segment) const {
-    if (line_segment.length() <= math_epsilon) {
+  T distance_to(const LineSegment2<T>& line_segment) const {
+    if (line_segment.length() <= math_epsilon_of<T>()) {
       return distance_to(line_segment.start());
     }
     assert(_points.size() >= 3);
     if (is_point_in(line_segment.center())) {
-      return 0.0;
+      return 0;
     }
     if (std::any_of(_line_segments.begin(), _line_segments.end(),
-                    [&](const LineSegment2d& poly_seg) {
+                    [&](const LineSegment2<T>& poly_seg) {
                       return poly_seg.has_intersect(line_segment);
                     })) {
-      return 0.0;
+      return 0;
     }
 
-    double distance = std::min(distance_to(line_segment.start()),
-                               distance_to(line_segment.end()));
+    T distance = std::min(distance_to(line_segment.start()),
+                          distance_to(line_segment.end()));
     for (int i = 0; i < _num_points; ++i) {
       distance = std::min(distance, line_segment.distance_to(_points[i]));
     }
@@ -95,23 +109,23 @@ public:
   }
 
   // 计算一个方形盒子到多边形最短距离,如果方形盒子与多边形存在交集返回0。
-  double distance_to(const Box2d& box) const {
+  T distance_to(const Box2<T>& box) const {
     assert(_points.size() >= 3);
-    return distance_to(Polygon2d(box));
+    return distance_to(Polygon2(box));
   }
 
   // 计算一个多边形到多边形最短距离,如果多边形与多边形存在交集返回0。
-  double distance_to(const Polygon2d& polygon) const {
+  T distance_to(const Polygon2& polygon) const {
     assert(_points.size() >= 3);
     assert(polygon.num_points() >= 3);
 
     if (is_point_in(polygon.points()[0])) {
-      return 0.0;
+      return 0;
     }
     if (polygon.is_point_in(_points[0])) {
-      return 0.0;
+      return 0;
     }
-    double distance = std::numeric_limits<double>::infinity();
+    T distance = std::numeric_limits<T>::infinity();
     for (int i = 0; i < _num_points; ++i) {
       distance = std::min(distance, polygon.distance_to(_line_segments[i]));
     }
@@ -119,8 +133,8 @@ public:
   }
 
   // 计算一个点到多边形的最短距离
-  double distance_to_boundary(const Vec2d& point) const {
-    double distance = std::numeric_limits<double>::infinity();
+  T distance_to_boundary(const Vec2<T>& point) const {
+    T distance = std::numeric_limits<T>::infinity();
     for (int i = 0; i < _num_points; ++i) {
       distance = std::min(distance, _line_segments[i].distance_to(point));
     }
@@ -128,16 +142,19 @@ public:
   }
 
   // 给定点是否在多边形的边上
-  bool is_point_on_boundary(const Vec2d& point) const {
+  bool is_point_on_boundary(const Vec2<T>& point) const {
     assert(_points.size() >= 3);
     return std::any_of(
         _line_segments.begin(), _line_segments.end(),
-        [&](const LineSegment2d& poly_seg) { return poly_seg.is_point_in(point); });
+        [&](const LineSegment2<T>& poly_seg) { return poly_seg.is_point_in(point); });
   }
 
   // 计算点是否在多边形内
-  bool is_point_in(const Vec2d& point) const {
+  bool is_point_in(const Vec2<T>& point) const {
     assert(_points.size() >= 3);
+    if (_is_convex) {
+      return is_point_in_convex(point);
+    }
     if (is_point_on_boundary(point)) {
       return true;
     }
@@ -145,8 +162,8 @@ public:
     int c = 0;
     for (int i = 0; i < _num_points; ++i) {
       if ((_points[i].y() > point.y()) != (_points[j].y() > point.y())) {
-        const double side = cross_prod(point, _points[i], _points[j]);
-        if (_points[i].y() < _points[j].y() ? side > 0.0 : side < 0.0) {
+        const T side = cross_prod(point, _points[i], _points[j]);
+        if (_points[i].y() < _points[j].y() ? side > 0 : side < 0) {
           ++c;
         }
       }
@@ -156,8 +173,8 @@ public:
   }
 
   // 检查多边形是否包含一条线段
-  bool contains(const LineSegment2d& line_segment) const {
-    if (line_segment.length() <= math_epsilon) {
+  bool contains(const LineSegment2<T>& line_segment) const {
+    if (line_segment.length() <= math_epsilon_of<T>()) {
       return is_point_in(line_segment.start());
     }
     assert(_points.size() >= 3);
@@ -168,20 +185,20 @@ public:
       return false;
     }
     if (!_is_convex) {
-      std::vector<LineSegment2d> overlaps = get_all_overlaps(line_segment);
-      double total_length = 0;
+      std::vector<LineSegment2<T>> overlaps = get_all_overlaps(line_segment);
+      T total_length = 0;
       for (const auto &overlap_seg : overlaps) {
         total_length += overlap_seg.length();
       }
-      return total_length >= line_segment.length() - math_epsilon;
+      return total_length >= line_segment.length() - math_epsilon_of<T>();
     }
     return true;
   }
 
   // 是否包含目标多边形
-  bool contains(const Polygon2d& polygon) const {
+  bool contains(const Polygon2& polygon) const {
     assert(_points.size() >= 3);
-    if (_area < polygon.area() - math_epsilon) {
+    if (_area < polygon.area() - math_epsilon_of<T>()) {
       return false;
     }
     if (!is_point_in(polygon.points()[0])) {
@@ -189,13 +206,13 @@ public:
     }
     const auto& line_segments = polygon.line_segments();
     return std::all_of(line_segments.begin(), line_segments.end(),
-                      [&](const LineSegment2d &line_segment) {
+                      [&](const LineSegment2<T> &line_segment) {
                         return contains(line_segment);
                       });
   }
 
   // 是否与线段包含重回
-  bool has_overlap(const LineSegment2d& line_segment) const {
+  bool has_overlap(const LineSegment2<T>& line_segment) const {
     assert(_points.size() >= 3);
     if ((line_segment.start().x() < _min_x && line_segment.end().x() < _min_x) ||
         (line_segment.start().x() > _max_x && line_segment.end().x() > _max_x) ||
@@ -203,19 +220,19 @@ public:
         (line_segment.start().y() > _max_y && line_segment.end().y() > _max_y)) {
       return false;
     }
-    Vec2d first;
-    Vec2d last;
+    Vec2<T> first;
+    Vec2<T> last;
     return get_overlap(line_segment, &first, &last);
   }
 
   // 获取与线段的重合，返回重叠部分的端点。
-  bool get_overlap(const LineSegment2d& line_segment, Vec2d* const first,
-                   Vec2d* const last) const {
+  bool get_overlap(const LineSegment2<T>& line_segment, Vec2<T>* const first,
+                   Vec2<T>* const last) const {
     assert(_points.size() >= 3);
     assert(first);
     assert(last);
 
-    if (line_segment.length() <= math_epsilon) {
+    if (line_segment.length() <= math_epsilon_of<T>()) {
       if (!is_point_in(line_segment.start())) {
         return false;
       }
@@ -224,20 +241,20 @@ public:
       return true;
     }
 
-    double min_proj = line_segment.length();
-    double max_proj = 0;
+    T min_proj = line_segment.length();
+    T max_proj = 0;
     if (is_point_in(line_segment.start())) {
       *first = line_segment.start();
-      min_proj = 0.0;
+      min_proj = 0;
     }
     if (is_point_in(line_segment.end())) {
       *last = line_segment.end();
       max_proj = line_segment.length();
     }
     for (const auto& poly_seg : _line_segments) {
-      Vec2d pt;
+      Vec2<T> pt;
       if (poly_seg.get_intersect(line_segment, &pt)) {
-        const double proj = line_segment.project_onto_unit(pt);
+        const T proj = line_segment.project_onto_unit(pt);
         if (proj < min_proj) {
           min_proj = proj;
           *first = pt;
@@ -248,55 +265,56 @@ public:
         }
       }
     }
-    return min_proj <= max_proj + math_epsilon;
+    return min_proj <= max_proj + math_epsilon_of<T>();
   }
 
   // 获取线段与多边形的重合,返回线段表示。
-  std::vector<LineSegment2d> get_all_overlaps(const LineSegment2d& line_segment) const {
+  std::vector<LineSegment2<T>> get_all_overlaps(
+      const LineSegment2<T>& line_segment) const {
     assert(_points.size() >= 3);
 
-    if (line_segment.length() <= math_epsilon) {
-      std::vector<LineSegment2d> overlaps;
+    if (line_segment.length() <= math_epsilon_of<T>()) {
+      std::vector<LineSegment2<T>> overlaps;
       if (is_point_in(line_segment.start())) {
         overlaps.push_back(line_segment);
       }
       return overlaps;
     }
-    std::vector<double> projections;
+    std::vector<T> projections;
     if (is_point_in(line_segment.start())) {
-      projections.push_back(0.0);
+      projections.push_back(0);
     }
     if (is_point_in(line_segment.end())) {
       projections.push_back(line_segment.length());
     }
     for (const auto& poly_seg : _line_segments) {
-      Vec2d pt;
+      Vec2<T> pt;
       if (poly_seg.get_intersect(line_segment, &pt)) {
         projections.push_back(line_segment.project_onto_unit(pt));
       }
     }
     std::sort(projections.begin(), projections.end());
-    std::vector<std::pair<double, double>> overlaps;
+    std::vector<std::pair<T, T>> overlaps;
     for (size_t i = 0; i + 1 < projections.size(); ++i) {
-      const double start_proj = projections[i];
-      const double end_proj = projections[i + 1];
-      if (end_proj - start_proj <= math_epsilon) {
+      const T start_proj = projections[i];
+      const T end_proj = projections[i + 1];
+      if (end_proj - start_proj <= math_epsilon_of<T>()) {
         continue;
       }
-      const Vec2d reference_point =
+      const Vec2<T> reference_point =
           line_segment.start() +
-          (start_proj + end_proj) / 2.0 * line_segment.unit_direction();
+          (start_proj + end_proj) / 2 * line_segment.unit_direction();
       if (!is_point_in(reference_point)) {
         continue;
       }
       if (overlaps.empty() ||
-          start_proj > overlaps.back().second + math_epsilon) {
+          start_proj > overlaps.back().second + math_epsilon_of<T>()) {
         overlaps.emplace_back(start_proj, end_proj);
       } else {
         overlaps.back().second = end_proj;
       }
     }
-    std::vector<LineSegment2d> overlap_line_segments;
+    std::vector<LineSegment2<T>> overlap_line_segments;
     for (const auto &overlap : overlaps) {
       overlap_line_segments.emplace_back(
           line_segment.start() + overlap.first * line_segment.unit_direction(),
@@ -306,26 +324,26 @@ public:
   }
 
   // 获取所有的顶点坐标
-  void get_all_vertices(std::vector<Vec2d>* const vertices) const { if (vertices) *vertices = _points; }
-  std::vector<Vec2d> get_all_vertices() const { return _points; }
+  void get_all_vertices(std::vector<Vec2<T>>* const vertices) const { if (vertices) *vertices = _points; }
+  std::vector<Vec2<T>> get_all_vertices() const { return _points; }
 
   // 判断两个多边形是否有重叠
-  bool has_overlap(const Polygon2d& polygon) const {
+  bool has_overlap(const Polygon2& polygon) const {
     assert(_points.size() >= 3);
     if (polygon.max_x() < min_x() || polygon.min_x() > max_x() ||
         polygon.max_y() < min_y() || polygon.min_y() > max_y()) {
       return false;
     }
-    return distance_to(polygon) <= math_epsilon;
+    return distance_to(polygon) <= math_epsilon_of<T>();
   }
 
   // 计算两个多边形的重叠并返回重叠部分(仅当两个多边形是凸多边形时才计算)
-  bool compute_overlap(const Polygon2d& other_polygon,
-                       Polygon2d* const overlap_polygon) const {
+  bool compute_overlap(const Polygon2& other_polygon,
+                       Polygon2* const overlap_polygon) const {
     assert(_points.size() >= 3);
     assert(overlap_polygon);
     assert(_is_convex && other_polygon.is_convex());
-    std::vector<Vec2d> points = other_polygon.points();
+    std::vector<Vec2<T>> points = other_polygon.points();
     for (int i = 0; i < _num_points; ++i) {
       if (!clip_convex_hull(_line_segments[i], &points)) {
         return false;
@@ -335,49 +353,49 @@ public:
   }
 
   // 按照当前多边形返回一个AABoundingBox
-  AABox2d aabounding_box() const {
-    return AABox2d({_min_x, _min_y}, {_max_x, _max_y});
+  AABox2<T> aabounding_box() const {
+    return AABox2<T>({_min_x, _min_y}, {_max_x, _max_y});
   }
 
   // 根据偏航角'heading'返回一个长方形结构
-  Box2d bounding_box_with_heading(const double heading) const {
+  Box2<T> bounding_box_with_heading(const T heading) const {
     assert(_points.size() >= 3);
-    const Vec2d direction_vec = Vec2d::create_unit_vec2d(heading);
-    Vec2d px1;
-    Vec2d px2;
-    Vec2d py1;
-    Vec2d py2;
+    const Vec2<T> direction_vec = Vec2<T>::create_unit_vec2d(heading);
+    Vec2<T> px1;
+    Vec2<T> px2;
+    Vec2<T> py1;
+    Vec2<T> py2;
     extreme_points(heading, &px1, &px2);
     extreme_points(heading - M_PI_2, &py1, &py2);
-    const double x1 = px1.inner_prod(direction_vec);
-    const double x2 = px2.inner_prod(direction_vec);
-    const double y1 = py1.cross_prod(direction_vec);
-    const double y2 = py2.cross_prod(direction_vec);
-    return Box2d(
-      (x1 + x2) / 2.0 * direction_vec +
-        (y1 + y2) / 2.0 * Vec2d(direction_vec.y(), -direction_vec.x()),
+    const T x1 = px1.inner_prod(direction_vec);
+    const T x2 = px2.inner_prod(direction_vec);
+    const T y1 = py1.cross_prod(direction_vec);
+    const T y2 = py2.cross_prod(direction_vec);
+    return Box2<T>(
+      (x1 + x2) / 2 * direction_vec +
+        (y1 + y2) / 2 * Vec2<T>(direction_vec.y(), -direction_vec.x()),
       heading, x2 - x1, y2 - y1);
   }
 
   // 根据多边形返回最小面积的长方形
-  Box2d min_area_bounding_box() const {
+  Box2<T> min_area_bounding_box() const {
     assert(_points.size() >= 3);
     if (!_is_convex) {
-      Polygon2d convex_polygon;
+      Polygon2 convex_polygon;
       compute_convex_hull(_points, &convex_polygon);
       assert(convex_polygon.is_convex());
       return convex_polygon.min_area_bounding_box();
     }
-    double min_area = std::numeric_limits<double>::infinity();
-    double min_area_at_heading = 0.0;
+    T min_area = std::numeric_limits<T>::infinity();
+    T min_area_at_heading = 0;
     int left_most = 0;
     int right_most = 0;
     int top_most = 0;
     // 遍历多边形所有点
     for (int i = 0; i < _num_points; ++i) {
       const auto& line_segment = _line_segments[i];
-      double proj = 0.0;
-      double min_proj = line_segment.project_onto_unit(_points[left_most]);
+      T proj = 0;
+      T min_proj = line_segment.project_onto_unit(_points[left_most]);
       while ((proj = line_segment.project_onto_unit(_points[prev(left_most)])) <
             min_proj) {
         min_proj = proj;
@@ -388,7 +406,7 @@ public:
         min_proj = proj;
         left_most = next(left_most);
       }
-      double max_proj = line_segment.project_onto_unit(_points[right_most]);
+      T max_proj = line_segment.project_onto_unit(_points[right_most]);
       while ((proj = line_segment.project_onto_unit(_points[prev(right_most)])) >
             max_proj) {
         max_proj = proj;
@@ -399,8 +417,8 @@ public:
         max_proj = proj;
         right_most = next(right_most);
       }
-      double prod = 0.0;
-      double max_prod = line_segment.project_onto_unit(_points[top_most]);
+      T prod = 0;
+      T max_prod = line_segment.project_onto_unit(_points[top_most]);
       while ((prod = line_segment.project_onto_unit(_points[prev(top_most)])) >
             max_prod) {
         max_prod = prod;
@@ -411,7 +429,7 @@ public:
         max_prod = prod;
         top_most = next(top_most);
       }
-      const double area = max_prod * (max_proj - min_proj);
+      const T area = max_prod * (max_proj - min_proj);
       if (area < min_area) {
         min_area = area;
         min_area_at_heading = line_segment.heading();
@@ -421,20 +439,25 @@ public:
   }
 
   // 获取沿航向的极点
-  void extreme_points(const double heading, 
-                      Vec2d* const first, Vec2d* const last) const {
+  void extreme_points(const T heading, 
+                      Vec2<T>* const first, Vec2<T>* const last) const {
     assert(_points.size() >= 3);
     assert(first);
     assert(last);
 
     // 创建方向向量
-    const Vec2d direction_vec = Vec2d::create_unit_vec2d(heading);
-    double min_proj = std::numeric_limits<double>::infinity();
-    double max_proj = -std::numeric_limits<double>::infinity();
+    const Vec2<T> direction_vec = Vec2<T>::create_unit_vec2d(heading);
+    if (_is_convex) {
+      *first = _points[extreme_point_index(direction_vec * T(-1))];
+      *last = _points[extreme_point_index(direction_vec)];
+      return;
+    }
+    T min_proj = std::numeric_limits<T>::infinity();
+    T max_proj = -std::numeric_limits<T>::infinity();
 
     // 遍历所有点
     for (const auto& pt : _points) {
-      const double proj = pt.inner_prod(direction_vec);
+      const T proj = pt.inner_prod(direction_vec);
       if (proj < min_proj) {
         min_proj = proj;
         *first = pt;
@@ -446,33 +469,86 @@ public:
     }
   }
 
+  // 沿'direction'方向投影最大的顶点，凸多边形为O(log n)
+  const Vec2<T>& extreme_point(const Vec2<T>& direction) const {
+    assert(_points.size() >= 3);
+    return _points[extreme_point_index(direction)];
+  }
+
+  /*
+   * 凸多边形外的点'point'到多边形的两个切点，O(log n)。
+   * 多边形位于射线point->left的右侧与射线point->right的左侧。
+   * 点在多边形内或者边界上时没有切点，返回false。
+   */
+  bool get_tangent_points(const Vec2<T>& point, Vec2<T>* const left,
+                          Vec2<T>* const right) const {
+    assert(_points.size() >= 3);
+    assert(_is_convex);
+    assert(left);
+    assert(right);
+
+    if (_has_zero_length_edges) {
+      // 长度为0的边没有可见性，逐个顶点比较
+      if (is_point_in(point)) {
+        return false;
+      }
+      *left = _points[0];
+      *right = _points[0];
+      for (const auto& p : _points) {
+        if (cross_prod(point, *left, p) > 0) {
+          *left = p;
+        }
+        if (cross_prod(point, *right, p) < 0) {
+          *right = p;
+        }
+      }
+      return true;
+    }
+
+    // 点在其外侧的边(可见边)与点不在其外侧的边(不可见边)各自连续，先各找一条
+    const int visible = find_visible_edge(point);
+    if (visible < 0) {
+      return false;
+    }
+    // 外法线与'point'指向第0个顶点的方向夹角小于90度的边不可见，
+    // 沿该方向的极点相邻的两条边中至少有一条满足
+    const int extreme = extreme_point_index(_points[0] - point);
+    const int hidden = is_edge_visible(extreme, point) ? prev(extreme) : extreme;
+    assert(!is_edge_visible(hidden, point));
+
+    // 逆时针进入可见边的顶点为左切点，离开可见边的顶点为右切点
+    *left = _points[search_edge_visibility(point, hidden, visible, true)];
+    *right = _points[search_edge_visibility(point, visible, hidden, false)];
+    return true;
+  }
+
   // 将此多边形扩展一定距离'distance'
-  Polygon2d expand_by_distance(const double distance) const {
+  Polygon2 expand_by_distance(const T distance) const {
     if (!_is_convex) {
-      Polygon2d convex_polygon;
+      Polygon2 convex_polygon;
       compute_convex_hull(_points, &convex_polygon);
       assert(convex_polygon.is_convex());
       return convex_polygon.expand_by_distance(distance);
     }
-    const double min_angle = 0.1;
-    std::vector<Vec2d> points;
+    const T min_angle = 0.1;
+    std::vector<Vec2<T>> points;
     for (int i = 0; i < _num_points; ++i) {
-      const double start_angle = _line_segments[prev(i)].heading() - M_PI_2;
-      const double end_angle = _line_segments[i].heading() - M_PI_2;
-      const double diff = wrap_angle(end_angle - start_angle);
-      if (diff <= math_epsilon) {
+      const T start_angle = _line_segments[prev(i)].heading() - M_PI_2;
+      const T end_angle = _line_segments[i].heading() - M_PI_2;
+      const T diff = wrap_angle(end_angle - start_angle);
+      if (diff <= math_epsilon_of<T>()) {
         points.push_back(_points[i] +
-          Vec2d::create_unit_vec2d(start_angle) * distance);
+          Vec2<T>::create_unit_vec2d(start_angle) * distance);
       } else {
         const int count = static_cast<int>(diff / min_angle) + 1;
         for (int k = 0; k <= count; ++k) {
-          const double angle = start_angle +
-            diff * static_cast<double>(k) / static_cast<double>(count);
-          points.push_back(_points[i] + Vec2d::create_unit_vec2d(angle) * distance);
+          const T angle = start_angle +
+            diff * static_cast<T>(k) / static_cast<T>(count);
+          points.push_back(_points[i] + Vec2<T>::create_unit_vec2d(angle) * distance);
         }
       }
     }
-    Polygon2d new_polygon;
+    Polygon2 new_polygon;
     assert(compute_convex_hull(points, &new_polygon));
     return new_polygon;
   }
@@ -498,8 +574,8 @@ public:
 #endif
 
   // 计算一组点'points'的凸包'polygon'
-  static bool compute_convex_hull(const std::vector<Vec2d>& points,
-                                  Polygon2d* const polygon) {
+  static bool compute_convex_hull(const std::vector<Vec2<T>>& points,
+                                  Polygon2* const polygon) {
     assert(polygon);
     const int n = points.size();
     if (n < 3) {
@@ -513,11 +589,11 @@ public:
     // 对所有点进行排序
     std::sort(sorted_indices.begin(), sorted_indices.end(),
               [&](const int idx1, const int idx2) {
-                const Vec2d& pt1 = points[idx1];
-                const Vec2d& pt2 = points[idx2];
-                const double dx = pt1.x() - pt2.x();
-                if (std::abs(dx) > math_epsilon) {
-                  return dx < 0.0;
+                const Vec2<T>& pt1 = points[idx1];
+                const Vec2<T>& pt2 = points[idx2];
+                const T dx = pt1.x() - pt2.x();
+                if (std::abs(dx) > math_epsilon_of<T>()) {
+                  return dx < 0;
                 }
                 return pt1.y() < pt2.y();
               });
@@ -530,10 +606,10 @@ public:
         last_count = count;
       }
       const int idx = sorted_indices[(i < n) ? i : (n + n - 1 - i)];
-      const Vec2d& pt = points[idx];
+      const Vec2<T>& pt = points[idx];
       while (count > last_count &&
         cross_prod(points[results[count - 2]], points[results[count - 1]],
-        pt) <= math_epsilon) {
+        pt) <= math_epsilon_of<T>()) {
         results.pop_back();
         --count;
       }
@@ -544,18 +620,18 @@ public:
     if (count < 3) {
       return false;
     }
-    std::vector<Vec2d> result_points;
+    std::vector<Vec2<T>> result_points;
     result_points.reserve(count);
     for (int i = 0; i < count; ++i) {
       result_points.push_back(points[results[i]]);
     }
-    *polygon = Polygon2d(result_points);
+    *polygon = Polygon2(result_points);
     return true;
   }
 
-  static bool clip_convex_hull(const LineSegment2d& line_segment,
-                               std::vector<Vec2d>* const points) {
-    if (line_segment.length() <= math_epsilon) {
+  static bool clip_convex_hull(const LineSegment2<T>& line_segment,
+                               std::vector<Vec2<T>>* const points) {
+    if (line_segment.length() <= math_epsilon_of<T>()) {
       return true;
     }
     assert(points);
@@ -563,28 +639,28 @@ public:
     if (n < 3) {
       return false;
     }
-    std::vector<double> prod(n);
+    std::vector<T> prod(n);
     std::vector<int> side(n);
     for (int i = 0; i < n; ++i) {
       prod[i] = cross_prod(line_segment.start(), line_segment.end(), (*points)[i]);
-      if (std::abs(prod[i]) <= math_epsilon) {
+      if (std::abs(prod[i]) <= math_epsilon_of<T>()) {
         side[i] = 0;
       } else {
         side[i] = ((prod[i] < 0) ? -1 : 1);
       }
     }
 
-    std::vector<Vec2d> new_points;
+    std::vector<Vec2<T>> new_points;
     for (int i = 0; i < n; ++i) {
       if (side[i] >= 0) {
         new_points.push_back((*points)[i]);
       }
       const int j = ((i == n - 1) ? 0 : (i + 1));
       if (side[i] * side[j] < 0) {
-        const double ratio = prod[j] / (prod[j] - prod[i]);
+        const T ratio = prod[j] / (prod[j] - prod[i]);
         new_points.emplace_back(
-          (*points)[i].x() * ratio + (*points)[j].x() * (1.0 - ratio),
-          (*points)[i].y() * ratio + (*points)[j].y() * (1.0 - ratio));
+          (*points)[i].x() * ratio + (*points)[j].x() * (1 - ratio),
+          (*points)[i].y() * ratio + (*points)[j].y() * (1 - ratio));
       }
     }
 
@@ -592,18 +668,170 @@ public:
     return points->size() >= 3;
   }
 
-  double min_x() const { return _min_x; }
-  double max_x() const { return _max_x; }
-  double min_y() const { return _min_y; }
-  double max_y() const { return _max_y; }
+  T min_x() const { return _min_x; }
+  T max_x() const { return _max_x; }
+  T min_y() const { return _min_y; }
+  T max_y() const { return _max_y; }
 
 protected:
+  /*
+   * 以第0个顶点为中心将凸多边形划分为扇形，二分查找点所在的扇形，
+   * 再检查点是否在扇形的外边内侧。判断为外侧时，再检查点是否在附近的边上，
+   * 与is_point_on_boundary()的误差保持一致。
+   */
+  bool is_point_in_convex(const Vec2<T>& point) const {
+    if (point.x() < _min_x - math_epsilon_of<T>() ||
+        point.x() > _max_x + math_epsilon_of<T>() ||
+        point.y() < _min_y - math_epsilon_of<T>() ||
+        point.y() > _max_y + math_epsilon_of<T>()) {
+      return false;
+    }
+    const int last = _num_points - 1;
+    const Vec2<T>& origin = _points[0];
+    // 在第一条边或者最后一条边的外侧
+    if (cross_prod(origin, _points[1], point) < 0) {
+      return is_point_on_edges(point, last);
+    }
+    if (cross_prod(origin, _points[last], point) > 0) {
+      return is_point_on_edges(point, last - 1);
+    }
+    const int fan = find_fan(point);
+    if (cross_prod(_points[fan], _points[fan + 1], point) >= 0) {
+      return true;
+    }
+    return is_point_on_edges(point, fan - 1);
+  }
+
+  // 查找点所在的扇形(origin, points[i], points[i + 1])，返回i，点需要在两条边界射线之间
+  int find_fan(const Vec2<T>& point) const {
+    int low = 1;
+    int high = _num_points - 1;
+    while (high - low > 1) {
+      const int mid = (low + high) / 2;
+      if (cross_prod(_points[0], _points[mid], point) >= 0) {
+        low = mid;
+      } else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  // 点是否在从'first'开始的连续三条边上
+  bool is_point_on_edges(const Vec2<T>& point, const int first) const {
+    for (int k = 0; k < 3; ++k) {
+      if (_line_segments[(first + k + _num_points) % _num_points].is_point_in(point)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 点是否在第i条边的外侧
+  bool is_edge_visible(const int i, const Vec2<T>& point) const {
+    return cross_prod(_points[i], _points[next(i)], point) < 0;
+  }
+
+  // 查找一条可见边，点在多边形内或者边界上时返回-1
+  int find_visible_edge(const Vec2<T>& point) const {
+    const int last = _num_points - 1;
+    if (cross_prod(_points[0], _points[1], point) < 0) {
+      return 0;
+    }
+    if (cross_prod(_points[0], _points[last], point) > 0) {
+      return last;
+    }
+    const int fan = find_fan(point);
+    return is_edge_visible(fan, point) ? fan : -1;
+  }
+
+  /*
+   * 从边'from'逆时针到边'to'，两者的可见性不同，
+   * 二分查找第一条可见性为'visible'的边。
+   */
+  int search_edge_visibility(const Vec2<T>& point, const int from, const int to,
+                             const bool visible) const {
+    int low = 0;
+    int high = (to - from + _num_points) % _num_points;
+    while (high - low > 1) {
+      const int mid = (low + high) / 2;
+      if (is_edge_visible((from + mid) % _num_points, point) == visible) {
+        high = mid;
+      } else {
+        low = mid;
+      }
+    }
+    return (from + high) % _num_points;
+  }
+
+  /*
+   * 沿'direction'方向投影最大的顶点编号。
+   * 逆时针凸多边形的边方向从第0条边起单调地逆时针旋转，投影最大的顶点之后的边开始背离
+   * 'direction'，因此二分查找第一条方向不在'direction'逆时针旋转90度之前的边，其起点即为极点。
+   * 方向的先后只用叉积与内积比较，不计算角度。存在长度为0的边时边方向不再单调，直接遍历。
+   */
+  int extreme_point_index(const Vec2<T>& direction) const {
+    int index = 0;
+    if (!_is_convex || _has_zero_length_edges ||
+        _num_points < kPolygonBinarySearchMinPoints) {
+      T max_proj = _points[0].inner_prod(direction);
+      for (int i = 1; i < _num_points; ++i) {
+        const T proj = _points[i].inner_prod(direction);
+        if (proj > max_proj) {
+          max_proj = proj;
+          index = i;
+        }
+      }
+      return index;
+    }
+    const Vec2<T>& reference = _line_segments[0].unit_direction();
+    const Vec2<T> target(-direction.y(), direction.x());
+    int low = 0;
+    int high = _num_points;
+    while (low < high) {
+      const int mid = (low + high) / 2;
+      if (is_ccw_before(reference, _line_segments[mid].unit_direction(), target)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    index = low == _num_points ? 0 : low;
+    // 修正舍入带来的误差
+    T max_proj = _points[index].inner_prod(direction);
+    while (_points[next(index)].inner_prod(direction) > max_proj) {
+      index = next(index);
+      max_proj = _points[index].inner_prod(direction);
+    }
+    while (_points[prev(index)].inner_prod(direction) > max_proj) {
+      index = prev(index);
+      max_proj = _points[index].inner_prod(direction);
+    }
+    return index;
+  }
+
+  // 从'reference'开始逆时针旋转，方向'first'是否严格早于方向'second'
+  static bool is_ccw_before(const Vec2<T>& reference, const Vec2<T>& first,
+                            const Vec2<T>& second) {
+    // 转过的角度是否不小于180度
+    const auto is_lower_half = [&reference](const Vec2<T>& v) {
+      const T cross = reference.cross_prod(v);
+      return cross < 0 || (cross == 0 && reference.inner_prod(v) < 0);
+    };
+    const bool first_lower = is_lower_half(first);
+    const bool second_lower = is_lower_half(second);
+    if (first_lower != second_lower) {
+      return second_lower;
+    }
+    return first.cross_prod(second) > 0;
+  }
+
   void build_from_points() {
     _num_points = _points.size();
     assert(_num_points >= 3);
 
     // 确认点的顺序为'ccw'顺序
-    _area = 0.0;
+    _area = 0;
     for (int i = 1; i < _num_points; ++i) {
       _area += cross_prod(_points[0], _points[i - 1], _points[i]);
     }
@@ -611,13 +839,17 @@ protected:
       _area = -_area;
       std::reverse(_points.begin(), _points.end());
     }
-    _area /= 2.0;
-    assert(_area > math_epsilon);
+    _area /= 2;
+    assert(_area > math_epsilon_of<T>());
 
     // 构造线段
     _line_segments.reserve(_num_points);
+    _has_zero_length_edges = false;
     for (int i = 0; i < _num_points; ++i) {
       _line_segments.emplace_back(_points[i], _points[next(i)]);
+      if (_line_segments.back().length() <= math_epsilon_of<T>()) {
+        _has_zero_length_edges = true;
+      }
     }
 
     // 检查凸度
@@ -625,7 +857,7 @@ protected:
     for (int i = 0; i < _num_points; ++i) {
       if (cross_prod(_points[prev(i)], 
                      _points[i], 
-                     _points[next(i)]) <= -math_epsilon) {
+                     _points[next(i)]) <= -math_epsilon_of<T>()) {
         _is_convex = false;
         break;
       }
@@ -652,17 +884,21 @@ protected:
     return at == 0 ? _num_points - 1 : at - 1;
   }
 
-  std::vector<Vec2d> _points;
+  std::vector<Vec2<T>> _points;
   int _num_points = 0;
-  std::vector<LineSegment2d> _line_segments;
+  std::vector<LineSegment2<T>> _line_segments;
   bool _is_convex = false;
-  double _area = 0.0;
-  double _min_x = 0.0;
-  double _max_x = 0.0;
-  double _min_y = 0.0;
-  double _max_y = 0.0;
+  bool _has_zero_length_edges = false;  // 存在重复的相邻顶点
+  T _area = 0;
+  T _min_x = 0;
+  T _max_x = 0;
+  T _min_y = 0;
+  T _max_y = 0;
 };
 
+using Polygon2d = Polygon2<double>;
+using Polygon2f = Polygon2<float>;
+
 }}
 
 #endif
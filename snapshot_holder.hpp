@@ -0,0 +1,250 @@
+#ifndef MYMATH_SNAPSHOT_HOLDER_HPP
+#define MYMATH_SNAPSHOT_HOLDER_HPP
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 多版本快照持有者(read-copy-update)
+ *
+ * 写线程在锁外构建新的对象，然后通过publish()原子地替换当前版本；
+ * 读线程通过各自的Reader获取当前版本的不可变快照，整个过程不加锁也不等待。
+ * 被替换的旧版本采用基于epoch的回收：
+ *   - 每个Reader占用一个槽位，获取快照时在槽位上登记当前的全局epoch，释放时清零；
+ *   - 旧版本替换后全局epoch加一，旧版本记录替换后的epoch；
+ *   - 所有活动槽位的epoch都不小于旧版本记录的epoch时，没有读者还能持有它，可以释放。
+ *
+ * 读者数量的上限在构造时指定，Reader与快照的生命周期都不能超过持有者。
+ */
+template <class T>
+class SnapshotHolder {
+private:
+  // 读者槽位，按照缓存行对齐并独占一个缓存行，避免读者之间的伪共享
+  struct alignas(64) ReaderSlot {
+    std::atomic<uint64_t> epoch{0};     // 0表示当前没有持有快照
+    std::atomic<bool> in_use{false};
+  };
+  static_assert(sizeof(ReaderSlot) == 64, "ReaderSlot should be one cache line");
+  static_assert(std::is_trivially_destructible<ReaderSlot>::value,
+                "ReaderSlot is released without calling destructors");
+
+  // C++14的operator new[]只保证基本对齐，槽位数组使用posix_memalign分配
+  struct ReaderSlotDeleter {
+    void operator()(ReaderSlot* const slots) const { ::free(slots); }
+  };
+
+  static ReaderSlot* allocate_slots(const int num_slots) {
+    void* data = nullptr;
+    if (::posix_memalign(&data, alignof(ReaderSlot),
+                         num_slots * sizeof(ReaderSlot)) != 0) {
+      throw std::bad_alloc();
+    }
+    ReaderSlot* const slots = static_cast<ReaderSlot*>(data);
+    for (int i = 0; i < num_slots; ++i) {
+      new (slots + i) ReaderSlot();
+    }
+    return slots;
+  }
+
+public:
+  // 当前版本的只读快照，析构时释放
+  class Snapshot {
+  public:
+    Snapshot() = default;
+    Snapshot(Snapshot&& other) noexcept : _value(other._value), _slot(other._slot) {
+      other._value = nullptr;
+      other._slot = nullptr;
+    }
+    Snapshot& operator=(Snapshot&& other) noexcept {
+      if (this != &other) {
+        release();
+        std::swap(_value, other._value);
+        std::swap(_slot, other._slot);
+      }
+      return *this;
+    }
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    ~Snapshot() { release(); }
+
+    const T* get() const { return _value; }
+    const T& operator*() const { return *_value; }
+    const T* operator->() const { return _value; }
+    explicit operator bool() const { return _value != nullptr; }
+
+    // 提前释放快照，之后不能再访问之前获得的对象
+    void release() {
+      if (_slot != nullptr) {
+        _slot->epoch.store(0, std::memory_order_release);
+        _slot = nullptr;
+      }
+      _value = nullptr;
+    }
+
+  private:
+    friend class SnapshotHolder;
+    Snapshot(const T* value, ReaderSlot* slot) : _value(value), _slot(slot) {}
+
+    const T* _value = nullptr;
+    ReaderSlot* _slot = nullptr;
+  };
+
+  // 一个读线程的句柄，同一时刻只能持有一个快照
+  class Reader {
+  public:
+    Reader() = default;
+    Reader(Reader&& other) noexcept : _holder(other._holder), _slot(other._slot) {
+      other._holder = nullptr;
+      other._slot = nullptr;
+    }
+    Reader& operator=(Reader&& other) noexcept {
+      if (this != &other) {
+        unregister();
+        std::swap(_holder, other._holder);
+        std::swap(_slot, other._slot);
+      }
+      return *this;
+    }
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader() { unregister(); }
+
+    // 是否成功获得了槽位
+    bool is_valid() const { return _slot != nullptr; }
+
+    // 获取当前版本的快照(wait-free)，没有发布过版本时快照为空。
+    Snapshot acquire() const {
+      assert(is_valid());
+      assert(_slot->epoch.load(std::memory_order_relaxed) == 0);
+      _slot->epoch.store(_holder->_epoch.load());
+      return Snapshot(_holder->_current.load(), _slot);
+    }
+
+  private:
+    friend class SnapshotHolder;
+    Reader(const SnapshotHolder* holder, ReaderSlot* slot)
+        : _holder(holder), _slot(slot) {}
+
+    void unregister() {
+      if (_slot != nullptr) {
+        assert(_slot->epoch.load() == 0);
+        _slot->in_use.store(false, std::memory_order_release);
+      }
+      _holder = nullptr;
+      _slot = nullptr;
+    }
+
+    const SnapshotHolder* _holder = nullptr;
+    ReaderSlot* _slot = nullptr;
+  };
+
+  explicit SnapshotHolder(const int max_readers = 64)
+      : _num_slots(std::max(1, max_readers)),
+        _slots(allocate_slots(_num_slots)) {}
+
+  explicit SnapshotHolder(std::unique_ptr<T> value, const int max_readers = 64)
+      : SnapshotHolder(max_readers) {
+    _current.store(value.release());
+  }
+
+  // 析构时不能有读者仍然持有快照
+  ~SnapshotHolder() {
+    delete _current.load();
+    for (auto& retired : _retired) {
+      delete retired.first;
+    }
+  }
+
+  SnapshotHolder(const SnapshotHolder&) = delete;
+  SnapshotHolder& operator=(const SnapshotHolder&) = delete;
+
+  /*
+   * 注册一个读者，占用一个空闲的槽位。
+   * 槽位用完时返回的Reader无效(is_valid()为false)。
+   */
+  Reader make_reader() const {
+    for (int i = 0; i < _num_slots; ++i) {
+      bool expected = false;
+      if (!_slots[i].in_use.load(std::memory_order_relaxed) &&
+          _slots[i].in_use.compare_exchange_strong(expected, true,
+                                                   std::memory_order_acquire)) {
+        return Reader(this, &_slots[i]);
+      }
+    }
+    return Reader();
+  }
+
+  /*
+   * 发布新的版本，之后获取的快照都指向'value'。
+   * 被替换的版本在没有读者持有之后被释放，多个写线程之间互斥。
+   */
+  void publish(std::unique_ptr<T> value) {
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+    T* old_value = _current.exchange(value.release());
+    const uint64_t retire_epoch = _epoch.fetch_add(1) + 1;
+    if (old_value != nullptr) {
+      _retired.emplace_back(old_value, retire_epoch);
+    }
+    reclaim_locked();
+  }
+
+  // 尝试释放已经没有读者持有的旧版本，返回仍在等待回收的版本数量。
+  int reclaim() {
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+    reclaim_locked();
+    return static_cast<int>(_retired.size());
+  }
+
+  // 已发布的版本数量
+  uint64_t version() const { return _epoch.load() - 1; }
+
+  int max_readers() const { return _num_slots; }
+
+private:
+  void reclaim_locked() {
+    if (_retired.empty()) {
+      return;
+    }
+    uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+    for (int i = 0; i < _num_slots; ++i) {
+      const uint64_t epoch = _slots[i].epoch.load();
+      if (epoch != 0) {
+        min_epoch = std::min(min_epoch, epoch);
+      }
+    }
+    auto it = std::remove_if(_retired.begin(), _retired.end(),
+      [min_epoch](const std::pair<T*, uint64_t>& retired) {
+        if (retired.second > min_epoch) {
+          return false;
+        }
+        delete retired.first;
+        return true;
+      });
+    _retired.erase(it, _retired.end());
+  }
+
+private:
+  const int _num_slots;
+  std::unique_ptr<ReaderSlot[], ReaderSlotDeleter> _slots;
+  std::atomic<T*> _current{nullptr};
+  std::atomic<uint64_t> _epoch{1};
+  std::mutex _writer_mutex;
+  std::vector<std::pair<T*, uint64_t>> _retired;   // 等待回收的版本与其替换后的epoch
+};
+
+}}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef MYMATH_SWEEP_AND_PRUNE2D_HPP
+#define MYMATH_SWEEP_AND_PRUNE2D_HPP
+
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+#include "aabox2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 扫描裁剪(sweep and prune)碰撞粗检测
+ *
+ * 所有盒子在x轴上的端点保存在一个有序数组中，帧与帧之间保留。
+ * 盒子移动后用插入排序恢复顺序，物体移动很小时数组几乎有序，排序接近线性；
+ * 新加入的端点单独排序后再归并，第一帧不会退化为O(n^2)的插入排序。
+ * 然后沿x轴扫描，只对x区间重叠的盒子用AABox2d::has_overlap检测。
+ *
+ * 盒子通过add_box()返回的编号引用，删除的盒子的端点在下一次排序时一起清除，
+ * 之后编号才会被复用。
+ */
+class SweepAndPrune2d {
+public:
+  SweepAndPrune2d() = default;
+
+  // 一次性加入一组盒子，编号依次为0, 1, ...
+  explicit SweepAndPrune2d(const std::vector<AABox2d>& boxes) {
+    _boxes.reserve(boxes.size());
+    _endpoints.reserve(2 * boxes.size());
+    for (const auto& box : boxes) {
+      add_box(box);
+    }
+  }
+
+  // 加入一个盒子，返回其编号
+  int add_box(const AABox2d& box) {
+    int id = 0;
+    if (_free_ids.empty()) {
+      id = static_cast<int>(_boxes.size());
+      _boxes.push_back(box);
+      _valid.push_back(true);
+    } else {
+      id = _free_ids.back();
+      _free_ids.pop_back();
+      _boxes[id] = box;
+      _valid[id] = true;
+    }
+    // 新的端点先放在末尾，下一次排序时移动到正确的位置
+    _endpoints.push_back({box.min_x(), id, true});
+    _endpoints.push_back({box.max_x(), id, false});
+    _num_new_endpoints += 2;
+    ++_num_boxes;
+    return id;
+  }
+
+  // 删除一个盒子，编号无效时返回false
+  bool remove_box(const int id) {
+    if (!is_valid_id(id)) {
+      return false;
+    }
+    // 端点在下一次排序时清除，在此之前编号不能复用
+    _valid[id] = false;
+    _removed_ids.push_back(id);
+    --_num_boxes;
+    return true;
+  }
+
+  // 更新一个盒子的位置，编号无效时返回false
+  bool update_box(const int id, const AABox2d& box) {
+    if (!is_valid_id(id)) {
+      return false;
+    }
+    _boxes[id] = box;
+    return true;
+  }
+
+  /*
+   * 更新所有的盒子，'boxes'的数量必须与盒子数量一致，
+   * 并且只用于以构造函数(或者依次add_box)加入、没有删除过的盒子集合。
+   */
+  void update_boxes(const std::vector<AABox2d>& boxes) {
+    assert(boxes.size() == _boxes.size() && _free_ids.empty() &&
+           _removed_ids.empty());
+    std::copy(boxes.begin(), boxes.end(), _boxes.begin());
+  }
+
+  const AABox2d& box(const int id) const {
+    assert(is_valid_id(id));
+    return _boxes[id];
+  }
+
+  int size() const { return _num_boxes; }
+
+  /*
+   * 计算所有相互重叠的盒子对，结果写入'pairs'。
+   * 每一对只出现一次，且pair.first < pair.second。
+   */
+  void get_overlapping_pairs(std::vector<std::pair<int, int>>* const pairs) {
+    assert(pairs);
+    pairs->clear();
+    sort_endpoints();
+
+    // 扫描x轴，_active中是x区间包含当前位置的盒子
+    _active.clear();
+    _active_position.resize(_boxes.size());
+    for (const Endpoint& endpoint : _endpoints) {
+      const int id = endpoint.id;
+      if (!endpoint.is_min) {
+        // 交换删除
+        const int position = _active_position[id];
+        _active[position] = _active.back();
+        _active_position[_active[position]] = position;
+        _active.pop_back();
+        continue;
+      }
+      const AABox2d& box = _boxes[id];
+      for (const int other : _active) {
+        const AABox2d& other_box = _boxes[other];
+        if (box.min_y() > other_box.max_y() || box.max_y() < other_box.min_y()) {
+          continue;
+        }
+        if (box.has_overlap(other_box)) {
+          pairs->emplace_back(std::min(id, other), std::max(id, other));
+        }
+      }
+      _active_position[id] = static_cast<int>(_active.size());
+      _active.push_back(id);
+    }
+  }
+
+  // 上一次排序时端点交换的次数，反映帧间的变化程度
+  int num_last_swaps() const { return _num_last_swaps; }
+
+private:
+  struct Endpoint {
+    double value;
+    int id;
+    bool is_min;
+  };
+
+  // 位置相同时起点排在终点之前，使得边界接触的盒子也被报告为重叠
+  static bool endpoint_less(const Endpoint& a, const Endpoint& b) {
+    return a.value < b.value || (a.value == b.value && a.is_min && !b.is_min);
+  }
+
+  bool is_valid_id(const int id) const {
+    return id >= 0 && id < static_cast<int>(_boxes.size()) && _valid[id];
+  }
+
+  /*
+   * 清除删除的盒子的端点并从盒子刷新端点的位置，
+   * 上一次排序过的端点用插入排序恢复顺序，新加入的端点用std::sort排序后归并。
+   */
+  void sort_endpoints() {
+    int num_sorted = static_cast<int>(_endpoints.size()) - _num_new_endpoints;
+    if (!_removed_ids.empty()) {
+      int count = 0;
+      int num_sorted_valid = 0;
+      for (int i = 0; i < static_cast<int>(_endpoints.size()); ++i) {
+        if (_valid[_endpoints[i].id]) {
+          num_sorted_valid += i < num_sorted ? 1 : 0;
+          _endpoints[count++] = _endpoints[i];
+        }
+      }
+      _endpoints.resize(count);
+      num_sorted = num_sorted_valid;
+      _free_ids.insert(_free_ids.end(), _removed_ids.begin(), _removed_ids.end());
+      _removed_ids.clear();
+    }
+    for (Endpoint& endpoint : _endpoints) {
+      const AABox2d& box = _boxes[endpoint.id];
+      endpoint.value = endpoint.is_min ? box.min_x() : box.max_x();
+    }
+    _num_last_swaps = 0;
+    for (int i = 1; i < num_sorted; ++i) {
+      const Endpoint endpoint = _endpoints[i];
+      int j = i;
+      for (; j > 0 && endpoint_less(endpoint, _endpoints[j - 1]); --j) {
+        _endpoints[j] = _endpoints[j - 1];
+      }
+      _num_last_swaps += i - j;
+      _endpoints[j] = endpoint;
+    }
+    if (num_sorted < static_cast<int>(_endpoints.size())) {
+      std::sort(_endpoints.begin() + num_sorted, _endpoints.end(), endpoint_less);
+      std::inplace_merge(_endpoints.begin(), _endpoints.begin() + num_sorted,
+                         _endpoints.end(), endpoint_less);
+    }
+    _num_new_endpoints = 0;
+  }
+
+private:
+  std::vector<AABox2d> _boxes;
+  std::vector<bool> _valid;
+  std::vector<int> _free_ids;
+  std::vector<int> _removed_ids;        // 端点尚未清除的已删除盒子
+  int _num_boxes = 0;
+  std::vector<Endpoint> _endpoints;     // x轴上按照位置排序的端点
+  int _num_new_endpoints = 0;           // 上一次排序之后加入的端点，位于末尾
+  std::vector<int> _active;             // 扫描时的活动盒子
+  std::vector<int> _active_position;    // 盒子在_active中的位置
+  int _num_last_swaps = 0;
+};
+
+}}
+
+#endif
@@ -0,0 +1,155 @@
+#include "aaboxgrid2d.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <random>
+
+#include "aaboxkdtree2d.hpp"
+#include "line_segment2d.hpp"
+#include "math_utils.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("grid vs kdtree");
+  {
+    std::mt19937 gen(14);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-3.0, 3.0);
+    std::uniform_real_distribution<double> query(-kSize * 1.5, kSize * 1.5);
+    std::uniform_real_distribution<double> radius(0, kSize * 0.3);
+    std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+    for (int num_boxes : {1, 10, 1000}) {
+      for (double cell_size : {2.0, 5.0, 40.0}) {
+        std::vector<Object> objects;
+        for (int i = 0; i < num_boxes; ++i) {
+          const double cx = pos(gen);
+          const double cy = pos(gen);
+          const double dx = ext(gen);
+          const double dy = ext(gen);
+          objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+        }
+        // 桶数量较少时也有哈希冲突
+        AABoxGrid2d<Object> grid(objects, cell_size, 64);
+        AABoxKDTreeParams params;
+        AABoxKDTree2d<Object> kdtree(objects, params);
+        EXPECT_EQ(grid.size(), num_boxes);
+        EXPECT_NEAR(grid.get_bounding_box().min_x(),
+                    kdtree.get_bounding_box().min_x(), 1e-9);
+        EXPECT_NEAR(grid.get_bounding_box().max_y(),
+                    kdtree.get_bounding_box().max_y(), 1e-9);
+
+        for (int i = 0; i < 50; ++i) {
+          const Vec2d point(query(gen), query(gen));
+          EXPECT_NEAR(grid.get_nearest_object(point)->distance_to(point),
+                      kdtree.get_nearest_object(point)->distance_to(point), 1e-9);
+          const auto knn1 = grid.get_k_nearest_objects(point, 4);
+          const auto knn2 = kdtree.get_k_nearest_objects(point, 4);
+          EXPECT_EQ(knn1.size(), knn2.size());
+          for (size_t j = 0; j < knn1.size() && j < knn2.size(); ++j) {
+            EXPECT_NEAR(knn1[j]->distance_to(point),
+                        knn2[j]->distance_to(point), 1e-9);
+          }
+          const double distance = radius(gen);
+          const auto objects_within = grid.get_objects(point, distance);
+          EXPECT_EQ(objects_within.size(), to_ids(objects_within).size());
+          EXPECT_TRUE((to_ids(objects_within) ==
+                       to_ids(kdtree.get_objects(point, distance))));
+          const AABox2d aabox(point, radius(gen), radius(gen));
+          EXPECT_TRUE((to_ids(grid.get_objects(aabox)) ==
+                       to_ids(kdtree.get_objects(aabox))));
+          const Box2d box(point, heading(gen), radius(gen), radius(gen) / 3.0);
+          EXPECT_TRUE((to_ids(grid.get_objects(box)) ==
+                       to_ids(kdtree.get_objects(box))));
+          const LineSegment2d segment(point, {query(gen), query(gen)});
+          const auto hits = grid.get_objects(segment);
+          EXPECT_EQ(hits.size(), to_ids(hits).size());
+          EXPECT_TRUE((to_ids(hits) == to_ids(kdtree.get_objects(segment))));
+        }
+      }
+    }
+  }
+  TEST_END("grid vs kdtree");
+
+  TEST_START("grid insert, remove and update");
+  {
+    std::mt19937 gen(15);
+    std::uniform_real_distribution<double> pos(-50.0, 50.0);
+    std::uniform_real_distribution<double> ext(-2.0, 2.0);
+    std::uniform_real_distribution<double> radius(0.0, 20.0);
+    std::vector<Object> objects;
+    for (int i = 0; i < 300; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      objects.emplace_back(cx - 1, cy - 1, cx + 1, cy + 1, i);
+    }
+    AABoxGrid2d<Object> grid(4.0, 128);
+    for (const auto &object : objects) {
+      EXPECT_TRUE(grid.insert(&object));
+    }
+    EXPECT_FALSE(grid.insert(&objects[0]));
+    std::vector<bool> present(objects.size(), true);
+
+    for (int frame = 0; frame < 20; ++frame) {
+      for (int i = 0; i < static_cast<int>(objects.size()); ++i) {
+        if (gen() % 7 == 0) {
+          const bool removed = grid.remove(&objects[i]);
+          EXPECT_EQ(removed, present[i]);
+          present[i] = false;
+        } else if (!present[i] && gen() % 2 == 0) {
+          EXPECT_TRUE(grid.insert(&objects[i]));
+          present[i] = true;
+        } else if (present[i]) {
+          const double cx = pos(gen);
+          const double cy = pos(gen);
+          const double dx = ext(gen);
+          const double dy = ext(gen);
+          objects[i].move(cx - dx, cy - dy, cx + dx, cy + dy);
+          EXPECT_TRUE(grid.update(&objects[i]));
+        }
+      }
+      int num_present = 0;
+      for (bool p : present) {
+        num_present += p ? 1 : 0;
+      }
+      EXPECT_EQ(grid.size(), num_present);
+      for (int q = 0; q < 20; ++q) {
+        const Vec2d point(pos(gen), pos(gen));
+        const double distance = radius(gen);
+        std::set<int> expected;
+        double min_distance = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < static_cast<int>(objects.size()); ++i) {
+          if (!present[i]) {
+            continue;
+          }
+          const double d = objects[i].distance_to(point);
+          min_distance = std::min(min_distance, d);
+          if (d <= distance) {
+            expected.insert(i);
+          }
+        }
+        EXPECT_TRUE((to_ids(grid.get_objects(point, distance)) == expected));
+        const Object *nearest = grid.get_nearest_object(point);
+        if (num_present > 0) {
+          EXPECT_NEAR(nearest->distance_to(point), min_distance, 1e-9);
+        }
+      }
+    }
+    EXPECT_FALSE(grid.remove(nullptr));
+    grid.clear();
+    EXPECT_EQ(grid.size(), 0);
+    EXPECT_EQ(grid.num_entries(), 0);
+    EXPECT_TRUE((grid.get_nearest_object({0, 0}) == nullptr));
+    EXPECT_EQ(grid.get_objects({0, 0}, 100.0).size(), 0);
+
+    // 清空之后复用登记数组与哈希表
+    for (const auto &object : objects) {
+      EXPECT_TRUE(grid.insert(&object));
+    }
+    EXPECT_EQ(grid.size(), static_cast<int>(objects.size()));
+    EXPECT_EQ(to_ids(grid.get_objects({0, 0}, 1000.0)).size(), objects.size());
+  }
+  TEST_END("grid insert, remove and update");
+}
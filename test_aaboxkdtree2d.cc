@@ -3,34 +3,16 @@
 
 #include <string>
 #include <set>
+#include <random>
+#include <algorithm>
 
 #include "line_segment2d.hpp"
+#include "box2d.hpp"
 #include "math_utils.hpp"
+#include "test_object.hpp"
 
 using namespace mypilot::mymath;
 
-class Object {
-public:
-  Object(const double x1, const double y1, const double x2, const double y2,
-         const int id)
-      : aabox_({x1, y1}, {x2, y2}),
-        line_segment_({x1, y1}, {x2, y2}),
-        id_(id) {}
-  const AABox2d &aabox() const { return aabox_; }
-  double distance_to(const Vec2d &point) const {
-    return line_segment_.distance_to(point);
-  }
-  double distance_square_to(const Vec2d &point) const {
-    return line_segment_.distance_square_to(point);
-  }
-  int id() const { return id_; }
-
-private:
-  AABox2d aabox_;
-  LineSegment2d line_segment_;
-  int id_ = 0;
-};
-
 int main(int argc, char* argv[]) {
   TEST_START("over all tests");
   {
@@ -98,4 +80,426 @@ int main(int argc, char* argv[]) {
     }
   }
   TEST_END("over all tests");
+
+  TEST_START("k nearest objects");
+  {
+    std::mt19937 gen(2);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> query(-kSize * 1.5, kSize * 1.5);
+    const int kNumTrees = 3;
+    AABoxKDTreeParams kdtree_params[kNumTrees];
+    kdtree_params[1].max_depth = 3;
+    kdtree_params[2].max_leaf_size = 4;
+
+    std::vector<Object> objects;
+    for (int i = 0; i < 200; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    for (int t = 0; t < kNumTrees; ++t) {
+      AABoxKDTree2d<Object> kdtree(objects, kdtree_params[t]);
+      for (int i = 0; i < 100; ++i) {
+        const Vec2d point(query(gen), query(gen));
+        std::vector<double> expected;
+        for (const auto &object : objects) {
+          expected.push_back(object.distance_to(point));
+        }
+        std::sort(expected.begin(), expected.end());
+        for (int k : {1, 3, 8}) {
+          std::vector<const Object *> result =
+              kdtree.get_k_nearest_objects(point, k);
+          EXPECT_EQ(result.size(), k);
+          for (int j = 0; j < static_cast<int>(result.size()); ++j) {
+            EXPECT_NEAR(result[j]->distance_to(point), expected[j], 1e-6);
+          }
+        }
+      }
+    }
+    AABoxKDTree2d<Object> kdtree(objects, AABoxKDTreeParams());
+    EXPECT_EQ(kdtree.get_k_nearest_objects({0, 0}, 0).size(), 0);
+    EXPECT_EQ(kdtree.get_k_nearest_objects({0, 0}, 500).size(), 200);
+    EXPECT_EQ(kdtree.get_k_nearest_objects({0, 0},
+                                           std::numeric_limits<int>::max()).size(),
+              200);
+    const std::vector<Object> empty_objects;
+    AABoxKDTree2d<Object> empty_kdtree(empty_objects, AABoxKDTreeParams());
+    EXPECT_EQ(empty_kdtree.get_k_nearest_objects({0, 0}, 3).size(), 0);
+  }
+  TEST_END("k nearest objects");
+
+  TEST_START("visitor and buffer queries");
+  {
+    std::mt19937 gen(3);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> radius(0, kSize);
+    std::vector<Object> objects;
+    for (int i = 0; i < 300; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 8;
+    AABoxKDTree2d<Object> kdtree(objects, params);
+    std::vector<const Object *> buffer;
+    for (int i = 0; i < 100; ++i) {
+      const Vec2d point(pos(gen), pos(gen));
+      const double distance = radius(gen);
+      const std::vector<const Object *> expected =
+          kdtree.get_objects(point, distance);
+      kdtree.get_objects(point, distance, &buffer);
+      EXPECT_TRUE((buffer == expected));
+
+      int num_visited = 0;
+      bool completed = kdtree.visit_objects(point, distance,
+                                            [&](const Object *) {
+                                              ++num_visited;
+                                              return true;
+                                            });
+      EXPECT_TRUE(completed);
+      EXPECT_EQ(num_visited, expected.size());
+
+      if (expected.size() >= 2) {
+        num_visited = 0;
+        completed = kdtree.visit_objects(point, distance,
+                                         [&](const Object *) {
+                                           return ++num_visited < 2;
+                                         });
+        EXPECT_FALSE(completed);
+        EXPECT_EQ(num_visited, 2);
+      }
+    }
+  }
+  TEST_END("visitor and buffer queries");
+
+  TEST_START("dynamic insert, remove and update");
+  {
+    std::mt19937 gen(5);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 20.0, kSize / 20.0);
+    std::uniform_real_distribution<double> radius(0, kSize / 2.0);
+    auto make_object = [&](const int id) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      return Object(cx - dx, cy - dy, cx + dx, cy + dy, id);
+    };
+    const int kNumObjects = 600;
+    std::vector<Object> objects;
+    objects.reserve(kNumObjects);
+    for (int i = 0; i < kNumObjects; ++i) {
+      objects.push_back(make_object(i));
+    }
+    std::vector<bool> alive(kNumObjects, false);
+    const std::vector<Object> initial_objects(objects.begin(),
+                                              objects.begin() + 50);
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 4;
+    // 初始对象来自另外一个数组，随后逐个删除并改为插入'objects'中的对象
+    AABoxKDTree2d<Object> kdtree(initial_objects, params);
+    EXPECT_EQ(kdtree.size(), 50);
+
+    auto check = [&]() {
+      int num_alive = 0;
+      for (int i = 0; i < kNumObjects; ++i) {
+        num_alive += alive[i] ? 1 : 0;
+      }
+      EXPECT_EQ(kdtree.size(), num_alive);
+      for (int q = 0; q < 50; ++q) {
+        const Vec2d point(pos(gen), pos(gen));
+        const double distance = radius(gen);
+        double expected_distance = std::numeric_limits<double>::infinity();
+        int expected_count = 0;
+        for (int i = 0; i < kNumObjects; ++i) {
+          if (!alive[i]) {
+            continue;
+          }
+          const double d = objects[i].distance_to(point);
+          expected_distance = std::min(expected_distance, d);
+          expected_count += (d <= distance) ? 1 : 0;
+        }
+        const Object *nearest_object = kdtree.get_nearest_object(point);
+        if (num_alive == 0) {
+          EXPECT_TRUE((nearest_object == nullptr));
+          continue;
+        }
+        EXPECT_NEAR(nearest_object->distance_to(point), expected_distance,
+                    1e-6);
+        const std::vector<const Object *> result =
+            kdtree.get_objects(point, distance);
+        EXPECT_EQ(result.size(), expected_count);
+        for (const Object *object : result) {
+          EXPECT_TRUE(alive[object->id()]);
+        }
+      }
+    };
+
+    for (const auto &object : initial_objects) {
+      const Object *ptr = &object;
+      const bool removed = kdtree.remove(ptr);
+      EXPECT_TRUE(removed);
+    }
+    EXPECT_EQ(kdtree.size(), 0);
+    for (int i = 0; i < kNumObjects; ++i) {
+      kdtree.insert(&objects[i]);
+      alive[i] = true;
+    }
+    check();
+
+    for (int i = 0; i < kNumObjects; i += 2) {
+      const bool removed = kdtree.remove(&objects[i]);
+      EXPECT_TRUE(removed);
+      alive[i] = false;
+    }
+    const bool removed_twice = kdtree.remove(&objects[0]);
+    EXPECT_FALSE(removed_twice);
+    check();
+    kdtree.refit();
+    check();
+
+    for (int i = 1; i < kNumObjects; i += 4) {
+      const AABox2d old_aabox = objects[i].aabox();
+      objects[i] = make_object(i);
+      const bool updated = kdtree.update(&objects[i], old_aabox);
+      EXPECT_TRUE(updated);
+    }
+    check();
+
+    for (int i = 1; i < kNumObjects; i += 2) {
+      kdtree.remove(&objects[i]);
+      alive[i] = false;
+    }
+    check();
+  }
+  TEST_END("dynamic insert, remove and update");
+
+  TEST_START("split strategies and parallel build");
+  {
+    std::mt19937 gen(6);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> radius(0, kSize / 2.0);
+    std::vector<Object> objects;
+    for (int i = 0; i < 2000; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen) / 4.0;
+      const double dx = ext(gen);
+      const double dy = ext(gen) / 4.0;
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    const AABoxKDTreeSplitStrategy kStrategies[3] = {SPLIT_MIDPOINT,
+                                                     SPLIT_MEDIAN, SPLIT_SAH};
+    for (const AABoxKDTreeSplitStrategy strategy : kStrategies) {
+      for (const int parallel_build_depth : {0, 3}) {
+        AABoxKDTreeParams params;
+        params.max_leaf_size = 8;
+        params.split_strategy = strategy;
+        params.parallel_build_depth = parallel_build_depth;
+        AABoxKDTree2d<Object> kdtree(objects, params);
+        EXPECT_EQ(kdtree.size(), objects.size());
+        for (int i = 0; i < 100; ++i) {
+          const Vec2d point(pos(gen), pos(gen));
+          const double distance = radius(gen);
+          double expected_distance = std::numeric_limits<double>::infinity();
+          int expected_count = 0;
+          for (const auto &object : objects) {
+            const double d = object.distance_to(point);
+            expected_distance = std::min(expected_distance, d);
+            expected_count += (d <= distance) ? 1 : 0;
+          }
+          EXPECT_NEAR(kdtree.get_nearest_object(point)->distance_to(point),
+                      expected_distance, 1e-6);
+          EXPECT_EQ(kdtree.get_objects(point, distance).size(),
+                    expected_count);
+        }
+      }
+    }
+
+    // 所有对象完全相同时不能无限切分
+    std::vector<Object> same_objects;
+    for (int i = 0; i < 10; ++i) {
+      same_objects.emplace_back(1.0, 1.0, 1.0, 1.0, i);
+    }
+    for (const AABoxKDTreeSplitStrategy strategy : kStrategies) {
+      AABoxKDTreeParams params;
+      params.split_strategy = strategy;
+      AABoxKDTree2d<Object> kdtree(same_objects, params);
+      EXPECT_EQ(kdtree.get_objects({1.0, 1.0}, 0.5).size(), 10);
+    }
+  }
+  TEST_END("split strategies and parallel build");
+
+  TEST_START("box, segment and ray cast queries");
+  {
+    std::mt19937 gen(7);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> size(0.1, kSize / 2.0);
+    std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+    std::vector<Object> objects;
+    for (int i = 0; i < 500; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 4;
+    AABoxKDTree2d<Object> kdtree(objects, params);
+    auto to_box2d = [](const AABox2d &aabox) {
+      return Box2d(aabox.center(), 0.0, aabox.length(), aabox.width());
+    };
+
+    for (int i = 0; i < 200; ++i) {
+      // 轴对齐盒子查询
+      const AABox2d query_aabox({pos(gen), pos(gen)}, size(gen), size(gen));
+      int expected = 0;
+      for (const auto &object : objects) {
+        expected += object.aabox().has_overlap(query_aabox) ? 1 : 0;
+      }
+      EXPECT_EQ(kdtree.get_objects(query_aabox).size(), expected);
+
+      // 有向盒子查询，与细长的盒子做比较
+      const Box2d query_box({pos(gen), pos(gen)}, heading(gen), size(gen),
+                            size(gen) / 10.0);
+      std::set<int> result_ids;
+      for (const Object *object : kdtree.get_objects(query_box)) {
+        result_ids.insert(object->id());
+      }
+      for (const auto &object : objects) {
+        const bool found = result_ids.count(object.id()) > 0;
+        EXPECT_EQ(found, to_box2d(object.aabox()).has_overlap(query_box));
+      }
+
+      // 线段查询
+      const LineSegment2d segment({pos(gen), pos(gen)}, {pos(gen), pos(gen)});
+      result_ids.clear();
+      for (const Object *object : kdtree.get_objects(segment)) {
+        result_ids.insert(object->id());
+      }
+      for (const auto &object : objects) {
+        const double d = to_box2d(object.aabox()).distance_to(segment);
+        if (d <= 1e-9) {
+          EXPECT_TRUE(result_ids.count(object.id()));
+        } else if (d > 1e-6) {
+          EXPECT_FALSE(result_ids.count(object.id()));
+        }
+      }
+
+      // 射线检测，使用对象线段的精确交点
+      auto hit = [&segment](const Object *object, double *const distance) {
+        Vec2d point;
+        if (!object->line_segment().get_intersect(segment, &point)) {
+          return false;
+        }
+        *distance = point.distance_to(segment.start());
+        return true;
+      };
+      double expected_distance = std::numeric_limits<double>::infinity();
+      for (const auto &object : objects) {
+        double distance = 0.0;
+        if (hit(&object, &distance)) {
+          expected_distance = std::min(expected_distance, distance);
+        }
+      }
+      double hit_distance = 0.0;
+      const Object *hit_object = kdtree.get_first_hit(segment, hit,
+                                                      &hit_distance);
+      const bool has_hit = (hit_object != nullptr);
+      EXPECT_EQ(has_hit, !std::isinf(expected_distance));
+      if (has_hit) {
+        EXPECT_NEAR(hit_distance, expected_distance, 1e-9);
+      }
+
+      // 以轴对齐盒子作为击中判断
+      const AABoxKDTreeSegmentQuery query(segment);
+      double expected_box_distance = std::numeric_limits<double>::infinity();
+      for (const auto &object : objects) {
+        double distance = 0.0;
+        if (query.entry_distance(object.aabox(), &distance)) {
+          expected_box_distance = std::min(expected_box_distance, distance);
+        }
+      }
+      const Object *box_hit = kdtree.get_first_hit(segment, &hit_distance);
+      const bool has_box_hit = (box_hit != nullptr);
+      EXPECT_EQ(has_box_hit, !std::isinf(expected_box_distance));
+      if (has_box_hit) {
+        EXPECT_NEAR(hit_distance, expected_box_distance, 1e-9);
+      }
+    }
+  }
+  TEST_END("box, segment and ray cast queries");
+
+  TEST_START("build and query stats");
+  {
+    std::mt19937 gen(9);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::vector<Object> objects;
+    for (int i = 0; i < 1000; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 8;
+    AABoxKDTree2d<Object> kdtree(objects, params);
+    const AABoxKDTreeBuildStats stats = kdtree.get_build_stats();
+    EXPECT_EQ(stats.num_objects, 1000);
+    EXPECT_TRUE((stats.num_leaves > 0));
+    EXPECT_TRUE((stats.num_nodes > stats.num_leaves));
+    EXPECT_TRUE((stats.max_depth > 0));
+    EXPECT_TRUE((stats.memory_bytes > 1000 * sizeof(const Object *)));
+    int leaf_objects = 0;
+    int num_leaves = 0;
+    for (int n = 0; n < static_cast<int>(stats.leaf_size_histogram.size());
+         ++n) {
+      leaf_objects += n * stats.leaf_size_histogram[n];
+      num_leaves += stats.leaf_size_histogram[n];
+    }
+    EXPECT_EQ(num_leaves, stats.num_leaves);
+    EXPECT_EQ(leaf_objects + stats.num_interior_objects, 1000);
+
+    AABoxKDTree2d<Object> empty_kdtree(std::vector<Object>(), params);
+    EXPECT_EQ(empty_kdtree.get_build_stats().num_nodes, 0);
+    EXPECT_NEAR(empty_kdtree.get_build_stats().average_leaf_size(), 0.0, 1e-9);
+
+#ifdef MYMATH_KDTREE_STATS
+    AABoxKDTreeQueryStats& query_stats = aabox_kdtree_query_stats();
+    query_stats.reset();
+    kdtree.get_nearest_object({0, 0});
+    kdtree.get_objects({10, 10}, 20.0);
+    EXPECT_EQ(query_stats.num_queries, 2);
+    EXPECT_TRUE((query_stats.nodes_visited > 0));
+    EXPECT_TRUE((query_stats.nodes_visited < 2 * stats.num_nodes));
+    EXPECT_TRUE((query_stats.objects_tested < 2000));
+    int64_t depth_visits = 0;
+    for (int i = 0; i < kAABoxKDTreeStatsMaxDepth; ++i) {
+      depth_visits += query_stats.depth_histogram[i];
+    }
+    EXPECT_EQ(depth_visits, query_stats.nodes_visited);
+    kdtree.get_k_nearest_objects({0, 0}, 5);
+    EXPECT_EQ(query_stats.num_queries, 3);
+    query_stats.reset();
+    EXPECT_EQ(query_stats.nodes_visited, 0);
+#endif
+  }
+  TEST_END("build and query stats");
 }
@@ -0,0 +1,81 @@
+#include "aaboxkdtree2d_batch.hpp"
+#include "ltest.hpp"
+
+#include <random>
+
+#include "aaboxkdtree2d.hpp"
+#include "aaboxkdtree2d_flat.hpp"
+#include "line_segment2d.hpp"
+#include "thread_pool.hpp"
+#include "math_utils.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("morton order");
+  {
+    const AABox2d box({0, 0}, {1, 1});
+    EXPECT_EQ(morton_code({0, 0}, box), 0);
+    EXPECT_EQ(morton_code({1, 1}, box), 0xffffffff);
+    EXPECT_EQ(morton_code({1, 0}, box), 0x55555555);
+    EXPECT_EQ(morton_code({0, 1}, box), 0xaaaaaaaa);
+    const std::vector<Vec2d> points = {{1, 1}, {0, 0}, {0, 1}, {1, 0}};
+    const std::vector<int> order = morton_order(points);
+    EXPECT_EQ(order[0], 1);
+    EXPECT_EQ(order[1], 3);
+    EXPECT_EQ(order[2], 2);
+    EXPECT_EQ(order[3], 0);
+  }
+  TEST_END("morton order");
+
+  TEST_START("batch queries");
+  {
+    std::mt19937 gen(4);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> query(-kSize * 1.5, kSize * 1.5);
+    std::vector<Object> objects;
+    for (int i = 0; i < 500; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    std::vector<Vec2d> points;
+    for (int i = 0; i < 2000; ++i) {
+      points.emplace_back(query(gen), query(gen));
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 8;
+    AABoxKDTree2d<Object> kdtree(objects, params);
+    FlatAABoxKDTree2d<Object> flat_kdtree(objects, params);
+    ThreadPool pool(4);
+
+    const auto serial = batch_get_nearest_objects(kdtree, points);
+    const auto parallel = batch_get_nearest_objects(kdtree, points, &pool);
+    const auto flat = batch_get_nearest_objects(flat_kdtree, points, &pool);
+    EXPECT_EQ(serial.size(), points.size());
+    EXPECT_EQ(parallel.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      const double expected =
+          kdtree.get_nearest_object(points[i])->distance_to(points[i]);
+      EXPECT_NEAR(serial[i]->distance_to(points[i]), expected, 1e-9);
+      EXPECT_NEAR(parallel[i]->distance_to(points[i]), expected, 1e-9);
+      EXPECT_NEAR(flat[i]->distance_to(points[i]), expected, 1e-9);
+    }
+
+    const double kDistance = 15.0;
+    const auto hits = batch_get_objects(kdtree, points, kDistance, &pool);
+    EXPECT_EQ(hits.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      EXPECT_TRUE((hits[i] == kdtree.get_objects(points[i], kDistance)));
+    }
+
+    const std::vector<Vec2d> no_points;
+    EXPECT_EQ(batch_get_nearest_objects(kdtree, no_points, &pool).size(), 0);
+  }
+  TEST_END("batch queries");
+}
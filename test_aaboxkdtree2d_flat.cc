@@ -0,0 +1,197 @@
+#include "aaboxkdtree2d_flat.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <fstream>
+
+#include <unistd.h>
+
+#include "aaboxkdtree2d.hpp"
+#include "line_segment2d.hpp"
+#include "math_utils.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("flat tree vs brute force");
+  {
+    std::mt19937 gen(1);
+    const int kNumBoxes[4] = {1, 10, 50, 500};
+    const int kNumQueries = 200;
+    const double kSize = 100;
+    const int kNumTrees = 6;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> query(-kSize * 1.5, kSize * 1.5);
+    std::uniform_real_distribution<double> radius(0, kSize * 0.5);
+    AABoxKDTreeParams kdtree_params[kNumTrees];
+    kdtree_params[1].max_depth = 2;
+    kdtree_params[2].max_leaf_dimension = kSize / 4.0;
+    kdtree_params[3].max_leaf_size = 20;
+    kdtree_params[4].split_strategy = SPLIT_MEDIAN;
+    kdtree_params[5].split_strategy = SPLIT_SAH;
+    kdtree_params[5].max_leaf_size = 4;
+
+    for (int num_boxes : kNumBoxes) {
+      std::vector<Object> objects;
+      for (int i = 0; i < num_boxes; ++i) {
+        const double cx = pos(gen);
+        const double cy = pos(gen);
+        const double dx = ext(gen);
+        const double dy = ext(gen);
+        objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+      }
+      for (int k = 0; k < kNumTrees; ++k) {
+        FlatAABoxKDTree2d<Object> flat_tree(objects, kdtree_params[k]);
+        AABoxKDTree2d<Object> tree(objects, kdtree_params[k]);
+        EXPECT_EQ(flat_tree.num_objects(), num_boxes);
+        const AABox2d box1 = flat_tree.get_bounding_box();
+        const AABox2d box2 = tree.get_bounding_box();
+        EXPECT_NEAR(box1.min_x(), box2.min_x(), 1e-9);
+        EXPECT_NEAR(box1.max_y(), box2.max_y(), 1e-9);
+
+        for (int i = 0; i < kNumQueries; ++i) {
+          const Vec2d point(query(gen), query(gen));
+          double expected_distance = std::numeric_limits<double>::infinity();
+          for (const auto &object : objects) {
+            expected_distance =
+                std::min(expected_distance, object.distance_to(point));
+          }
+          const Object *nearest_object = flat_tree.get_nearest_object(point);
+          EXPECT_NEAR(nearest_object->distance_to(point), expected_distance,
+                      1e-3);
+
+          const double distance = radius(gen);
+          std::vector<const Object *> result_objects =
+              flat_tree.get_objects(point, distance);
+          std::set<int> result_ids;
+          for (const Object *object : result_objects) {
+            result_ids.insert(object->id());
+          }
+          EXPECT_EQ(result_objects.size(), result_ids.size());
+          EXPECT_EQ(result_objects.size(),
+                    tree.get_objects(point, distance).size());
+          for (const auto &object : objects) {
+            const double d = object.distance_to(point);
+            if (std::abs(d - distance) <= 1e-3) {
+              continue;
+            }
+            if (d < distance) {
+              EXPECT_TRUE(result_ids.count(object.id()));
+            } else {
+              EXPECT_FALSE(result_ids.count(object.id()));
+            }
+          }
+        }
+      }
+    }
+  }
+  TEST_END("flat tree vs brute force");
+
+  TEST_START("empty tree");
+  {
+    std::vector<Object> objects;
+    FlatAABoxKDTree2d<Object> flat_tree(objects, AABoxKDTreeParams());
+    EXPECT_TRUE((flat_tree.get_nearest_object({0, 0}) == nullptr));
+    EXPECT_EQ(flat_tree.get_objects({0, 0}, 10.0).size(), 0);
+    EXPECT_EQ(flat_tree.num_nodes(), 0);
+  }
+  TEST_END("empty tree");
+
+  TEST_START("mapped snapshot");
+  {
+    std::mt19937 gen(8);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 10.0, kSize / 10.0);
+    std::uniform_real_distribution<double> radius(0, kSize / 2.0);
+    std::vector<Object> objects;
+    for (int i = 0; i < 1000; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 8;
+    FlatAABoxKDTree2d<Object> flat_tree(objects, params);
+    const std::string path =
+        "/tmp/test_aaboxkdtree2d_flat_" + std::to_string(getpid()) + ".bin";
+    const bool saved = flat_tree.save(path);
+    EXPECT_TRUE(saved);
+
+    std::unique_ptr<FlatAABoxKDTree2d<Object>> mapped_tree =
+        FlatAABoxKDTree2d<Object>::load_mapped(path, objects);
+    const bool loaded = (mapped_tree != nullptr);
+    EXPECT_TRUE(loaded);
+    EXPECT_TRUE(mapped_tree->is_mapped());
+    EXPECT_FALSE(flat_tree.is_mapped());
+    EXPECT_EQ(mapped_tree->num_nodes(), flat_tree.num_nodes());
+    EXPECT_EQ(mapped_tree->num_objects(), flat_tree.num_objects());
+    for (int i = 0; i < 200; ++i) {
+      const Vec2d point(pos(gen), pos(gen));
+      const double distance = radius(gen);
+      const bool same_nearest = (mapped_tree->get_nearest_object(point) ==
+                                 flat_tree.get_nearest_object(point));
+      EXPECT_TRUE(same_nearest);
+      const bool same_objects = (mapped_tree->get_objects(point, distance) ==
+                                 flat_tree.get_objects(point, distance));
+      EXPECT_TRUE(same_objects);
+    }
+
+    // 对象数量不一致或者文件不存在时加载失败
+    std::vector<Object> fewer_objects(objects.begin(), objects.begin() + 10);
+    const bool mismatch =
+        (FlatAABoxKDTree2d<Object>::load_mapped(path, fewer_objects) == nullptr);
+    EXPECT_TRUE(mismatch);
+
+    // 截断的文件与节点数量损坏的文件头加载失败
+    const std::string corrupt_path = path + ".corrupt";
+    {
+      std::ifstream in(path, std::ios::binary);
+      std::ofstream out(corrupt_path, std::ios::binary | std::ios::trunc);
+      out << in.rdbuf();
+    }
+    EXPECT_EQ(::truncate(corrupt_path.c_str(), sizeof(FlatAABoxKDTreeFileHeader) + 100),
+              0);
+    const bool truncated =
+        (FlatAABoxKDTree2d<Object>::load_mapped(corrupt_path, objects) == nullptr);
+    EXPECT_TRUE(truncated);
+    {
+      std::ifstream in(path, std::ios::binary);
+      std::ofstream out(corrupt_path, std::ios::binary | std::ios::trunc);
+      out << in.rdbuf();
+    }
+    {
+      // 节点数组的大小溢出后与原文件相同，偏移仍然在文件范围内
+      FlatAABoxKDTreeFileHeader header;
+      std::fstream file(corrupt_path, std::ios::binary | std::ios::in | std::ios::out);
+      file.read(reinterpret_cast<char*>(&header), sizeof(header));
+      header.num_nodes += 1ULL << 58;
+      file.seekp(0);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    const bool overflow =
+        (FlatAABoxKDTree2d<Object>::load_mapped(corrupt_path, objects) == nullptr);
+    EXPECT_TRUE(overflow);
+    std::remove(corrupt_path.c_str());
+    std::remove(path.c_str());
+    const bool missing =
+        (FlatAABoxKDTree2d<Object>::load_mapped(path, objects) == nullptr);
+    EXPECT_TRUE(missing);
+    // 删除文件后映射仍然有效
+    EXPECT_TRUE((mapped_tree->get_nearest_object({0, 0}) ==
+                 flat_tree.get_nearest_object({0, 0})));
+
+    // 移动后的树仍然可以查询
+    FlatAABoxKDTree2d<Object> moved_tree(std::move(flat_tree));
+    EXPECT_EQ(moved_tree.get_objects({0, 0}, 20.0).size(),
+              mapped_tree->get_objects({0, 0}, 20.0).size());
+  }
+  TEST_END("mapped snapshot");
+}
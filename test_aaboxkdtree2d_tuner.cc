@@ -0,0 +1,83 @@
+#include "aaboxkdtree2d_tuner.hpp"
+#include "ltest.hpp"
+
+#include <random>
+
+#include "aaboxkdtree2d.hpp"
+#include "line_segment2d.hpp"
+#include "math_utils.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("tune params");
+  {
+    std::mt19937 gen(10);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 20.0, kSize / 20.0);
+    std::vector<Object> objects;
+    for (int i = 0; i < 2000; ++i) {
+      const double cx = pos(gen);
+      const double cy = pos(gen);
+      const double dx = ext(gen);
+      const double dy = ext(gen);
+      objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+    }
+    std::vector<Vec2d> points;
+    for (int i = 0; i < 500; ++i) {
+      points.emplace_back(pos(gen), pos(gen));
+    }
+
+    AABoxKDTreeTunerOptions options;
+    options.max_leaf_sizes = {2, 8, 32};
+    options.query_distance = 5.0;
+    AABoxKDTreeParams best_params;
+    std::vector<AABoxKDTreeTunerResult> results;
+    const bool tuned =
+        tune_aabox_kdtree_params(objects, points, options, &best_params, &results);
+    EXPECT_TRUE(tuned);
+    EXPECT_EQ(results.size(), 9);
+    int num_best = 0;
+    for (const auto &result : results) {
+      EXPECT_TRUE(result.within_budget);
+      EXPECT_TRUE((result.memory_bytes > 0));
+      EXPECT_TRUE((result.query_time > 0.0));
+      if (result.params.max_leaf_size == best_params.max_leaf_size &&
+          result.params.split_strategy == best_params.split_strategy) {
+        ++num_best;
+        for (const auto &other : results) {
+          EXPECT_TRUE((result.query_time <= other.query_time));
+        }
+      }
+    }
+    EXPECT_EQ(num_best, 1);
+
+    // 内存限制排除了较大的树
+    size_t min_memory = results[0].memory_bytes;
+    for (const auto &result : results) {
+      min_memory = std::min(min_memory, result.memory_bytes);
+    }
+    options.memory_budget = min_memory;
+    const bool budget_tuned =
+        tune_aabox_kdtree_params(objects, points, options, &best_params, &results);
+    EXPECT_TRUE(budget_tuned);
+    for (const auto &result : results) {
+      EXPECT_EQ(result.within_budget, (result.memory_bytes <= min_memory));
+      if (result.params.max_leaf_size == best_params.max_leaf_size &&
+          result.params.split_strategy == best_params.split_strategy) {
+        EXPECT_TRUE(result.within_budget);
+      }
+    }
+
+    options.memory_budget = 1;
+    const bool over_budget =
+        tune_aabox_kdtree_params(objects, points, options, &best_params);
+    EXPECT_FALSE(over_budget);
+    const bool no_points = tune_aabox_kdtree_params(
+        objects, std::vector<Vec2d>(), AABoxKDTreeTunerOptions(), &best_params);
+    EXPECT_FALSE(no_points);
+  }
+  TEST_END("tune params");
+}
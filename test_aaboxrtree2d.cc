@@ -0,0 +1,120 @@
+#include "aaboxrtree2d.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <random>
+#include <cstdint>
+
+#include "aaboxkdtree2d.hpp"
+#include "aaboxkdtree2d_batch.hpp"
+#include "line_segment2d.hpp"
+#include "math_utils.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("rtree vs kdtree");
+  {
+    std::mt19937 gen(13);
+    const double kSize = 100;
+    std::uniform_real_distribution<double> pos(-kSize, kSize);
+    std::uniform_real_distribution<double> ext(-kSize / 5.0, kSize / 5.0);
+    std::uniform_real_distribution<double> query(-kSize * 1.5, kSize * 1.5);
+    std::uniform_real_distribution<double> radius(0, kSize * 0.5);
+    std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+    for (int num_boxes : {1, 8, 9, 100, 2000}) {
+      std::vector<Object> objects;
+      for (int i = 0; i < num_boxes; ++i) {
+        const double cx = pos(gen);
+        const double cy = pos(gen);
+        const double dx = ext(gen);
+        const double dy = ext(gen);
+        objects.emplace_back(cx - dx, cy - dy, cx + dx, cy + dy, i);
+      }
+      AABoxRTree2d<Object> rtree(objects);
+      AABoxKDTreeParams params;
+      params.max_leaf_size = 8;
+      AABoxKDTree2d<Object> kdtree(objects, params);
+      EXPECT_EQ(rtree.size(), num_boxes);
+      const AABox2d box1 = rtree.get_bounding_box();
+      const AABox2d box2 = kdtree.get_bounding_box();
+      EXPECT_NEAR(box1.min_x(), box2.min_x(), 1e-9);
+      EXPECT_NEAR(box1.max_x(), box2.max_x(), 1e-9);
+      EXPECT_NEAR(box1.min_y(), box2.min_y(), 1e-9);
+      EXPECT_NEAR(box1.max_y(), box2.max_y(), 1e-9);
+
+      for (int i = 0; i < 100; ++i) {
+        const Vec2d point(query(gen), query(gen));
+        EXPECT_NEAR(rtree.get_nearest_object(point)->distance_to(point),
+                    kdtree.get_nearest_object(point)->distance_to(point), 1e-9);
+
+        const auto knn1 = rtree.get_k_nearest_objects(point, 5);
+        const auto knn2 = kdtree.get_k_nearest_objects(point, 5);
+        EXPECT_EQ(knn1.size(), knn2.size());
+        for (size_t j = 0; j < knn1.size() && j < knn2.size(); ++j) {
+          EXPECT_NEAR(knn1[j]->distance_to(point), knn2[j]->distance_to(point),
+                      1e-9);
+        }
+
+        const double distance = radius(gen);
+        EXPECT_TRUE((to_ids(rtree.get_objects(point, distance)) ==
+                     to_ids(kdtree.get_objects(point, distance))));
+
+        const AABox2d aabox(point, radius(gen), radius(gen));
+        EXPECT_TRUE((to_ids(rtree.get_objects(aabox)) ==
+                     to_ids(kdtree.get_objects(aabox))));
+        const Box2d box(point, heading(gen), radius(gen), radius(gen) / 5.0);
+        EXPECT_TRUE((to_ids(rtree.get_objects(box)) ==
+                     to_ids(kdtree.get_objects(box))));
+        const LineSegment2d segment(point, {query(gen), query(gen)});
+        EXPECT_TRUE((to_ids(rtree.get_objects(segment)) ==
+                     to_ids(kdtree.get_objects(segment))));
+      }
+
+      // 提前停止的访问
+      int num_visited = 0;
+      const bool finished = rtree.visit_objects(
+          {0, 0}, kSize * 3.0, [&num_visited](const Object *) {
+            return ++num_visited < 3;
+          });
+      EXPECT_EQ(finished, (num_boxes < 3));
+      EXPECT_EQ(num_visited, std::min(num_boxes, 3));
+      EXPECT_EQ(rtree.get_k_nearest_objects({0, 0},
+                                            std::numeric_limits<int>::max()).size(),
+                num_boxes);
+
+      // 与批量查询一起使用
+      const std::vector<Vec2d> points = {{0, 0}, {10, 10}, {-50, 20}};
+      const auto nearest = batch_get_nearest_objects(rtree, points);
+      for (size_t j = 0; j < points.size(); ++j) {
+        EXPECT_TRUE((nearest[j] == rtree.get_nearest_object(points[j])));
+      }
+    }
+  }
+  TEST_END("rtree vs kdtree");
+
+  TEST_START("empty rtree");
+  {
+    std::vector<Object> objects;
+    AABoxRTree2d<Object> rtree(objects);
+    EXPECT_TRUE((rtree.get_nearest_object({0, 0}) == nullptr));
+    EXPECT_EQ(rtree.get_objects({0, 0}, 10.0).size(), 0);
+    EXPECT_EQ(rtree.get_k_nearest_objects({0, 0}, 3).size(), 0);
+    EXPECT_EQ(rtree.get_objects(AABox2d({0, 0}, 1.0, 1.0)).size(), 0);
+    EXPECT_EQ(rtree.num_nodes(), 0);
+  }
+  TEST_END("empty rtree");
+
+  TEST_START("node alignment");
+  {
+    // 节点按照缓存行对齐，每个边界数组正好占用一个缓存行
+    std::vector<AABoxRTreeNode, AABoxRTreeAllocator<AABoxRTreeNode>> nodes;
+    for (int i = 0; i < 100; ++i) {
+      nodes.emplace_back();
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(nodes.data()) % 64, 0u);
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(nodes[1].min_y) % 64, 0u);
+  }
+  TEST_END("node alignment");
+}
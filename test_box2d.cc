@@ -5,6 +5,9 @@
 #include "polygon2d.hpp"
 #include "math_utils.hpp"
 
+#include <random>
+#include <type_traits>
+
 using namespace mypilot::mymath;
 
 bool check_box_overlap_slow(const Box2d &box1, const Box2d &box2,
@@ -223,6 +226,95 @@ int main(int argc, char* argv[]) {
   }
   TEST_END("rotate_from_center_and_shift");
 
+  TEST_START("corners and bounds");
+  {
+    // 顶点与范围即时计算，盒子没有缓存，复制不需要分配内存
+    EXPECT_TRUE(std::is_trivially_copyable<Box2d>::value);
+
+    // 所有坐标都为负时，外包范围也需要正确
+    Box2d box({-10, -20}, 0, 4, 2);
+    EXPECT_NEAR(box.min_x(), -12.0, 1e-5);
+    EXPECT_NEAR(box.max_x(), -8.0, 1e-5);
+    EXPECT_NEAR(box.min_y(), -21.0, 1e-5);
+    EXPECT_NEAR(box.max_y(), -19.0, 1e-5);
+
+    // 移动与扩展之后读取的范围是最新的
+    box.shift({20, 30});
+    box.longitudinal_extend(2);
+    box.lateral_extend(2);
+    EXPECT_NEAR(box.min_x(), 7.0, 1e-5);
+    EXPECT_NEAR(box.max_x(), 13.0, 1e-5);
+    EXPECT_NEAR(box.min_y(), 8.0, 1e-5);
+    EXPECT_NEAR(box.max_y(), 12.0, 1e-5);
+
+    const Box2d copy = box;
+    box.rotate_from_center(M_PI_2);
+    EXPECT_NEAR(box.min_x(), 8.0, 1e-5);
+    EXPECT_NEAR(box.max_y(), 13.0, 1e-5);
+    EXPECT_NEAR(copy.min_x(), 7.0, 1e-5);
+    EXPECT_NEAR(copy.max_y(), 12.0, 1e-5);
+
+    // init_corners()保留为空操作
+    box.init_corners();
+    const std::array<Vec2d, 4> corners = box.corners();
+    const std::vector<Vec2d> all_corners = box.get_all_corners();
+    EXPECT_EQ(all_corners.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_NEAR(corners[i].x(), all_corners[i].x(), 1e-12);
+      EXPECT_NEAR(corners[i].y(), all_corners[i].y(), 1e-12);
+    }
+
+    // 由轴对齐盒子构造
+    const Box2d aabox(AABox2d({1, 2}, 4, 6));
+    EXPECT_NEAR(aabox.min_x(), -1.0, 1e-5);
+    EXPECT_NEAR(aabox.max_x(), 3.0, 1e-5);
+    EXPECT_NEAR(aabox.min_y(), -1.0, 1e-5);
+    EXPECT_NEAR(aabox.max_y(), 5.0, 1e-5);
+    EXPECT_TRUE(aabox.has_overlap(Box2d({2, 4}, 0.3, 1, 1)));
+  }
+  TEST_END("corners and bounds");
+
+  TEST_START("box distance");
+  {
+    const Box2d box({0, 0}, 0, 4, 2);
+    EXPECT_NEAR(box.distance_to(Box2d({5, 0}, 0, 2, 2)), 2.0, 1e-9);
+    EXPECT_NEAR(box.distance_to(Box2d({0, 4}, 0, 2, 2)), 2.0, 1e-9);
+    EXPECT_NEAR(box.distance_to(Box2d({5, 4}, 0, 2, 2)), std::hypot(2.0, 2.0), 1e-9);
+    // 旋转45度的盒子以顶点靠近
+    EXPECT_NEAR(box.distance_to(Box2d({4, 0}, M_PI_4, std::sqrt(2.0), std::sqrt(2.0))),
+                1.0, 1e-9);
+    EXPECT_NEAR(box.distance_to(Box2d({1, 0.5}, 0.4, 1, 1)), 0.0, 1e-12);
+    EXPECT_NEAR(box.distance_to(Box2d({3, 0}, 0, 2, 2)), 0.0, 1e-12);
+
+    EXPECT_TRUE(box.distance_less_than(Box2d({5, 0}, 0, 2, 2), 2.5));
+    EXPECT_FALSE(box.distance_less_than(Box2d({5, 0}, 0, 2, 2), 2.0));
+    EXPECT_FALSE(box.distance_less_than(Box2d({5, 0}, 0, 2, 2), 1.0));
+    EXPECT_TRUE(box.distance_less_than(Box2d({1, 0.5}, 0.4, 1, 1), 0.1));
+    EXPECT_FALSE(box.distance_less_than(Box2d({1, 0.5}, 0.4, 1, 1), 0.0));
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> size(0.0, 5.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<double> threshold(0.0, 6.0);
+    for (int iter = 0; iter < 10000; ++iter) {
+      const Box2d box1({pos(gen), pos(gen)}, angle(gen), size(gen) + 0.1,
+                       size(gen) + 0.1);
+      const Box2d box2({pos(gen), pos(gen)}, angle(gen), size(gen) + 0.1,
+                       size(gen) + 0.1);
+      const double expected =
+        box1.has_overlap(box2) ? 0.0 : Polygon2d(box1).distance_to(Polygon2d(box2));
+      const double distance = box1.distance_to(box2);
+      EXPECT_NEAR(distance, expected, 1e-6);
+      EXPECT_NEAR(box2.distance_to(box1), expected, 1e-6);
+      const double d = threshold(gen);
+      if (std::abs(d - expected) > 1e-6) {
+        EXPECT_EQ(box1.distance_less_than(box2, d), (expected < d));
+      }
+    }
+  }
+  TEST_END("box distance");
+
   TEST_START("test by random");
   {
     bool ambiguous = false;
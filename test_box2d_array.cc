@@ -0,0 +1,79 @@
+#include "box2d_array.hpp"
+#include "ltest.hpp"
+
+#include <random>
+
+#include "box2d.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("box2d array overlaps");
+  {
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<double> pos(-30.0, 30.0);
+    std::uniform_real_distribution<double> size(0.5, 8.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    // 覆盖SIMD主体与标量尾部的各种长度
+    for (int n : {0, 1, 3, 4, 7, 64, 65, 200}) {
+      std::vector<Box2d> boxes;
+      for (int i = 0; i < n; ++i) {
+        boxes.emplace_back(Vec2d(pos(gen), pos(gen)), angle(gen), size(gen), size(gen));
+      }
+      const Box2dArray array(boxes);
+      EXPECT_EQ(array.size(), n);
+
+      std::vector<int> indices;
+      std::vector<uint64_t> mask;
+      for (int iter = 0; iter < 50; ++iter) {
+        const Box2d ego({pos(gen), pos(gen)}, angle(gen), size(gen), size(gen));
+        std::vector<int> expected;
+        for (int i = 0; i < n; ++i) {
+          if (ego.has_overlap(boxes[i])) {
+            expected.push_back(i);
+          }
+        }
+        const int count = array.get_overlapping_indices(ego, &indices);
+        EXPECT_EQ(count, static_cast<int>(expected.size()));
+        EXPECT_TRUE((indices == expected));
+
+        const int mask_count = array.get_overlap_mask(ego, &mask);
+        EXPECT_EQ(mask_count, count);
+        EXPECT_EQ(static_cast<int>(mask.size()), (n + 63) / 64);
+        for (int i = 0; i < n; ++i) {
+          const bool bit = (mask[i / 64] >> (i % 64)) & 1;
+          EXPECT_EQ(bit, ego.has_overlap(boxes[i]));
+        }
+        EXPECT_EQ(array.has_overlap(ego), !expected.empty());
+      }
+    }
+  }
+  TEST_END("box2d array overlaps");
+
+  TEST_START("box2d array set and touching");
+  {
+    Box2dArray array;
+    array.push_back(Box2d({0, 0}, 0, 2, 2));
+    array.push_back(Box2d({10, 0}, M_PI_4, 2, 2));
+    EXPECT_NEAR(array[1].center_x(), 10.0, 1e-12);
+    EXPECT_NEAR(array[1].heading(), M_PI_4, 1e-12);
+
+    // 边界接触视为重叠
+    std::vector<int> indices;
+    EXPECT_EQ(array.get_overlapping_indices(Box2d({2, 0}, 0, 2, 2), &indices), 1);
+    EXPECT_EQ(indices[0], 0);
+
+    // 轴对齐外包盒重叠，但是分离轴上分离
+    const Box2d corner({11.2, 1.2}, 0, 0.6, 0.6);
+    EXPECT_FALSE(array.has_overlap(corner));
+
+    array.set(0, Box2d({11, 1}, 0, 1, 1));
+    EXPECT_EQ(array.get_overlapping_indices(Box2d({10.6, 0.6}, 0.3, 0.5, 0.5), &indices), 2);
+    array.clear();
+    EXPECT_TRUE(array.empty());
+    EXPECT_FALSE(array.has_overlap(corner));
+  }
+  TEST_END("box2d array set and touching");
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "dynamic_aabox_tree2d.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <cmath>
+#include <random>
+
+#include "box2d.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("dynamic aabox tree pairs");
+  {
+    std::mt19937 gen(15);
+    std::uniform_real_distribution<double> pos(-100.0, 100.0);
+    std::uniform_real_distribution<double> size(1.0, 6.0);
+    std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+    std::uniform_real_distribution<double> step(-1.0, 1.0);
+    const int kNumAgents = 300;
+    std::vector<Box2d> boxes;
+    for (int i = 0; i < kNumAgents; ++i) {
+      boxes.emplace_back(Vec2d(pos(gen), pos(gen)), heading(gen), size(gen),
+                         size(gen) / 2.0);
+    }
+    DynamicAABoxTree2d<int> tree(0.5);
+    std::vector<int> proxies;
+    for (int i = 0; i < kNumAgents; ++i) {
+      proxies.push_back(tree.create_proxy(boxes[i].get_aabox(), i));
+    }
+    EXPECT_EQ(tree.size(), kNumAgents);
+    EXPECT_TRUE(tree.is_valid());
+    // 平衡的树高度是对数级别的
+    EXPECT_TRUE((tree.height() < 4 * std::log2(kNumAgents)));
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int frame = 0; frame < 30; ++frame) {
+      int num_moved = 0;
+      for (int i = 0; i < kNumAgents; ++i) {
+        boxes[i].shift(Vec2d(step(gen), step(gen)));
+        num_moved += tree.move_proxy(proxies[i], boxes[i].get_aabox()) ? 1 : 0;
+        EXPECT_EQ(tree.get_user_data(proxies[i]), i);
+      }
+      // 扩展盒子使得小的移动不需要更新树
+      EXPECT_TRUE((num_moved < kNumAgents));
+      EXPECT_TRUE(tree.is_valid());
+
+      tree.get_overlapping_pairs(&pairs);
+      std::set<std::pair<int, int>> pair_set;
+      for (const auto &pair : pairs) {
+        pair_set.emplace(std::min(pair.first, pair.second),
+                         std::max(pair.first, pair.second));
+      }
+      EXPECT_EQ(pair_set.size(), pairs.size());
+      for (int i = 0; i < kNumAgents; ++i) {
+        const AABox2d box_i = boxes[i].get_aabox();
+        const AABox2d fat_i = tree.get_fat_aabox(proxies[i]);
+        for (int j = i + 1; j < kNumAgents; ++j) {
+          const bool reported = pair_set.count(std::make_pair(i, j)) > 0;
+          // 盒子重叠的对必须被报告，报告的对扩展盒子一定重叠
+          if (box_i.has_overlap(boxes[j].get_aabox())) {
+            EXPECT_TRUE(reported);
+          }
+          if (reported) {
+            EXPECT_TRUE(fat_i.has_overlap(tree.get_fat_aabox(proxies[j])));
+          }
+        }
+      }
+    }
+
+    // 区域查询
+    const AABox2d query_box({0, 0}, 40.0, 40.0);
+    std::set<int> found;
+    for (int id : tree.get_objects(query_box)) {
+      found.insert(id);
+    }
+    for (int i = 0; i < kNumAgents; ++i) {
+      if (boxes[i].get_aabox().has_overlap(query_box)) {
+        EXPECT_TRUE(found.count(i));
+      }
+    }
+
+    // 删除一半对象后复用节点
+    for (int i = 0; i < kNumAgents; i += 2) {
+      tree.destroy_proxy(proxies[i]);
+    }
+    EXPECT_EQ(tree.size(), kNumAgents / 2);
+    EXPECT_TRUE(tree.is_valid());
+    for (int i = 0; i < kNumAgents; i += 2) {
+      proxies[i] = tree.create_proxy(boxes[i].get_aabox(), i);
+    }
+    EXPECT_TRUE(tree.is_valid());
+    EXPECT_EQ(tree.size(), kNumAgents);
+    for (int i = 0; i < kNumAgents; ++i) {
+      tree.destroy_proxy(proxies[i]);
+    }
+    EXPECT_EQ(tree.height(), -1);
+    EXPECT_TRUE(tree.is_valid());
+    tree.get_overlapping_pairs(&pairs);
+    EXPECT_EQ(pairs.size(), 0);
+  }
+  TEST_END("dynamic aabox tree pairs");
+}
@@ -0,0 +1,108 @@
+#include "eigen_map.hpp"
+#include "ltest.hpp"
+
+#include <vector>
+
+#include "box2d.hpp"
+#include "polygon2d.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("vec2d buffers as matrix");
+  {
+    std::vector<Vec2d> points = {{1, 2}, {3, 4}, {5, 6}};
+    const ConstVec2dMatrixMap matrix = as_matrix(points);
+    EXPECT_EQ(matrix.cols(), 3);
+    EXPECT_NEAR(matrix(0, 1), 3.0, 1e-12);
+    EXPECT_NEAR(matrix(1, 2), 6.0, 1e-12);
+    // 映射不复制数据
+    EXPECT_TRUE((matrix.data() == reinterpret_cast<const double *>(points.data())));
+
+    // 通过映射原地变换
+    Eigen::Matrix2d rotation;
+    rotation << 0, -1, 1, 0;
+    Vec2dMatrixMap mutable_matrix = as_matrix(&points);
+    mutable_matrix = rotation * mutable_matrix;
+    mutable_matrix.colwise() += Eigen::Vector2d(10, 20);
+    EXPECT_NEAR(points[0].x(), 8.0, 1e-12);
+    EXPECT_NEAR(points[0].y(), 21.0, 1e-12);
+    EXPECT_NEAR(points[2].x(), 4.0, 1e-12);
+    EXPECT_NEAR(points[2].y(), 25.0, 1e-12);
+
+    const Polygon2d polygon(Box2d({0, 0}, 0.0, 4.0, 2.0));
+    const ConstVec2dMatrixMap vertices = as_matrix(polygon);
+    EXPECT_EQ(vertices.cols(), polygon.num_points());
+    EXPECT_NEAR(vertices.rowwise().mean()(0), 0.0, 1e-12);
+    EXPECT_NEAR(vertices.row(0).maxCoeff(), 2.0, 1e-12);
+    EXPECT_NEAR(vertices.row(1).minCoeff(), -1.0, 1e-12);
+
+    const std::vector<Vec2d> no_points;
+    EXPECT_EQ(as_matrix(no_points).cols(), 0);
+  }
+  TEST_END("vec2d buffers as matrix");
+
+  TEST_START("path and trajectory points as matrix");
+  {
+    std::vector<PathPoint> path(4);
+    std::vector<TrajectoryPoint> trajectory(4);
+    for (int i = 0; i < 4; ++i) {
+      path[i].set_x(i);
+      path[i].set_y(10 * i);
+      path[i].set_theta(0.5);
+      PathPoint point;
+      point.set_x(-i);
+      point.set_y(i * i);
+      point.set_theta(0.0);
+      point.set_kappa(0.0);
+      point.set_dkappa(0.0);
+      point.set_ddkappa(0.0);
+      point.set_s(0.0);
+      trajectory[i].set_path_point(point);
+      trajectory[i].set_v(3.0);
+      trajectory[i].set_a(0.0);
+      trajectory[i].set_relative_time(0.0);
+    }
+    const ConstStridedVec2dMatrixMap path_matrix = as_matrix(path);
+    EXPECT_EQ(path_matrix.cols(), 4);
+    EXPECT_NEAR(path_matrix(0, 3), 3.0, 1e-12);
+    EXPECT_NEAR(path_matrix(1, 2), 20.0, 1e-12);
+    as_matrix(&path).colwise() += Eigen::Vector2d(1, 1);
+    EXPECT_NEAR(path[3].x(), 4.0, 1e-12);
+    EXPECT_NEAR(path[3].y(), 31.0, 1e-12);
+    // 其它成员不受影响
+    EXPECT_NEAR(path[3].theta(), 0.5, 1e-12);
+
+    const ConstStridedVec2dMatrixMap trajectory_matrix = as_matrix(trajectory);
+    EXPECT_NEAR(trajectory_matrix(0, 2), -2.0, 1e-12);
+    EXPECT_NEAR(trajectory_matrix(1, 3), 9.0, 1e-12);
+    as_matrix(&trajectory).row(0) *= 2.0;
+    EXPECT_NEAR(trajectory[3].path_point().x(), -6.0, 1e-12);
+    EXPECT_NEAR(trajectory[3].v(), 3.0, 1e-12);
+  }
+  TEST_END("path and trajectory points as matrix");
+
+  TEST_START("matrix as vec2d");
+  {
+    Matrix2Xd matrix(2, 3);
+    matrix << 1, 2, 3,
+              4, 5, 6;
+    const Vec2dView<const Vec2d> view = as_vec2d(matrix);
+    EXPECT_EQ(view.size(), 3);
+    EXPECT_NEAR(view[1].x(), 2.0, 1e-12);
+    EXPECT_NEAR(view[1].y(), 5.0, 1e-12);
+    double sum = 0.0;
+    for (const Vec2d &point : view) {
+      sum += point.length_square();
+    }
+    EXPECT_NEAR(sum, matrix.squaredNorm(), 1e-12);
+    Vec2dView<Vec2d> mutable_view = as_vec2d(&matrix);
+    mutable_view[2] = Vec2d(7, 8);
+    EXPECT_NEAR(matrix(0, 2), 7.0, 1e-12);
+    EXPECT_NEAR(matrix(1, 2), 8.0, 1e-12);
+    // Vec2d的算法可以直接用在矩阵上
+    const Polygon2d polygon(std::vector<Vec2d>(view.begin(), view.end()));
+    EXPECT_EQ(polygon.num_points(), 3);
+  }
+  TEST_END("matrix as vec2d");
+}
@@ -0,0 +1,178 @@
+#include "vec2d.hpp"
+#include "line_segment2d.hpp"
+#include "aabox2d.hpp"
+#include "box2d.hpp"
+#include "polygon2d.hpp"
+#include "aaboxkdtree2d.hpp"
+#include "aaboxkdtree2d_flat.hpp"
+#include "ltest.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace mypilot::mymath;
+
+// 实例化所有成员函数，确保单精度版本可以完整编译
+template class mypilot::mymath::Vec2<float>;
+template class mypilot::mymath::LineSegment2<float>;
+template class mypilot::mymath::AABox2<float>;
+template class mypilot::mymath::Box2<float>;
+template class mypilot::mymath::Polygon2<float>;
+
+// 以单精度线段表示的对象
+class FloatObject {
+public:
+  FloatObject(const Vec2f& start, const Vec2f& end, const int id) :
+    _segment(start, end), _aabox(start, end), _id(id) {}
+  const AABox2f& aabox() const { return _aabox; }
+  double distance_to(const Vec2d& point) const {
+    return _segment.distance_to(Vec2f(point));
+  }
+  double distance_square_to(const Vec2d& point) const {
+    return _segment.distance_square_to(Vec2f(point));
+  }
+  int id() const { return _id; }
+
+private:
+  LineSegment2f _segment;
+  AABox2f _aabox;
+  int _id = 0;
+};
+
+int main(int argc, char* argv[]) {
+  TEST_START("vec2f");
+  {
+    EXPECT_EQ(sizeof(Vec2f), 2 * sizeof(float));
+    EXPECT_EQ(sizeof(Vec2d), 2 * sizeof(double));
+
+    const Vec2f a(3.0f, 4.0f);
+    EXPECT_NEAR(a.length(), 5.0f, 1e-6);
+    EXPECT_NEAR((2.0f * a).x(), 6.0f, 1e-6);
+    EXPECT_NEAR((a * 2.0f).y(), 8.0f, 1e-6);
+    EXPECT_NEAR(a.rotate(M_PI_2).x(), -4.0f, 1e-5);
+    EXPECT_NEAR(cross_prod(Vec2f(0, 0), Vec2f(1, 0), Vec2f(0, 1)), 1.0f, 1e-6);
+    EXPECT_NEAR(inner_prod(Vec2f(0, 0), Vec2f(1, 0), Vec2f(2, 1)), 2.0f, 1e-6);
+
+    // 单精度下的误差比双精度宽松
+    EXPECT_TRUE((Vec2f(1.0f, 1.0f) == Vec2f(1.0f + 1e-6f, 1.0f)));
+    EXPECT_FALSE((Vec2d(1.0, 1.0) == Vec2d(1.0 + 1e-6, 1.0)));
+
+    const Vec2d b(1.25, -2.5);
+    const Vec2f c(b);
+    EXPECT_NEAR(c.x(), 1.25f, 1e-6);
+    EXPECT_NEAR(Vec2d(c).y(), -2.5, 1e-6);
+  }
+  TEST_END("vec2f");
+
+  TEST_START("float geometry matches double");
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::uniform_real_distribution<double> size(0.5, 10.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    for (int i = 0; i < 500; ++i) {
+      const Box2d box_d({coord(gen), coord(gen)}, angle(gen), size(gen), size(gen));
+      const Box2f box_f(box_d);
+      const Vec2d point_d(coord(gen), coord(gen));
+      const Vec2f point_f(point_d);
+      EXPECT_NEAR(box_f.distance_to(point_f), box_d.distance_to(point_d), 1e-2);
+
+      const LineSegment2d segment_d({coord(gen), coord(gen)}, {coord(gen), coord(gen)});
+      const LineSegment2f segment_f(segment_d);
+      EXPECT_NEAR(segment_f.distance_to(point_f), segment_d.distance_to(point_d),
+                  1e-2);
+      EXPECT_NEAR(box_f.distance_to(segment_f), box_d.distance_to(segment_d), 1e-2);
+
+      const AABox2d aabox_d = box_d.get_aabox();
+      const AABox2f aabox_f(aabox_d);
+      EXPECT_NEAR(aabox_f.distance_to(point_f), aabox_d.distance_to(point_d), 1e-2);
+
+      const Polygon2d polygon_d(box_d);
+      const Polygon2f polygon_f(polygon_d);
+      EXPECT_NEAR(polygon_f.area(), polygon_d.area(), 1e-2);
+      EXPECT_NEAR(polygon_f.distance_to(point_f), polygon_d.distance_to(point_d),
+                  1e-2);
+      const bool inside_d = polygon_d.is_point_in(box_d.center());
+      const bool inside_f = polygon_f.is_point_in(box_f.center());
+      EXPECT_EQ(inside_f, inside_d);
+    }
+  }
+  TEST_END("float geometry matches double");
+
+  TEST_START("polygon2f");
+  {
+    const Polygon2f square({{0, 0}, {2, 0}, {2, 2}, {0, 2}});
+    EXPECT_TRUE(square.is_convex());
+    EXPECT_NEAR(square.area(), 4.0f, 1e-6);
+    EXPECT_TRUE(square.is_point_in({1, 1}));
+    EXPECT_FALSE(square.is_point_in({3, 1}));
+
+    const Polygon2f other({{1, 1}, {3, 1}, {3, 3}, {1, 3}});
+    EXPECT_TRUE(square.has_overlap(other));
+    Polygon2f overlap;
+    EXPECT_TRUE(square.compute_overlap(other, &overlap));
+    EXPECT_NEAR(overlap.area(), 1.0f, 1e-5);
+
+    const Box2f box = square.min_area_bounding_box();
+    EXPECT_NEAR(box.area(), 4.0f, 1e-4);
+  }
+  TEST_END("polygon2f");
+
+  TEST_START("kdtree of float objects");
+  {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> coord(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    std::vector<FloatObject> objects;
+    for (int i = 0; i < 2000; ++i) {
+      const Vec2f start(coord(gen), coord(gen));
+      objects.emplace_back(start, start + Vec2f(offset(gen), offset(gen)), i);
+    }
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 8;
+    AABoxKDTree2d<FloatObject> kdtree(objects, params);
+    FlatAABoxKDTree2d<FloatObject> flat_kdtree(objects, params);
+
+    for (int i = 0; i < 200; ++i) {
+      const Vec2d point(coord(gen), coord(gen));
+      double expected = std::numeric_limits<double>::infinity();
+      for (const auto& object : objects) {
+        expected = std::min(expected, object.distance_to(point));
+      }
+      const FloatObject* nearest = kdtree.get_nearest_object(point);
+      EXPECT_TRUE((nearest != nullptr));
+      EXPECT_NEAR(nearest->distance_to(point), expected, 1e-4);
+      const FloatObject* flat_nearest = flat_kdtree.get_nearest_object(point);
+      EXPECT_TRUE((flat_nearest != nullptr));
+      EXPECT_NEAR(flat_nearest->distance_to(point), expected, 1e-4);
+
+      const AABox2d query(point, 30.0, 30.0);
+      int expected_count = 0;
+      for (const auto& object : objects) {
+        expected_count += query.has_overlap(AABox2d(object.aabox())) ? 1 : 0;
+      }
+      const int count = static_cast<int>(kdtree.get_objects(query).size());
+      EXPECT_EQ(count, expected_count);
+
+      int expected_near_count = 0;
+      for (const auto& object : objects) {
+        expected_near_count += object.distance_to(point) <= 20.0 ? 1 : 0;
+      }
+      const int near_count =
+        static_cast<int>(flat_kdtree.get_objects(point, 20.0).size());
+      EXPECT_EQ(near_count, expected_near_count);
+    }
+
+    // 动态更新
+    const AABox2f old_aabox = objects[0].aabox();
+    objects[0] = FloatObject({500.0f, 500.0f}, {501.0f, 501.0f}, 0);
+    EXPECT_TRUE(kdtree.update(&objects[0], old_aabox));
+    const FloatObject* nearest = kdtree.get_nearest_object({500.0, 500.0});
+    EXPECT_EQ(nearest->id(), 0);
+  }
+  TEST_END("kdtree of float objects");
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+#include "gjk2d.hpp"
+#include "ltest.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace mypilot::mymath;
+
+// 在'center'附近生成一个随机的凸多边形
+Polygon2d random_convex_polygon(std::mt19937* gen, const Vec2d& center,
+                                const double radius, const int num_points) {
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::uniform_real_distribution<double> ratio(0.3, 1.0);
+  std::vector<Vec2d> points;
+  for (int i = 0; i < num_points; ++i) {
+    points.push_back(center + Vec2d::create_unit_vec2d(angle(*gen)) *
+                                (radius * ratio(*gen)));
+  }
+  Polygon2d polygon;
+  Polygon2d::compute_convex_hull(points, &polygon);
+  return polygon;
+}
+
+int main(int argc, char* argv[]) {
+  TEST_START("support points");
+  {
+    const Box2d box({1, 2}, M_PI_2, 4, 2);
+    const Vec2d p = support_point(box, Vec2d(1, 1));
+    EXPECT_NEAR(p.x(), 2.0, 1e-9);
+    EXPECT_NEAR(p.y(), 4.0, 1e-9);
+    const AABox2d aabox({0, 0}, 2, 4);
+    const Vec2d q = support_point(aabox, Vec2d(-1, 0.5));
+    EXPECT_NEAR(q.x(), -1.0, 1e-9);
+    EXPECT_NEAR(q.y(), 2.0, 1e-9);
+    const Polygon2d polygon(box);
+    const Vec2d r = support_point(polygon, Vec2d(-1, -1));
+    EXPECT_NEAR(r.x(), 0.0, 1e-9);
+    EXPECT_NEAR(r.y(), 0.0, 1e-9);
+  }
+  TEST_END("support points");
+
+  TEST_START("distance matches polygon");
+  {
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<double> pos(-15.0, 15.0);
+    std::uniform_real_distribution<double> radius(0.5, 6.0);
+    std::uniform_int_distribution<int> num_points(3, 40);
+    int num_overlaps = 0;
+    for (int iter = 0; iter < 2000; ++iter) {
+      const Polygon2d a = random_convex_polygon(&gen, {pos(gen), pos(gen)},
+                                                radius(gen), num_points(gen));
+      const Polygon2d b = random_convex_polygon(&gen, {pos(gen), pos(gen)},
+                                                radius(gen), num_points(gen));
+      const double expected = a.distance_to(b);
+      GJKResult2d result;
+      const double distance = GJK2d::distance(a, b, &result);
+      EXPECT_NEAR(distance, expected, 1e-6);
+      EXPECT_EQ(result.overlap, (distance == 0.0));
+      if (expected > 1e-6) {
+        EXPECT_FALSE(GJK2d::has_overlap(a, b));
+        // 最近点分别在两个多边形上
+        EXPECT_NEAR(a.distance_to(result.point_a), 0.0, 1e-6);
+        EXPECT_NEAR(b.distance_to(result.point_b), 0.0, 1e-6);
+        EXPECT_NEAR(result.point_a.distance_to(result.point_b), distance, 1e-6);
+      } else if (expected == 0.0) {
+        ++num_overlaps;
+        EXPECT_TRUE(GJK2d::has_overlap(a, b));
+      }
+    }
+    EXPECT_TRUE((num_overlaps > 100 && num_overlaps < 1900));
+  }
+  TEST_END("distance matches polygon");
+
+  TEST_START("mixed shapes");
+  {
+    std::mt19937 gen(29);
+    std::uniform_real_distribution<double> pos(-10.0, 10.0);
+    std::uniform_real_distribution<double> size(0.2, 6.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    for (int iter = 0; iter < 2000; ++iter) {
+      const Box2d box1({pos(gen), pos(gen)}, angle(gen), size(gen), size(gen));
+      const Box2d box2({pos(gen), pos(gen)}, angle(gen), size(gen), size(gen));
+      EXPECT_NEAR(GJK2d::distance(box1, box2), box1.distance_to(box2), 1e-6);
+      const AABox2d aabox({pos(gen), pos(gen)}, size(gen), size(gen));
+      const Polygon2d aabox_polygon{Box2d(aabox)};
+      EXPECT_NEAR(GJK2d::distance(aabox, box1),
+                  Polygon2d(box1).distance_to(aabox_polygon), 1e-6);
+      const Vec2d point(pos(gen), pos(gen));
+      EXPECT_NEAR(GJK2d::distance(box2, point), box2.distance_to(point), 1e-6);
+      const LineSegment2d segment({pos(gen), pos(gen)}, {pos(gen), pos(gen)});
+      EXPECT_NEAR(GJK2d::distance(segment, box1), box1.distance_to(segment), 1e-6);
+    }
+    // 单精度
+    const Box2f box1({0, 0}, 0.3f, 4, 2);
+    const Box2f box2({6, 1}, -0.2f, 3, 1);
+    EXPECT_NEAR(GJK2f::distance(box1, box2), box1.distance_to(box2), 1e-4);
+  }
+  TEST_END("mixed shapes");
+
+  TEST_START("penetration");
+  {
+    PenetrationResult2d result;
+    const AABox2d a({0, 0}, 2, 2);
+    const AABox2d b({1.5, 0.2}, 2, 2);
+    EXPECT_TRUE(GJK2d::penetration(a, b, &result));
+    EXPECT_NEAR(result.depth, 0.5, 1e-9);
+    EXPECT_NEAR(result.normal.x(), 1.0, 1e-9);
+    EXPECT_NEAR(result.normal.y(), 0.0, 1e-9);
+    EXPECT_NEAR(result.point_a.x(), 1.0, 1e-9);
+    EXPECT_NEAR(result.point_b.x(), 0.5, 1e-9);
+    EXPECT_FALSE(GJK2d::penetration(a, AABox2d({3, 0}, 1, 1), &result));
+
+    // 沿法线移动穿透深度后刚好接触
+    std::mt19937 gen(31);
+    std::uniform_real_distribution<double> pos(-3.0, 3.0);
+    std::uniform_real_distribution<double> radius(0.5, 4.0);
+    std::uniform_int_distribution<int> num_points(3, 30);
+    int num_penetrations = 0;
+    for (int iter = 0; iter < 1000; ++iter) {
+      const Polygon2d p = random_convex_polygon(&gen, {pos(gen), pos(gen)},
+                                                radius(gen), num_points(gen));
+      Box2d box({pos(gen), pos(gen)}, pos(gen), radius(gen), radius(gen));
+      if (!GJK2d::penetration(p, box, &result)) {
+        EXPECT_TRUE((GJK2d::distance(p, box) > 0.0));
+        continue;
+      }
+      ++num_penetrations;
+      EXPECT_NEAR(result.normal.length(), 1.0, 1e-9);
+      EXPECT_NEAR(result.depth, result.point_a.distance_to(result.point_b), 1e-6);
+      box.shift(result.normal * (result.depth + 1e-6));
+      EXPECT_NEAR(GJK2d::distance(p, box), 1e-6, 1e-7);
+      // 其他方向移动同样的距离不能分离
+      box.shift(result.normal * -(result.depth + 1e-6));
+      const Vec2d other = result.normal.rotate(0.3);
+      box.shift(other * (result.depth * 0.99));
+      EXPECT_TRUE((result.depth < 1e-6 || GJK2d::has_overlap(p, box)));
+    }
+    EXPECT_TRUE((num_penetrations > 300));
+  }
+  TEST_END("penetration");
+
+  TEST_START("warm start");
+  {
+    std::mt19937 gen(37);
+    const Polygon2d obstacle = random_convex_polygon(&gen, {0, 0}, 5.0, 40);
+    GJKSimplex2d simplex;
+    int warm_iterations = 0;
+    int cold_iterations = 0;
+    // 盒子绕障碍物缓慢移动，包括穿过障碍物的帧
+    for (int frame = 0; frame < 400; ++frame) {
+      const double t = frame * 0.02;
+      const Box2d box({8.0 * std::cos(t), 3.0 * std::sin(t * 1.3)}, t, 4.0, 2.0);
+      GJKResult2d warm;
+      GJKResult2d cold;
+      GJK2d::distance(obstacle, box, &warm, &simplex);
+      GJK2d::distance(obstacle, box, &cold);
+      EXPECT_NEAR(warm.distance, cold.distance, 1e-6);
+      EXPECT_EQ(warm.overlap, cold.overlap);
+      warm_iterations += warm.num_iterations;
+      cold_iterations += cold.num_iterations;
+    }
+    EXPECT_TRUE((warm_iterations < cold_iterations));
+
+    GJKSimplex2d overlap_simplex;
+    for (int frame = 0; frame < 400; ++frame) {
+      const double t = frame * 0.02;
+      const Box2d box({8.0 * std::cos(t), 3.0 * std::sin(t * 1.3)}, t, 4.0, 2.0);
+      EXPECT_EQ(GJK2d::has_overlap(obstacle, box, &overlap_simplex),
+                GJK2d::has_overlap(obstacle, box));
+    }
+  }
+  TEST_END("warm start");
+
+  return 0;
+}
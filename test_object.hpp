@@ -0,0 +1,52 @@
+#ifndef MYMATH_TEST_OBJECT_HPP
+#define MYMATH_TEST_OBJECT_HPP
+
+#include <set>
+
+#include "aabox2d.hpp"
+#include "line_segment2d.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 测试空间索引使用的对象，外包盒为线段的外包盒，距离为到线段的距离
+class Object {
+public:
+  Object(const double x1, const double y1, const double x2, const double y2,
+         const int id)
+      : aabox_({x1, y1}, {x2, y2}),
+        line_segment_({x1, y1}, {x2, y2}),
+        id_(id) {}
+  const AABox2d &aabox() const { return aabox_; }
+  double distance_to(const Vec2d &point) const {
+    return line_segment_.distance_to(point);
+  }
+  double distance_square_to(const Vec2d &point) const {
+    return line_segment_.distance_square_to(point);
+  }
+  int id() const { return id_; }
+  const LineSegment2d &line_segment() const { return line_segment_; }
+  void move(const double x1, const double y1, const double x2, const double y2) {
+    aabox_ = AABox2d({x1, y1}, {x2, y2});
+    line_segment_ = LineSegment2d({x1, y1}, {x2, y2});
+  }
+
+private:
+  AABox2d aabox_;
+  LineSegment2d line_segment_;
+  int id_ = 0;
+};
+
+// 查询结果中对象的编号集合
+template <typename Objects>
+std::set<int> to_ids(const Objects &objects) {
+  std::set<int> ids;
+  for (const Object *object : objects) {
+    ids.insert(object->id());
+  }
+  return ids;
+}
+
+}}
+
+#endif
@@ -0,0 +1,108 @@
+#include "point_kdtree.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <random>
+#include <algorithm>
+
+using namespace mypilot::mymath;
+
+// 暴力计算到'point'的距离平方，按照距离排序
+template <typename Tree>
+std::vector<std::pair<double, int>> brute_force(
+    const std::vector<typename Tree::Point>& points,
+    const typename Tree::Point& point) {
+  std::vector<std::pair<double, int>> distances;
+  for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+    distances.emplace_back(Tree::distance_square(points[i], point), i);
+  }
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+
+int main(int argc, char* argv[]) {
+  TEST_START("2d point kdtree");
+  {
+    std::mt19937 gen(12);
+    std::uniform_real_distribution<double> pos(-100.0, 100.0);
+    std::uniform_real_distribution<double> radius(0.0, 30.0);
+    for (int num_points : {1, 7, 100, 3000}) {
+      for (int leaf_size : {1, 4, 16}) {
+        std::vector<PointKDTree2d::Point> points;
+        for (int i = 0; i < num_points; ++i) {
+          points.push_back({{pos(gen), pos(gen)}});
+        }
+        PointKDTree2d kdtree(points, leaf_size);
+        EXPECT_EQ(kdtree.size(), num_points);
+        for (int q = 0; q < 50; ++q) {
+          const PointKDTree2d::Point query = {{pos(gen), pos(gen)}};
+          const auto expected = brute_force<PointKDTree2d>(points, query);
+          double distance_sqr = 0.0;
+          const int nearest = kdtree.get_nearest_point(query, &distance_sqr);
+          EXPECT_NEAR(distance_sqr, expected[0].first, 1e-9);
+          EXPECT_NEAR(PointKDTree2d::distance_square(points[nearest], query),
+                      expected[0].first, 1e-9);
+
+          const int k = 5;
+          const std::vector<int> knn = kdtree.get_k_nearest_points(query, k);
+          EXPECT_EQ(static_cast<int>(knn.size()), std::min(k, num_points));
+          for (int i = 0; i < static_cast<int>(knn.size()); ++i) {
+            EXPECT_NEAR(PointKDTree2d::distance_square(points[knn[i]], query),
+                        expected[i].first, 1e-9);
+          }
+
+          const double r = radius(gen);
+          const std::vector<int> within = kdtree.get_points_within(query, r);
+          const std::set<int> within_set(within.begin(), within.end());
+          EXPECT_EQ(within.size(), within_set.size());
+          int expected_count = 0;
+          for (const auto& item : expected) {
+            if (item.first <= r * r) {
+              ++expected_count;
+              EXPECT_TRUE(within_set.count(item.second));
+            }
+          }
+          EXPECT_EQ(static_cast<int>(within.size()), expected_count);
+        }
+      }
+    }
+  }
+  TEST_END("2d point kdtree");
+
+  TEST_START("3d float point kdtree");
+  {
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+    std::vector<PointKDTree3f::Point> points;
+    for (int i = 0; i < 2000; ++i) {
+      points.push_back({{pos(gen), pos(gen), pos(gen)}});
+    }
+    // 重复的点
+    for (int i = 0; i < 100; ++i) {
+      points.push_back({{1.0f, 2.0f, 3.0f}});
+    }
+    PointKDTree3f kdtree(points);
+    for (int q = 0; q < 100; ++q) {
+      const PointKDTree3f::Point query = {{pos(gen), pos(gen), pos(gen)}};
+      float best = std::numeric_limits<float>::infinity();
+      for (const auto& p : points) {
+        best = std::min(best, PointKDTree3f::distance_square(p, query));
+      }
+      float distance_sqr = 0.0f;
+      kdtree.get_nearest_point(query, &distance_sqr);
+      EXPECT_NEAR(distance_sqr, best, 1e-3);
+    }
+    EXPECT_EQ(kdtree.get_points_within({{1.0f, 2.0f, 3.0f}}, 0.0f).size(), 100);
+    EXPECT_EQ(kdtree.get_k_nearest_points({{1.0f, 2.0f, 3.0f}}, 10).size(), 10);
+  }
+  TEST_END("3d float point kdtree");
+
+  TEST_START("empty point kdtree");
+  {
+    PointKDTree2d kdtree(std::vector<PointKDTree2d::Point>{});
+    EXPECT_EQ(kdtree.get_nearest_point({{0.0, 0.0}}), -1);
+    EXPECT_EQ(kdtree.get_k_nearest_points({{0.0, 0.0}}, 3).size(), 0);
+    EXPECT_EQ(kdtree.get_points_within({{0.0, 0.0}}, 10.0).size(), 0);
+  }
+  TEST_END("empty point kdtree");
+}
@@ -1,6 +1,7 @@
 #include "polygon2d.hpp"
 #include "ltest.hpp"
 
+#include <random>
 #include <algorithm>
 
 #ifdef MYMATH_DBG
@@ -34,6 +35,26 @@ bool project_by_x_slow(const std::vector<Vec2d> &points, double x,
   return *min_y <= *max_y;
 }
 
+// 逐条边检查边界，再按照射线穿过的次数判断
+bool is_point_in_slow(const Polygon2d& polygon, const Vec2d& point) {
+  if (polygon.is_point_on_boundary(point)) {
+    return true;
+  }
+  const auto& points = polygon.points();
+  int j = polygon.num_points() - 1;
+  int c = 0;
+  for (int i = 0; i < polygon.num_points(); ++i) {
+    if ((points[i].y() > point.y()) != (points[j].y() > point.y())) {
+      const double side = cross_prod(point, points[i], points[j]);
+      if (points[i].y() < points[j].y() ? side > 0 : side < 0) {
+        ++c;
+      }
+    }
+    j = i;
+  }
+  return c & 1;
+}
+
 int main(int argc, char* argv[]) {
 
   TEST_START("is_point_in");
@@ -682,4 +703,106 @@ int main(int argc, char* argv[]) {
     }
   }
   TEST_END("expand");
+
+  TEST_START("convex queries");
+  {
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<double> pos(-20.0, 20.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<double> radius(1.0, 10.0);
+    std::vector<Polygon2d> polygons;
+    for (const int num_points : {3, 8, 50, 400}) {
+      for (int iter = 0; iter < 20; ++iter) {
+        const Vec2d center(pos(gen), pos(gen));
+        std::vector<Vec2d> points;
+        for (int i = 0; i < num_points; ++i) {
+          points.push_back(center + Vec2d::create_unit_vec2d(angle(gen)) * radius(gen));
+        }
+        Polygon2d polygon;
+        if (Polygon2d::compute_convex_hull(points, &polygon)) {
+          polygons.push_back(polygon);
+        }
+      }
+    }
+    // 顶点都在圆上，顶点数足够多时极点使用二分查找
+    for (int iter = 0; iter < 20; ++iter) {
+      const Vec2d center(pos(gen), pos(gen));
+      const double r = radius(gen);
+      std::vector<Vec2d> points;
+      for (int i = 0; i < 120; ++i) {
+        points.push_back(center + Vec2d::create_unit_vec2d(angle(gen)) * r);
+      }
+      Polygon2d polygon;
+      if (Polygon2d::compute_convex_hull(points, &polygon)) {
+        EXPECT_TRUE((polygon.num_points() >= kPolygonBinarySearchMinPoints));
+        polygons.push_back(polygon);
+      }
+    }
+    // 带有共线顶点的凸多边形
+    std::vector<Vec2d> square;
+    for (int i = 0; i < 5; ++i) square.emplace_back(i, 0);
+    for (int i = 0; i < 5; ++i) square.emplace_back(5, i);
+    for (int i = 0; i < 5; ++i) square.emplace_back(5 - i, 5);
+    for (int i = 0; i < 5; ++i) square.emplace_back(0, 5 - i);
+    polygons.emplace_back(square);
+    EXPECT_TRUE(polygons.back().is_convex());
+    // 带有重复顶点的凸多边形，长度为0的边没有方向
+    std::vector<Vec2d> circle;
+    for (int i = 0; i < 64; ++i) {
+      circle.push_back(Vec2d::create_unit_vec2d(2 * M_PI * i / 64) * 10.0);
+      if (i % 7 == 0) {
+        circle.push_back(circle.back());
+      }
+    }
+    polygons.emplace_back(circle);
+    EXPECT_TRUE(polygons.back().is_convex());
+
+    for (const auto& polygon : polygons) {
+      EXPECT_TRUE(polygon.is_convex());
+      const auto& points = polygon.points();
+      // 顶点与边的中点都在多边形内
+      for (int i = 0; i < polygon.num_points(); ++i) {
+        EXPECT_TRUE(polygon.is_point_in(points[i]));
+        EXPECT_TRUE(polygon.is_point_in(polygon.line_segments()[i].center()));
+      }
+      for (int iter = 0; iter < 200; ++iter) {
+        const Vec2d point(pos(gen), pos(gen));
+        const bool inside = polygon.is_point_in(point);
+        EXPECT_EQ(inside, is_point_in_slow(polygon, point));
+
+        const Vec2d direction = Vec2d::create_unit_vec2d(angle(gen));
+        double max_proj = -std::numeric_limits<double>::infinity();
+        for (const auto& p : points) {
+          max_proj = std::max(max_proj, p.inner_prod(direction));
+        }
+        EXPECT_NEAR(polygon.extreme_point(direction).inner_prod(direction), max_proj,
+                    1e-9);
+
+        Vec2d left;
+        Vec2d right;
+        const bool has_tangent = polygon.get_tangent_points(point, &left, &right);
+        EXPECT_EQ(has_tangent, !inside);
+        if (has_tangent) {
+          // 所有顶点都在射线point->left的右侧与射线point->right的左侧
+          bool is_tangent = true;
+          for (const auto& p : points) {
+            is_tangent = is_tangent && cross_prod(point, left, p) <= 1e-9 &&
+                         cross_prod(point, right, p) >= -1e-9;
+          }
+          EXPECT_TRUE(is_tangent);
+        }
+      }
+
+      const double heading = angle(gen);
+      const Box2d box = polygon.bounding_box_with_heading(heading);
+      EXPECT_TRUE(Polygon2d(box).contains(polygon));
+      Vec2d first;
+      Vec2d last;
+      polygon.extreme_points(heading, &first, &last);
+      EXPECT_NEAR(last.inner_prod(Vec2d::create_unit_vec2d(heading)) -
+                    first.inner_prod(Vec2d::create_unit_vec2d(heading)),
+                  box.length(), 1e-6);
+    }
+  }
+  TEST_END("convex queries");
 }
@@ -0,0 +1,127 @@
+#include "snapshot_holder.hpp"
+#include "ltest.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "aaboxkdtree2d_snapshot.hpp"
+#include "line_segment2d.hpp"
+#include "test_object.hpp"
+
+using namespace mypilot::mymath;
+
+// 析构时计数，用于检查旧版本的回收
+struct Counted {
+  explicit Counted(const int v, std::atomic<int>* alive) : value(v), alive(alive) {
+    ++*alive;
+  }
+  ~Counted() { --*alive; }
+  int value = 0;
+  std::atomic<int>* alive = nullptr;
+};
+
+int main(int argc, char* argv[]) {
+  TEST_START("publish and reclaim");
+  {
+    std::atomic<int> alive(0);
+    {
+      SnapshotHolder<Counted> holder(2);
+      SnapshotHolder<Counted>::Reader reader = holder.make_reader();
+      EXPECT_TRUE(reader.is_valid());
+      {
+        auto snapshot = reader.acquire();
+        EXPECT_FALSE(static_cast<bool>(snapshot));
+      }
+      holder.publish(std::unique_ptr<Counted>(new Counted(1, &alive)));
+      EXPECT_EQ(holder.version(), 1);
+
+      auto snapshot = reader.acquire();
+      EXPECT_EQ(snapshot->value, 1);
+      holder.publish(std::unique_ptr<Counted>(new Counted(2, &alive)));
+      // 旧版本仍被读者持有
+      EXPECT_EQ(alive.load(), 2);
+      EXPECT_EQ(snapshot->value, 1);
+      EXPECT_EQ(holder.reclaim(), 1);
+      snapshot.release();
+      EXPECT_EQ(holder.reclaim(), 0);
+      EXPECT_EQ(alive.load(), 1);
+
+      snapshot = reader.acquire();
+      EXPECT_EQ(snapshot->value, 2);
+      snapshot.release();
+
+      // 槽位数量有限，释放后可以重新注册
+      SnapshotHolder<Counted>::Reader reader2 = holder.make_reader();
+      SnapshotHolder<Counted>::Reader reader3 = holder.make_reader();
+      EXPECT_TRUE(reader2.is_valid());
+      EXPECT_FALSE(reader3.is_valid());
+      reader2 = SnapshotHolder<Counted>::Reader();
+      reader3 = holder.make_reader();
+      EXPECT_TRUE(reader3.is_valid());
+    }
+    EXPECT_EQ(alive.load(), 0);
+  }
+  TEST_END("publish and reclaim");
+
+  TEST_START("concurrent kdtree readers");
+  {
+    AABoxKDTreeParams params;
+    params.max_leaf_size = 4;
+    auto make_snapshot = [&params](const int version) {
+      // 版本v的所有对象都在x = v的竖线上
+      std::vector<Object> objects;
+      for (int i = 0; i < 200; ++i) {
+        objects.emplace_back(version, i, version, i + 0.5, version);
+      }
+      return std::unique_ptr<AABoxKDTree2dSnapshot<Object>>(
+          new AABoxKDTree2dSnapshot<Object>(std::move(objects), params));
+    };
+    AABoxKDTree2dHolder<Object> holder(make_snapshot(0), 8);
+    std::atomic<bool> stop(false);
+    std::atomic<int> num_errors(0);
+    std::atomic<int> num_queries(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([&] {
+        auto reader = holder.make_reader();
+        int last_version = 0;
+        while (!stop.load()) {
+          auto snapshot = reader.acquire();
+          const Object* object =
+              snapshot->kdtree.get_nearest_object({-1000.0, 100.0});
+          const int version = object->id();
+          // 同一快照中的所有对象属于同一个版本，版本不会倒退
+          for (const Object* other :
+               snapshot->kdtree.get_objects({version * 1.0, 50.0}, 10.0)) {
+            if (other->id() != version) {
+              ++num_errors;
+            }
+          }
+          if (version < last_version) {
+            ++num_errors;
+          }
+          last_version = version;
+          ++num_queries;
+        }
+      });
+    }
+    // 等待所有读者开始查询之后再发布新版本
+    while (num_queries.load() < static_cast<int>(readers.size())) {
+      std::this_thread::yield();
+    }
+    for (int v = 1; v <= 200; ++v) {
+      holder.publish(make_snapshot(v));
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    EXPECT_EQ(num_errors.load(), 0);
+    EXPECT_TRUE((num_queries.load() > 0));
+    EXPECT_EQ(holder.reclaim(), 0);
+    EXPECT_EQ(holder.version(), 200);
+  }
+  TEST_END("concurrent kdtree readers");
+}
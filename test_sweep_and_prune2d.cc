@@ -0,0 +1,131 @@
+#include "sweep_and_prune2d.hpp"
+#include "ltest.hpp"
+
+#include <set>
+#include <random>
+#include <algorithm>
+
+using namespace mypilot::mymath;
+
+// 暴力计算重叠的盒子对
+std::set<std::pair<int, int>> brute_force(const std::vector<AABox2d> &boxes,
+                                          const std::vector<bool> &valid) {
+  std::set<std::pair<int, int>> pairs;
+  for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+    for (int j = i + 1; j < static_cast<int>(boxes.size()); ++j) {
+      if (valid[i] && valid[j] && boxes[i].has_overlap(boxes[j])) {
+        pairs.emplace(i, j);
+      }
+    }
+  }
+  return pairs;
+}
+
+int main(int argc, char* argv[]) {
+  TEST_START("sweep and prune");
+  {
+    std::mt19937 gen(16);
+    std::uniform_real_distribution<double> pos(-100.0, 100.0);
+    std::uniform_real_distribution<double> size(0.5, 8.0);
+    std::uniform_real_distribution<double> step(-0.5, 0.5);
+    const int kNumBoxes = 300;
+    std::vector<AABox2d> boxes;
+    for (int i = 0; i < kNumBoxes; ++i) {
+      boxes.emplace_back(Vec2d(pos(gen), pos(gen)), size(gen), size(gen));
+    }
+    // 边界接触的盒子
+    boxes[1] = AABox2d({0, 0}, {1, 1});
+    boxes[2] = AABox2d({1, 0}, {2, 1});
+    std::vector<bool> valid(kNumBoxes, true);
+    SweepAndPrune2d sap(boxes);
+    EXPECT_EQ(sap.size(), kNumBoxes);
+
+    std::vector<std::pair<int, int>> pairs;
+    sap.get_overlapping_pairs(&pairs);
+    std::set<std::pair<int, int>> pair_set(pairs.begin(), pairs.end());
+    EXPECT_EQ(pair_set.size(), pairs.size());
+    EXPECT_TRUE((pair_set == brute_force(boxes, valid)));
+    EXPECT_TRUE(pair_set.count(std::make_pair(1, 2)));
+
+    for (int frame = 0; frame < 20; ++frame) {
+      for (auto &box : boxes) {
+        box.shift(Vec2d(step(gen), step(gen)));
+      }
+      sap.update_boxes(boxes);
+      sap.get_overlapping_pairs(&pairs);
+      pair_set = std::set<std::pair<int, int>>(pairs.begin(), pairs.end());
+      EXPECT_EQ(pair_set.size(), pairs.size());
+      EXPECT_TRUE((pair_set == brute_force(boxes, valid)));
+      // 帧间变化很小，交换次数远小于重新排序
+      EXPECT_TRUE((sap.num_last_swaps() < kNumBoxes * 2));
+    }
+
+    // 删除、复用编号与单独更新
+    for (int i = 0; i < kNumBoxes; i += 3) {
+      EXPECT_TRUE(sap.remove_box(i));
+      valid[i] = false;
+    }
+    EXPECT_FALSE(sap.remove_box(0));
+    EXPECT_FALSE(sap.update_box(0, boxes[0]));
+    for (int i = 1; i < kNumBoxes; i += 3) {
+      boxes[i].shift(Vec2d(3.0, -2.0));
+      EXPECT_TRUE(sap.update_box(i, boxes[i]));
+    }
+    sap.get_overlapping_pairs(&pairs);
+    pair_set = std::set<std::pair<int, int>>(pairs.begin(), pairs.end());
+    EXPECT_TRUE((pair_set == brute_force(boxes, valid)));
+
+    const int id = sap.add_box(AABox2d({0, 0}, 50.0, 50.0));
+    EXPECT_FALSE(valid[id]);
+    boxes[id] = AABox2d({0, 0}, 50.0, 50.0);
+    valid[id] = true;
+    sap.get_overlapping_pairs(&pairs);
+    pair_set = std::set<std::pair<int, int>>(pairs.begin(), pairs.end());
+    EXPECT_TRUE((pair_set == brute_force(boxes, valid)));
+    EXPECT_EQ(sap.size(), kNumBoxes - kNumBoxes / 3 + 1);
+
+    // 排序之前删除再加入，删除的编号在端点清除之前不会被复用
+    EXPECT_TRUE(sap.remove_box(id));
+    valid[id] = false;
+    const int new_id = sap.add_box(AABox2d({10, 10}, 30.0, 30.0));
+    EXPECT_TRUE((new_id != id));
+    boxes[new_id] = AABox2d({10, 10}, 30.0, 30.0);
+    valid[new_id] = true;
+    sap.get_overlapping_pairs(&pairs);
+    pair_set = std::set<std::pair<int, int>>(pairs.begin(), pairs.end());
+    EXPECT_TRUE((pair_set == brute_force(boxes, valid)));
+  }
+  TEST_END("sweep and prune");
+
+  TEST_START("bulk insertion");
+  {
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<double> pos(-1000.0, 1000.0);
+    std::uniform_real_distribution<double> size(0.5, 8.0);
+    std::vector<AABox2d> boxes;
+    for (int i = 0; i < 20000; ++i) {
+      boxes.emplace_back(Vec2d(pos(gen), pos(gen)), size(gen), size(gen));
+    }
+    // 第一帧的端点整体排序，不使用插入排序
+    SweepAndPrune2d sap(boxes);
+    std::vector<std::pair<int, int>> pairs;
+    sap.get_overlapping_pairs(&pairs);
+    EXPECT_EQ(sap.num_last_swaps(), 0);
+
+    // 与逐个加入盒子并且每次都排序的结果一致
+    SweepAndPrune2d incremental;
+    std::vector<std::pair<int, int>> incremental_pairs;
+    for (int i = 0; i < static_cast<int>(boxes.size()); ++i) {
+      incremental.add_box(boxes[i]);
+      if (i % 5000 == 0) {
+        incremental.get_overlapping_pairs(&incremental_pairs);
+      }
+    }
+    incremental.get_overlapping_pairs(&incremental_pairs);
+    std::sort(pairs.begin(), pairs.end());
+    std::sort(incremental_pairs.begin(), incremental_pairs.end());
+    EXPECT_TRUE((pairs == incremental_pairs));
+    EXPECT_TRUE((pairs.size() > 0));
+  }
+  TEST_END("bulk insertion");
+}
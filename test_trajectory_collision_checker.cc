@@ -0,0 +1,176 @@
+#include "trajectory_collision_checker.hpp"
+#include "ltest.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace mypilot::mymath;
+
+TrajectoryPoint make_point(const double x, const double y, const double theta,
+                           const double t) {
+  PathPoint path_point;
+  path_point.set_x(x);
+  path_point.set_y(y);
+  path_point.set_theta(theta);
+  path_point.set_kappa(0.0);
+  path_point.set_dkappa(0.0);
+  path_point.set_ddkappa(0.0);
+  path_point.set_s(0.0);
+  TrajectoryPoint point;
+  point.set_path_point(path_point);
+  point.set_v(0.0);
+  point.set_a(0.0);
+  point.set_relative_time(t);
+  return point;
+}
+
+TimedBox2d make_timed_box(const Box2d& box, const double t) {
+  TimedBox2d timed_box;
+  timed_box.relative_time = t;
+  timed_box.box = box;
+  return timed_box;
+}
+
+// 逐个轨迹点检测所有障碍物
+bool first_collision_slow(const TrajectoryCollisionChecker& checker,
+                          const std::vector<TrajectoryPoint>& trajectory,
+                          double* const collision_time) {
+  for (const auto& point : trajectory) {
+    const Box2d footprint = checker.footprint_at(point);
+    for (int id = 0; id < checker.num_obstacles(); ++id) {
+      if (footprint.has_overlap(checker.obstacle_box_at(id, point.relative_time()))) {
+        *collision_time = point.relative_time();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+int main(int argc, char* argv[]) {
+  TEST_START("match exhaustive check");
+  {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> pos(-20.0, 60.0);
+    std::uniform_real_distribution<double> velocity(-3.0, 3.0);
+    std::uniform_real_distribution<double> size(0.5, 4.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<double> yaw_rate(-0.3, 0.3);
+
+    VehicleFootprint footprint;
+    footprint.length = 4.8;
+    footprint.width = 1.9;
+    footprint.center_offset = 1.4;
+    int num_collisions = 0;
+    for (const int leaf_steps : {1, 4}) {
+      TrajectoryCollisionParams params;
+      params.max_leaf_steps = leaf_steps;
+      for (int iter = 0; iter < 200; ++iter) {
+        TrajectoryCollisionChecker checker(footprint, params);
+        for (int i = 0; i < 20; ++i) {
+          const Vec2d center(pos(gen), pos(gen));
+          const Vec2d v(velocity(gen), velocity(gen));
+          const double heading = angle(gen);
+          const double length = size(gen);
+          const double width = size(gen);
+          std::vector<TimedBox2d> boxes;
+          for (int k = 0; k <= 4; ++k) {
+            boxes.push_back(make_timed_box(
+              Box2d(center + v * (k * 2.0), heading, length, width), k * 2.0));
+          }
+          checker.add_obstacle(boxes);
+        }
+        checker.add_static_obstacle(Box2d({pos(gen), pos(gen)}, angle(gen), 2.0, 2.0));
+
+        // 以随机的横摆角速度行驶8秒
+        std::vector<TrajectoryPoint> trajectory;
+        double x = 0.0;
+        double y = 0.0;
+        double theta = angle(gen);
+        const double omega = yaw_rate(gen);
+        for (int k = 0; k <= 80; ++k) {
+          trajectory.push_back(make_point(x, y, theta, k * 0.1));
+          x += std::cos(theta) * 0.8;
+          y += std::sin(theta) * 0.8;
+          theta = normalize_angle(theta + omega * 0.1);
+        }
+
+        double expected_time = 0.0;
+        const bool expected = first_collision_slow(checker, trajectory, &expected_time);
+        double collision_time = 0.0;
+        int obstacle_id = -1;
+        const bool collided =
+          checker.get_first_collision(trajectory, &collision_time, &obstacle_id);
+        EXPECT_EQ(collided, expected);
+        EXPECT_EQ(checker.has_collision(trajectory), expected);
+        if (collided && expected) {
+          ++num_collisions;
+          EXPECT_NEAR(collision_time, expected_time, 1e-9);
+          EXPECT_TRUE((obstacle_id >= 0 && obstacle_id < checker.num_obstacles()));
+          const TrajectoryPoint& point =
+            trajectory[static_cast<int>(std::round(collision_time / 0.1))];
+          EXPECT_TRUE(checker.footprint_at(point).has_overlap(
+            checker.obstacle_box_at(obstacle_id, collision_time)));
+        }
+      }
+    }
+    // 随机场景中需要同时包含碰撞与不碰撞的情况
+    EXPECT_TRUE((num_collisions > 20 && num_collisions < 380));
+  }
+  TEST_END("match exhaustive check");
+
+  TEST_START("interpolation between samples");
+  {
+    VehicleFootprint footprint;
+    footprint.length = 4.0;
+    footprint.width = 2.0;
+    // 每步10米，轨迹点刚好落在薄墙的两侧
+    std::vector<TrajectoryPoint> trajectory;
+    for (int k = 0; k < 5; ++k) {
+      trajectory.push_back(make_point(k * 10.0, 0.0, 0.0, k * 0.5));
+    }
+    TrajectoryCollisionChecker coarse(footprint);
+    coarse.add_static_obstacle(Box2d({25.0, 0.0}, 0.0, 0.2, 6.0));
+    EXPECT_FALSE(coarse.has_collision(trajectory));
+
+    TrajectoryCollisionParams params;
+    params.max_interpolation_distance = 0.5;
+    TrajectoryCollisionChecker fine(footprint, params);
+    fine.add_static_obstacle(Box2d({25.0, 0.0}, 0.0, 0.2, 6.0));
+    double collision_time = 0.0;
+    EXPECT_TRUE(fine.get_first_collision(trajectory, &collision_time));
+    // 车头(x + 2)到达墙的左侧23.9时为最早的碰撞，插值间距0.5米
+    EXPECT_NEAR(collision_time, 23.0 / 10.0 * 0.5, 0.5 / 10.0 * 0.5 + 1e-9);
+
+    // 迎面而来的障碍物在两个采样时刻之间与车辆相遇
+    TrajectoryCollisionChecker moving(footprint, params);
+    moving.add_obstacle({make_timed_box(Box2d({40.0, 0.0}, 0.0, 1.0, 1.0), 0.0),
+                         make_timed_box(Box2d({0.0, 0.0}, 0.0, 1.0, 1.0), 2.0)});
+    int obstacle_id = -1;
+    EXPECT_TRUE(moving.get_first_collision(trajectory, &collision_time, &obstacle_id));
+    EXPECT_EQ(obstacle_id, 0);
+    EXPECT_TRUE((collision_time > 0.0 && collision_time < 2.0));
+  }
+  TEST_END("interpolation between samples");
+
+  TEST_START("empty inputs");
+  {
+    VehicleFootprint footprint;
+    footprint.length = 4.0;
+    footprint.width = 2.0;
+    TrajectoryCollisionChecker checker(footprint);
+    std::vector<TrajectoryPoint> trajectory;
+    EXPECT_FALSE(checker.has_collision(trajectory));
+    trajectory.push_back(make_point(0.0, 0.0, 0.0, 0.0));
+    EXPECT_FALSE(checker.has_collision(trajectory));
+    checker.add_static_obstacle(Box2d({1.0, 1.0}, 0.3, 1.0, 1.0));
+    double collision_time = -1.0;
+    EXPECT_TRUE(checker.get_first_collision(trajectory, &collision_time));
+    EXPECT_NEAR(collision_time, 0.0, 1e-12);
+    checker.clear_obstacles();
+    EXPECT_FALSE(checker.has_collision(trajectory));
+  }
+  TEST_END("empty inputs");
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "vec2d_array.hpp"
+#include "ltest.hpp"
+
+#include <random>
+
+#include "vec2d.hpp"
+#include "line_segment2d.hpp"
+
+using namespace mypilot::mymath;
+
+int main(int argc, char* argv[]) {
+  TEST_START("vec2d array kernels");
+  {
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<double> pos(-100.0, 100.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    // 覆盖SIMD主体与标量尾部的各种长度
+    for (int n : {0, 1, 2, 3, 5, 8, 17, 1001}) {
+      std::vector<Vec2d> points;
+      for (int i = 0; i < n; ++i) {
+        points.emplace_back(pos(gen), pos(gen));
+      }
+      Vec2dArray array(points);
+      EXPECT_EQ(array.size(), n);
+      const Vec2d reference(pos(gen), pos(gen));
+      const LineSegment2d segment({pos(gen), pos(gen)}, {pos(gen), pos(gen)});
+      const LineSegment2d degenerate({1.0, 2.0}, {1.0, 2.0});
+
+      std::vector<double> distances;
+      array.distance_to(reference, &distances);
+      EXPECT_EQ(static_cast<int>(distances.size()), n);
+      for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(distances[i], points[i].distance_to(reference), 1e-9);
+      }
+      array.distance_to(segment, &distances);
+      for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(distances[i], segment.distance_to(points[i]), 1e-9);
+      }
+      array.distance_square_to(degenerate, &distances);
+      for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(distances[i],
+                    points[i].distance_square_to(degenerate.start()), 1e-9);
+      }
+      std::vector<double> products;
+      array.inner_prod(reference, &products);
+      for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(products[i], points[i].inner_prod(reference), 1e-9);
+      }
+      array.cross_prod(reference, &products);
+      for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(products[i], points[i].cross_prod(reference), 1e-9);
+      }
+
+      const double theta = angle(gen);
+      Vec2dArray rotated = array;
+      rotated.rotate(theta);
+      Vec2dArray transformed = array;
+      transformed.transform(theta, reference);
+      Vec2dArray translated = array;
+      translated.translate(reference);
+      for (int i = 0; i < n; ++i) {
+        const Vec2d expected = points[i].rotate(theta);
+        EXPECT_NEAR(rotated[i].x(), expected.x(), 1e-9);
+        EXPECT_NEAR(rotated[i].y(), expected.y(), 1e-9);
+        EXPECT_NEAR(transformed[i].x(), expected.x() + reference.x(), 1e-9);
+        EXPECT_NEAR(transformed[i].y(), expected.y() + reference.y(), 1e-9);
+        EXPECT_NEAR(translated[i].x(), points[i].x() + reference.x(), 1e-9);
+        EXPECT_NEAR(translated[i].y(), points[i].y() + reference.y(), 1e-9);
+      }
+    }
+  }
+  TEST_END("vec2d array kernels");
+
+  TEST_START("vec2d array container");
+  {
+    Vec2dArray array;
+    EXPECT_TRUE(array.empty());
+    array.push_back({1.0, 2.0});
+    array.push_back({3.0, 4.0});
+    array.set(0, {5.0, 6.0});
+    EXPECT_EQ(array.size(), 2);
+    EXPECT_NEAR(array.x_data()[0], 5.0, 1e-12);
+    EXPECT_NEAR(array.y_data()[1], 4.0, 1e-12);
+    const std::vector<Vec2d> points = array.to_vec2d();
+    EXPECT_TRUE((points[1] == Vec2d(3.0, 4.0)));
+    array.resize(5);
+    EXPECT_NEAR(array[4].x(), 0.0, 1e-12);
+    array.clear();
+    EXPECT_EQ(array.size(), 0);
+  }
+  TEST_END("vec2d array container");
+}
@@ -0,0 +1,138 @@
+#ifndef MYMATH_THREAD_POOL_HPP
+#define MYMATH_THREAD_POOL_HPP
+
+#include <mutex>
+#include <queue>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 固定线程数的线程池
+ *
+ * 等待任务完成的线程(包括工作线程自身)会帮助执行队列中的任务，
+ * 所以在任务内部再次调用'parallel_for'不会死锁。
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(const int num_threads =
+                        static_cast<int>(std::thread::hardware_concurrency())) {
+    const int n = std::max(1, num_threads);
+    _workers.reserve(n);
+    for (int i = 0; i < n; ++i) {
+      _workers.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _task_cv.notify_all();
+    for (auto& worker : _workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int num_threads() const { return static_cast<int>(_workers.size()); }
+
+  /*
+   * 将区间[begin, end)按照'grain_size'切分成块，并行调用 function(chunk_begin, chunk_end)，
+   * 所有块完成后返回。
+   */
+  template <typename Function>
+  void parallel_for(const int begin, const int end, const int grain_size,
+                    const Function& function) {
+    if (begin >= end) {
+      return;
+    }
+    const int grain = std::max(1, grain_size);
+    const int num_chunks = (end - begin + grain - 1) / grain;
+    if (num_chunks == 1) {
+      function(begin, end);
+      return;
+    }
+    std::atomic<int> remaining(num_chunks);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (int chunk_begin = begin; chunk_begin < end; chunk_begin += grain) {
+        const int chunk_end = std::min(end, chunk_begin + grain);
+        _tasks.emplace([this, &function, &remaining, chunk_begin, chunk_end] {
+          function(chunk_begin, chunk_end);
+          if (remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done_cv.notify_all();
+          }
+        });
+      }
+    }
+    _task_cv.notify_all();
+    _done_cv.notify_all();
+    wait_until([&remaining] { return remaining.load() == 0; });
+  }
+
+private:
+  // 从队列中取出一个任务执行，队列为空时返回false。
+  bool run_pending_task() {
+    std::function<void()> task;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_tasks.empty()) {
+        return false;
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop();
+    }
+    task();
+    return true;
+  }
+
+  template <typename Predicate>
+  void wait_until(const Predicate& done) {
+    while (!done()) {
+      if (run_pending_task()) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done_cv.wait(lock, [&] { return done() || !_tasks.empty(); });
+    }
+  }
+
+  void worker_loop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _task_cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+        if (_stop && _tasks.empty()) {
+          return;
+        }
+        task = std::move(_tasks.front());
+        _tasks.pop();
+      }
+      task();
+    }
+  }
+
+private:
+  std::vector<std::thread> _workers;
+  std::queue<std::function<void()>> _tasks;
+  std::mutex _mutex;
+  std::condition_variable _task_cv;
+  std::condition_variable _done_cv;
+  bool _stop = false;
+};
+
+}}
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef MYMATH_TRAJECTORY_COLLISION_CHECKER_HPP
+#define MYMATH_TRAJECTORY_COLLISION_CHECKER_HPP
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+#include "vec2d.hpp"
+#include "box2d.hpp"
+#include "math_utils.hpp"
+#include "linear_interpolation.hpp"
+#include "my_trajectory_point.hpp"
+
+namespace mypilot {
+namespace mymath {
+
+// 车辆的矩形轮廓
+struct VehicleFootprint {
+  double length = 0.0;                  // 沿航向的长度
+  double width = 0.0;                   // 垂直于航向的宽度
+  double center_offset = 0.0;           // 轮廓中心沿航向相对轨迹点的偏移(参考点为后轴中心时为正)
+};
+
+// 障碍物在某个时刻的盒子
+struct TimedBox2d {
+  double relative_time = 0.0;
+  Box2d box;
+};
+
+// 轨迹碰撞检测的参数
+struct TrajectoryCollisionParams {
+  /*
+   * 两个轨迹点之间插值检测的最大间距，两点的距离超过该值时在中间插入轮廓检测，
+   * 避免高速时轮廓在两个采样点之间穿过障碍物。小于等于0时只检测轨迹点。
+   */
+  double max_interpolation_distance = 0.0;
+  int max_leaf_steps = 1;               // 区间的步数不超过该值时不再细分，直接精确检测
+};
+
+/*
+ * 沿轨迹的连续碰撞检测
+ *
+ * 障碍物由按照时间排列的盒子给出，时刻之间对中心、航向与尺寸线性插值，
+ * 时刻之外保持首尾的盒子(只有一个盒子即为静止障碍物)。
+ *
+ * 检测时对轨迹的区间[i, j]做二分：区间内车辆轮廓的扫掠范围用轨迹点的轴对齐外包盒
+ * 加上轮廓的外接圆半径保守地表示，障碍物在[t_i, t_j]内的范围同样用其中心的外包盒
+ * 加上外接圆半径表示。两者不重叠的区间整体跳过，只有细分到单步仍然可能碰撞时，
+ * 才构建车辆在轨迹点(以及插值点)上的Box2d，与障碍物当时的盒子做精确检测。
+ * 先检测前半区间，因此得到的是最早的碰撞。
+ */
+class TrajectoryCollisionChecker {
+public:
+  explicit TrajectoryCollisionChecker(
+      const VehicleFootprint& footprint,
+      const TrajectoryCollisionParams& params = TrajectoryCollisionParams()) :
+    _footprint(footprint), _params(params) {
+    assert(_footprint.length > -math_epsilon);
+    assert(_footprint.width > -math_epsilon);
+    _footprint_radius = std::hypot(_footprint.length / 2.0 +
+                                   std::abs(_footprint.center_offset),
+                                   _footprint.width / 2.0);
+  }
+
+  /*
+   * 加入一个障碍物，'boxes'按照时间升序排列，返回障碍物的编号。
+   */
+  int add_obstacle(const std::vector<TimedBox2d>& boxes) {
+    assert(!boxes.empty());
+    Obstacle obstacle;
+    obstacle.boxes = boxes;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      assert(i == 0 || boxes[i - 1].relative_time <= boxes[i].relative_time);
+      obstacle.radius = std::max(obstacle.radius, boxes[i].box.diagonal() / 2.0);
+    }
+    _obstacles.push_back(std::move(obstacle));
+    return static_cast<int>(_obstacles.size()) - 1;
+  }
+
+  // 加入一个静止的障碍物，返回障碍物的编号
+  int add_static_obstacle(const Box2d& box) {
+    TimedBox2d timed_box;
+    timed_box.box = box;
+    return add_obstacle(std::vector<TimedBox2d>(1, timed_box));
+  }
+
+  void clear_obstacles() { _obstacles.clear(); }
+  int num_obstacles() const { return static_cast<int>(_obstacles.size()); }
+
+  // 车辆在轨迹点上的轮廓
+  Box2d footprint_at(const TrajectoryPoint& point) const {
+    return footprint_at(point.path_point().x(), point.path_point().y(),
+                        point.path_point().theta());
+  }
+
+  // 障碍物在时刻'relative_time'的盒子
+  Box2d obstacle_box_at(const int obstacle_id, const double relative_time) const {
+    assert(obstacle_id >= 0 && obstacle_id < num_obstacles());
+    const std::vector<TimedBox2d>& boxes = _obstacles[obstacle_id].boxes;
+    if (relative_time <= boxes.front().relative_time) {
+      return boxes.front().box;
+    }
+    if (relative_time >= boxes.back().relative_time) {
+      return boxes.back().box;
+    }
+    const auto it = std::upper_bound(
+      boxes.begin(), boxes.end(), relative_time,
+      [](const double t, const TimedBox2d& box) { return t < box.relative_time; });
+    const TimedBox2d& b0 = *(it - 1);
+    const TimedBox2d& b1 = *it;
+    const double t0 = b0.relative_time;
+    const double t1 = b1.relative_time;
+    return Box2d(lerp(b0.box.center(), t0, b1.box.center(), t1, relative_time),
+                 slerp(b0.box.heading(), t0, b1.box.heading(), t1, relative_time),
+                 lerp(b0.box.length(), t0, b1.box.length(), t1, relative_time),
+                 lerp(b0.box.width(), t0, b1.box.width(), t1, relative_time));
+  }
+
+  /*
+   * 查找轨迹上最早的碰撞，没有碰撞时返回false。
+   *
+   * collision_time : 输出，碰撞时刻(轨迹点的relative_time，或者两点之间的插值时刻)
+   * obstacle_id : 输出，可以为nullptr，碰撞的障碍物编号
+   */
+  bool get_first_collision(const std::vector<TrajectoryPoint>& trajectory,
+                           double* const collision_time,
+                           int* const obstacle_id = nullptr) const {
+    assert(collision_time);
+    if (trajectory.empty() || _obstacles.empty()) {
+      return false;
+    }
+    std::vector<int> candidates;
+    candidates.reserve(_obstacles.size() * 2);
+    for (int i = 0; i < num_obstacles(); ++i) {
+      candidates.push_back(i);
+    }
+    const int last = static_cast<int>(trajectory.size()) - 1;
+    return check_range(trajectory, 0, last, 0, num_obstacles(), &candidates,
+                       collision_time, obstacle_id);
+  }
+
+  bool has_collision(const std::vector<TrajectoryPoint>& trajectory) const {
+    double collision_time = 0.0;
+    return get_first_collision(trajectory, &collision_time);
+  }
+
+private:
+  struct Obstacle {
+    std::vector<TimedBox2d> boxes;
+    double radius = 0.0;                // 所有盒子外接圆半径的最大值
+  };
+
+  struct Bound {
+    double min_x = std::numeric_limits<double>::infinity();
+    double max_x = -std::numeric_limits<double>::infinity();
+    double min_y = std::numeric_limits<double>::infinity();
+    double max_y = -std::numeric_limits<double>::infinity();
+
+    void merge(const Vec2d& point) {
+      min_x = std::min(min_x, point.x());
+      max_x = std::max(max_x, point.x());
+      min_y = std::min(min_y, point.y());
+      max_y = std::max(max_y, point.y());
+    }
+
+    // 两个范围的距离是否不超过'radius'(两者外接圆半径之和)
+    bool has_overlap(const Bound& other, const double radius) const {
+      return min_x - radius <= other.max_x && max_x + radius >= other.min_x &&
+             min_y - radius <= other.max_y && max_y + radius >= other.min_y;
+    }
+  };
+
+  Box2d footprint_at(const double x, const double y, const double theta) const {
+    const double cos_theta = std::cos(theta);
+    const double sin_theta = std::sin(theta);
+    return Box2d({x + _footprint.center_offset * cos_theta,
+                  y + _footprint.center_offset * sin_theta},
+                 theta, _footprint.length, _footprint.width);
+  }
+
+  static Vec2d position_of(const TrajectoryPoint& point) {
+    return Vec2d(point.path_point().x(), point.path_point().y());
+  }
+
+  // 车辆轨迹点在区间[first, last]内的位置范围
+  static Bound trajectory_bound(const std::vector<TrajectoryPoint>& trajectory,
+                                const int first, const int last) {
+    Bound bound;
+    for (int i = first; i <= last; ++i) {
+      bound.merge(position_of(trajectory[i]));
+    }
+    return bound;
+  }
+
+  // 障碍物在时刻'relative_time'的中心，与obstacle_box_at()一致但不需要三角函数
+  Vec2d obstacle_center_at(const int obstacle_id, const double relative_time) const {
+    const std::vector<TimedBox2d>& boxes = _obstacles[obstacle_id].boxes;
+    if (relative_time <= boxes.front().relative_time) {
+      return boxes.front().box.center();
+    }
+    if (relative_time >= boxes.back().relative_time) {
+      return boxes.back().box.center();
+    }
+    const auto it = std::upper_bound(
+      boxes.begin(), boxes.end(), relative_time,
+      [](const double t, const TimedBox2d& box) { return t < box.relative_time; });
+    return lerp((it - 1)->box.center(), (it - 1)->relative_time,
+                it->box.center(), it->relative_time, relative_time);
+  }
+
+  // 障碍物中心在时间区间[t0, t1]内的范围
+  Bound obstacle_bound(const int obstacle_id, const double t0, const double t1) const {
+    const std::vector<TimedBox2d>& boxes = _obstacles[obstacle_id].boxes;
+    Bound bound;
+    bound.merge(obstacle_center_at(obstacle_id, t0));
+    bound.merge(obstacle_center_at(obstacle_id, t1));
+    const auto begin = std::upper_bound(
+      boxes.begin(), boxes.end(), t0,
+      [](const double t, const TimedBox2d& box) { return t < box.relative_time; });
+    for (auto it = begin; it != boxes.end() && it->relative_time < t1; ++it) {
+      bound.merge(it->box.center());
+    }
+    return bound;
+  }
+
+  /*
+   * 检测轨迹区间[first, last]，'(*candidates)[begin, end)'是可能碰撞的障碍物。
+   * 子区间的候选障碍物追加在'candidates'的末尾，返回前恢复原来的长度。
+   */
+  bool check_range(const std::vector<TrajectoryPoint>& trajectory,
+                   const int first, const int last,
+                   const int begin, const int end,
+                   std::vector<int>* const candidates,
+                   double* const collision_time, int* const obstacle_id) const {
+    const double t0 = trajectory[first].relative_time();
+    const double t1 = trajectory[last].relative_time();
+    const Bound ego_bound = trajectory_bound(trajectory, first, last);
+    const int sub_begin = static_cast<int>(candidates->size());
+    for (int k = begin; k < end; ++k) {
+      const int id = (*candidates)[k];
+      if (ego_bound.has_overlap(obstacle_bound(id, t0, t1),
+                                _footprint_radius + _obstacles[id].radius)) {
+        candidates->push_back(id);
+      }
+    }
+    const int sub_end = static_cast<int>(candidates->size());
+
+    bool collided = false;
+    if (sub_begin == sub_end) {
+      collided = false;
+    } else if (last - first <= std::max(1, _params.max_leaf_steps)) {
+      collided = check_steps(trajectory, first, last, sub_begin, sub_end,
+                             *candidates, collision_time, obstacle_id);
+    } else {
+      const int middle = first + (last - first) / 2;
+      collided = check_range(trajectory, first, middle, sub_begin, sub_end,
+                             candidates, collision_time, obstacle_id) ||
+                 check_range(trajectory, middle, last, sub_begin, sub_end,
+                             candidates, collision_time, obstacle_id);
+    }
+    candidates->resize(sub_begin);
+    return collided;
+  }
+
+  /*
+   * 精确检测区间[first, last)内的轨迹点与其后的插值点，'last'是轨迹的最后一个点时
+   * 也检测'last'，其余情况下'last'由下一个区间检测。
+   */
+  bool check_steps(const std::vector<TrajectoryPoint>& trajectory,
+                   const int first, const int last,
+                   const int begin, const int end,
+                   const std::vector<int>& candidates,
+                   double* const collision_time, int* const obstacle_id) const {
+    const int stop = (last + 1 == static_cast<int>(trajectory.size())) ? last : last - 1;
+    for (int i = first; i <= stop; ++i) {
+      const TrajectoryPoint& p0 = trajectory[i];
+      int num_substeps = 1;
+      if (i < last && _params.max_interpolation_distance > 0.0) {
+        const double distance =
+          position_of(p0).distance_to(position_of(trajectory[i + 1]));
+        num_substeps = std::max(
+          1, static_cast<int>(std::ceil(distance / _params.max_interpolation_distance)));
+      }
+      for (int k = 0; k < num_substeps; ++k) {
+        double t = p0.relative_time();
+        Box2d footprint = footprint_at(p0);
+        if (k > 0) {
+          const TrajectoryPoint& p1 = trajectory[i + 1];
+          const double ratio = static_cast<double>(k) / num_substeps;
+          const PathPoint& q0 = p0.path_point();
+          const PathPoint& q1 = p1.path_point();
+          t = lerp(p0.relative_time(), 0.0, p1.relative_time(), 1.0, ratio);
+          footprint = footprint_at(lerp(q0.x(), 0.0, q1.x(), 1.0, ratio),
+                                   lerp(q0.y(), 0.0, q1.y(), 1.0, ratio),
+                                   slerp(q0.theta(), 0.0, q1.theta(), 1.0, ratio));
+        }
+        for (int c = begin; c < end; ++c) {
+          const int id = candidates[c];
+          if (footprint.has_overlap(obstacle_box_at(id, t))) {
+            *collision_time = t;
+            if (obstacle_id != nullptr) {
+              *obstacle_id = id;
+            }
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+private:
+  VehicleFootprint _footprint;
+  TrajectoryCollisionParams _params;
+  double _footprint_radius = 0.0;       // 轮廓相对轨迹点的外接圆半径
+  std::vector<Obstacle> _obstacles;
+};
+
+}}
+
+#endif
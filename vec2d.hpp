@@ -16,116 +16,140 @@ namespace mymath {
 
 static constexpr double math_epsilon = 1e-10;
 
-class Vec2d {
+// 各精度下的比较误差，float只有约7位有效数字，误差相应放大
+template <typename T>
+constexpr T math_epsilon_of() { return static_cast<T>(math_epsilon); }
+template <>
+constexpr float math_epsilon_of<float>() { return 1e-5f; }
+
+/*
+ * 二维向量，T为标量类型(double或者float)
+ * Vec2d为双精度版本，Vec2f为单精度版本，单精度用于精度要求在厘米级的大量数据，
+ * 内存与缓存占用减半。
+ */
+template <typename T>
+class Vec2 {
 public:
-  constexpr Vec2d(const double x, const double y) noexcept : _x(x), _y(y) {}
-  constexpr Vec2d() noexcept : Vec2d(0, 0) {}
+  using value_type = T;
+
+  constexpr Vec2(const T x, const T y) noexcept : _x(x), _y(y) {}
+  constexpr Vec2() noexcept : Vec2(0, 0) {}
+
+  // 不同精度之间的转换
+  template <typename U>
+  explicit Vec2(const Vec2<U>& other) noexcept :
+    _x(static_cast<T>(other.x())), _y(static_cast<T>(other.y())) {}
 
   // 依照给定角度创建单位点
-  static Vec2d create_unit_vec2d(const double angle) {
-    return Vec2d(cos(angle), sin(angle));
+  static Vec2 create_unit_vec2d(const T angle) {
+    return Vec2(std::cos(angle), std::sin(angle));
   }
 
-  double x() const { return _x; }
-  double y() const { return _y; }
-  void set_x(const double x) { _x = x; }
-  void set_y(const double y) { _y = y; }
+  T x() const { return _x; }
+  T y() const { return _y; }
+  void set_x(const T x) { _x = x; }
+  void set_y(const T y) { _y = y; }
 
-  double length() const {
+  T length() const {
     // 计算\sqrt(x^2 + y^2)
     return std::hypot(_x, _y);
   }
 
-  double length_square() const {
+  T length_square() const {
     return _x * _x + _y * _y;
   }
 
   // 获取向量与x正半轴之间的夹角(返回弧度)
-  double angle() const {
+  T angle() const {
     return std::atan2(_y, _x);
   }
 
   void normalize() {
-    const double l = length();
-    if (l > math_epsilon) {
+    const T l = length();
+    if (l > math_epsilon_of<T>()) {
       _x /= l;
       _y /= l;
     }
   }
 
   // 计算与点other的距离
-  double distance_to(const Vec2d& other) const {
+  T distance_to(const Vec2& other) const {
     return std::hypot(_x - other._x, _y - other._y);
   }
 
   // 计算与点other的距离的平方
-  double distance_square_to(const Vec2d& other) const {
-    const double dx = _x - other._x;
-    const double dy = _y - other._y;
+  T distance_square_to(const Vec2& other) const {
+    const T dx = _x - other._x;
+    const T dy = _y - other._y;
     return dx * dx + dy * dy;
   }
 
   // 计算两个向量的叉积
-  double cross_prod(const Vec2d& other) const {
+  T cross_prod(const Vec2& other) const {
     return _x * other.y() - _y * other.x();
   }
 
   // 求两点的内积
-  double inner_prod(const Vec2d& other) const {
+  T inner_prod(const Vec2& other) const {
     return _x * other.x() + _y * other.y();
   }
 
   // 返回旋转angle度后的点
-  Vec2d rotate(const double angle) const {
-    return Vec2d(_x * cos(angle) - _y * sin(angle),
-                 _x * sin(angle) + _y * cos(angle));
+  Vec2 rotate(const T angle) const {
+    return Vec2(_x * std::cos(angle) - _y * std::sin(angle),
+                _x * std::sin(angle) + _y * std::cos(angle));
   }
 
-  Vec2d operator+(const Vec2d& other) const {
-    return Vec2d(_x + other.x(), _y + other.y());
+  Vec2 operator+(const Vec2& other) const {
+    return Vec2(_x + other.x(), _y + other.y());
   }
 
-  Vec2d operator-(const Vec2d& other) const {
-    return Vec2d(_x - other.x(), _y - other.y());
+  Vec2 operator-(const Vec2& other) const {
+    return Vec2(_x - other.x(), _y - other.y());
   }
 
-  Vec2d operator*(const double ratio) const {
-    return Vec2d(_x * ratio, _y * ratio);
+  Vec2 operator*(const T ratio) const {
+    return Vec2(_x * ratio, _y * ratio);
   }
 
-  Vec2d operator/(const double ratio) const {
-    assert(std::abs(ratio) > math_epsilon);
-    return Vec2d(_x / ratio, _y / ratio);
+  Vec2 operator/(const T ratio) const {
+    assert(std::abs(ratio) > math_epsilon_of<T>());
+    return Vec2(_x / ratio, _y / ratio);
   }
 
-  Vec2d& operator+=(const Vec2d& other) {
+  Vec2& operator+=(const Vec2& other) {
     _x += other.x();
     _y += other.y();
     return *this;
   }
 
-  Vec2d& operator-=(const Vec2d& other) {
+  Vec2& operator-=(const Vec2& other) {
     _x -= other.x();
     _y -= other.y();
     return *this;
   }
 
-  Vec2d& operator*=(const double ratio) {
+  Vec2& operator*=(const T ratio) {
     _x *= ratio;
     _y *= ratio;
     return *this;
   }
 
-  Vec2d& operator/=(const double ratio) {
-    assert(std::abs(ratio) > math_epsilon);
+  Vec2& operator/=(const T ratio) {
+    assert(std::abs(ratio) > math_epsilon_of<T>());
     _x /= ratio;
     _y /= ratio;
     return *this;
   }
 
-  bool operator==(const Vec2d& other) const {
-    return (std::abs(_x - other.x()) < math_epsilon &&
-            std::abs(_y - other.y()) < math_epsilon);
+  bool operator==(const Vec2& other) const {
+    return (std::abs(_x - other.x()) < math_epsilon_of<T>() &&
+            std::abs(_y - other.y()) < math_epsilon_of<T>());
+  }
+
+  // 一个点乘以一个标量
+  friend Vec2 operator*(const T ratio, const Vec2& vec) {
+    return vec * ratio;
   }
 
 #ifdef MYMATH_DBG
@@ -137,14 +161,12 @@ public:
 #endif
 
  protected:
-  double _x = 0.0;
-  double _y = 0.0;
+  T _x = 0;
+  T _y = 0;
 };
 
-// 一个点乘以一个标量
-Vec2d operator*(const double ratio, const Vec2d& vec) {
-  return vec * ratio;
-}
+using Vec2d = Vec2<double>;
+using Vec2f = Vec2<float>;
 
 }}
 
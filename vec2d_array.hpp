@@ -0,0 +1,315 @@
+#ifndef MYMATH_VEC2D_ARRAY_HPP
+#define MYMATH_VEC2D_ARRAY_HPP
+
+#include "mymath_config.h"
+
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+#include "vec2d.hpp"
+#include "line_segment2d.hpp"
+
+#if !defined(MYMATH_DISABLE_SIMD) && defined(__AVX__)
+#include <immintrin.h>
+#define MYMATH_VEC2D_ARRAY_AVX 1
+#elif !defined(MYMATH_DISABLE_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define MYMATH_VEC2D_ARRAY_SSE2 1
+#endif
+
+namespace mypilot {
+namespace mymath {
+
+/*
+ * 批量运算的向量寄存器封装
+ *
+ * Vec2dArray的运算只写一次，分别用SIMD寄存器处理主体部分，用标量处理剩余的尾部。
+ * 所有的load/store都不要求内存对齐。
+ */
+struct Vec2dScalarPack {
+  using Reg = double;
+  static constexpr int kWidth = 1;
+  static Reg load(const double* p) { return *p; }
+  static void store(double* p, const Reg v) { *p = v; }
+  static Reg set1(const double v) { return v; }
+  static Reg add(const Reg a, const Reg b) { return a + b; }
+  static Reg sub(const Reg a, const Reg b) { return a - b; }
+  static Reg mul(const Reg a, const Reg b) { return a * b; }
+  static Reg min(const Reg a, const Reg b) { return std::min(a, b); }
+  static Reg max(const Reg a, const Reg b) { return std::max(a, b); }
+  static Reg sqrt(const Reg a) { return std::sqrt(a); }
+  static Reg abs(const Reg a) { return std::abs(a); }
+};
+
+#if defined(MYMATH_VEC2D_ARRAY_AVX)
+struct Vec2dSimdPack {
+  using Reg = __m256d;
+  static constexpr int kWidth = 4;
+  static Reg load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, const Reg v) { _mm256_storeu_pd(p, v); }
+  static Reg set1(const double v) { return _mm256_set1_pd(v); }
+  static Reg add(const Reg a, const Reg b) { return _mm256_add_pd(a, b); }
+  static Reg sub(const Reg a, const Reg b) { return _mm256_sub_pd(a, b); }
+  static Reg mul(const Reg a, const Reg b) { return _mm256_mul_pd(a, b); }
+  static Reg min(const Reg a, const Reg b) { return _mm256_min_pd(a, b); }
+  static Reg max(const Reg a, const Reg b) { return _mm256_max_pd(a, b); }
+  static Reg sqrt(const Reg a) { return _mm256_sqrt_pd(a); }
+  static Reg abs(const Reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+};
+#elif defined(MYMATH_VEC2D_ARRAY_SSE2)
+struct Vec2dSimdPack {
+  using Reg = __m128d;
+  static constexpr int kWidth = 2;
+  static Reg load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, const Reg v) { _mm_storeu_pd(p, v); }
+  static Reg set1(const double v) { return _mm_set1_pd(v); }
+  static Reg add(const Reg a, const Reg b) { return _mm_add_pd(a, b); }
+  static Reg sub(const Reg a, const Reg b) { return _mm_sub_pd(a, b); }
+  static Reg mul(const Reg a, const Reg b) { return _mm_mul_pd(a, b); }
+  static Reg min(const Reg a, const Reg b) { return _mm_min_pd(a, b); }
+  static Reg max(const Reg a, const Reg b) { return _mm_max_pd(a, b); }
+  static Reg sqrt(const Reg a) { return _mm_sqrt_pd(a); }
+  static Reg abs(const Reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+};
+#endif
+
+// 对[0, n)调用kernel(pack, i)，每次处理pack宽度个元素，剩余的尾部使用标量
+template <typename Kernel>
+void for_each_vec2d_pack(const int n, const Kernel& kernel) {
+  int i = 0;
+#if defined(MYMATH_VEC2D_ARRAY_AVX) || defined(MYMATH_VEC2D_ARRAY_SSE2)
+  for (; i + Vec2dSimdPack::kWidth <= n; i += Vec2dSimdPack::kWidth) {
+    kernel(Vec2dSimdPack(), i);
+  }
+#endif
+  for (; i < n; ++i) {
+    kernel(Vec2dScalarPack(), i);
+  }
+}
+
+// 与for_each_vec2d_pack相同，kernel返回false时立即停止，被停止时返回false
+template <typename Kernel>
+bool for_each_vec2d_pack_until(const int n, const Kernel& kernel) {
+  int i = 0;
+#if defined(MYMATH_VEC2D_ARRAY_AVX) || defined(MYMATH_VEC2D_ARRAY_SSE2)
+  for (; i + Vec2dSimdPack::kWidth <= n; i += Vec2dSimdPack::kWidth) {
+    if (!kernel(Vec2dSimdPack(), i)) {
+      return false;
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if (!kernel(Vec2dScalarPack(), i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * 按照SoA(x数组与y数组分开)存放的二维点集合
+ *
+ * 对所有点做相同的运算(平移、旋转、到点或者线段的距离、内积与叉积)时，
+ * 连续的x与y可以直接装入SIMD寄存器，旋转的三角函数也只计算一次。
+ * 编译时启用AVX时每次处理4个点，SSE2时2个点，
+ * 定义MYMATH_DISABLE_SIMD或者没有SIMD时使用标量实现，结果相同。
+ */
+class Vec2dArray {
+public:
+  Vec2dArray() = default;
+
+  explicit Vec2dArray(const int size) : _x(size, 0.0), _y(size, 0.0) {}
+
+  explicit Vec2dArray(const std::vector<Vec2d>& points) {
+    _x.reserve(points.size());
+    _y.reserve(points.size());
+    for (const auto& point : points) {
+      push_back(point);
+    }
+  }
+
+  int size() const { return static_cast<int>(_x.size()); }
+  bool empty() const { return _x.empty(); }
+
+  void reserve(const int size) {
+    _x.reserve(size);
+    _y.reserve(size);
+  }
+
+  void resize(const int size) {
+    _x.resize(size, 0.0);
+    _y.resize(size, 0.0);
+  }
+
+  void clear() {
+    _x.clear();
+    _y.clear();
+  }
+
+  void push_back(const Vec2d& point) {
+    _x.push_back(point.x());
+    _y.push_back(point.y());
+  }
+
+  Vec2d operator[](const int i) const {
+    assert(i >= 0 && i < size());
+    return Vec2d(_x[i], _y[i]);
+  }
+
+  void set(const int i, const Vec2d& point) {
+    assert(i >= 0 && i < size());
+    _x[i] = point.x();
+    _y[i] = point.y();
+  }
+
+  const double* x_data() const { return _x.data(); }
+  const double* y_data() const { return _y.data(); }
+  double* x_data() { return _x.data(); }
+  double* y_data() { return _y.data(); }
+
+  std::vector<Vec2d> to_vec2d() const {
+    std::vector<Vec2d> points;
+    points.reserve(_x.size());
+    for (int i = 0; i < size(); ++i) {
+      points.emplace_back(_x[i], _y[i]);
+    }
+    return points;
+  }
+
+  // 所有点平移'offset'
+  void translate(const Vec2d& offset) {
+    double* const x = _x.data();
+    double* const y = _y.data();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      P::store(x + i, P::add(P::load(x + i), P::set1(offset.x())));
+      P::store(y + i, P::add(P::load(y + i), P::set1(offset.y())));
+    });
+  }
+
+  // 所有点绕原点旋转'angle'
+  void rotate(const double angle) {
+    transform(angle, Vec2d(0.0, 0.0));
+  }
+
+  // 所有点先绕原点旋转'angle'，再平移'offset'(坐标系之间的刚体变换)
+  void transform(const double angle, const Vec2d& offset) {
+    const double cos_angle = std::cos(angle);
+    const double sin_angle = std::sin(angle);
+    double* const x = _x.data();
+    double* const y = _y.data();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      const auto c = P::set1(cos_angle);
+      const auto s = P::set1(sin_angle);
+      const auto px = P::load(x + i);
+      const auto py = P::load(y + i);
+      P::store(x + i, P::add(P::sub(P::mul(px, c), P::mul(py, s)),
+                             P::set1(offset.x())));
+      P::store(y + i, P::add(P::add(P::mul(px, s), P::mul(py, c)),
+                             P::set1(offset.y())));
+    });
+  }
+
+  // 每个点到'point'的距离的平方
+  void distance_square_to(const Vec2d& point,
+                          std::vector<double>* const distances) const {
+    assert(distances);
+    distances->resize(_x.size());
+    const double* const x = _x.data();
+    const double* const y = _y.data();
+    double* const out = distances->data();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      const auto dx = P::sub(P::load(x + i), P::set1(point.x()));
+      const auto dy = P::sub(P::load(y + i), P::set1(point.y()));
+      P::store(out + i, P::add(P::mul(dx, dx), P::mul(dy, dy)));
+    });
+  }
+
+  // 每个点到'point'的距离
+  void distance_to(const Vec2d& point, std::vector<double>* const distances) const {
+    distance_square_to(point, distances);
+    sqrt_all(distances);
+  }
+
+  // 每个点到线段'segment'的距离的平方
+  void distance_square_to(const LineSegment2d& segment,
+                          std::vector<double>* const distances) const {
+    assert(distances);
+    distances->resize(_x.size());
+    const double* const x = _x.data();
+    const double* const y = _y.data();
+    double* const out = distances->data();
+    const Vec2d& start = segment.start();
+    const Vec2d& unit = segment.unit_direction();
+    const double length = segment.length() <= math_epsilon ? 0.0 : segment.length();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      const auto x0 = P::sub(P::load(x + i), P::set1(start.x()));
+      const auto y0 = P::sub(P::load(y + i), P::set1(start.y()));
+      const auto ux = P::set1(unit.x());
+      const auto uy = P::set1(unit.y());
+      // 投影长度限制在[0, length]内即为线段上的最近点
+      const auto proj = P::add(P::mul(x0, ux), P::mul(y0, uy));
+      const auto t = P::min(P::max(proj, P::set1(0.0)), P::set1(length));
+      const auto dx = P::sub(x0, P::mul(ux, t));
+      const auto dy = P::sub(y0, P::mul(uy, t));
+      P::store(out + i, P::add(P::mul(dx, dx), P::mul(dy, dy)));
+    });
+  }
+
+  // 每个点到线段'segment'的距离
+  void distance_to(const LineSegment2d& segment,
+                   std::vector<double>* const distances) const {
+    distance_square_to(segment, distances);
+    sqrt_all(distances);
+  }
+
+  // 每个点与'reference'的内积
+  void inner_prod(const Vec2d& reference, std::vector<double>* const results) const {
+    assert(results);
+    results->resize(_x.size());
+    const double* const x = _x.data();
+    const double* const y = _y.data();
+    double* const out = results->data();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      P::store(out + i, P::add(P::mul(P::load(x + i), P::set1(reference.x())),
+                               P::mul(P::load(y + i), P::set1(reference.y()))));
+    });
+  }
+
+  // 每个点与'reference'的叉积 (point x reference)
+  void cross_prod(const Vec2d& reference, std::vector<double>* const results) const {
+    assert(results);
+    results->resize(_x.size());
+    const double* const x = _x.data();
+    const double* const y = _y.data();
+    double* const out = results->data();
+    for_each_vec2d_pack(size(), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      P::store(out + i, P::sub(P::mul(P::load(x + i), P::set1(reference.y())),
+                               P::mul(P::load(y + i), P::set1(reference.x()))));
+    });
+  }
+
+private:
+  static void sqrt_all(std::vector<double>* const values) {
+    double* const v = values->data();
+    for_each_vec2d_pack(static_cast<int>(values->size()), [&](auto pack, const int i) {
+      using P = decltype(pack);
+      P::store(v + i, P::sqrt(P::load(v + i)));
+    });
+  }
+
+private:
+  std::vector<double> _x;
+  std::vector<double> _y;
+};
+
+}}
+
+#endif